@@ -0,0 +1,559 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// On x86 with GCC or Clang the AVX2 kernels are compiled for AVX2 regardless of the compiler flags and picked at runtime
+// from the CPU's features; otherwise AVX2 is used only when the compiler targets it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define BITSET_AVX2
+    #if defined(__AVX2__)
+        #define __BITSET_AVX2_TARGET__
+    #else
+        #define BITSET_RUNTIME_DISPATCH
+        #define __BITSET_AVX2_TARGET__ __attribute__((target("avx2")))
+    #endif
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define BITSET_AVX2
+    #define __BITSET_AVX2_TARGET__
+#endif
+
+// BMI2 PDEP (select) stays a compile-time choice: it is microcoded, and slower than the fallback loop, on pre-Zen 3 AMD cores
+#if defined(__BMI2__) && !defined(BITSET_AVX2)
+    #include <immintrin.h>
+#endif
+
+#define BITSET_RANK_BLOCK_WORDS 8 // words (512 bits) per rank index entry
+
+/*
+    Growable bit-vector packed into 64-bit words (bit i lives in words[i / 64], bit i % 64).
+    Bits past bit_count in the last word are always zero, so counts and scans need no tail masking.
+    Bulk operations and popcounts run four words at a time with AVX2 when the CPU has it (POPCNT otherwise, when the compiler targets it).
+    rank / select scan the words unless build_rank_index_bitset() was called since the last modification, in which case they use
+    its per-512-bit running counts.
+*/
+
+typedef struct bitset
+{
+    size_t bit_count;
+    size_t word_capacity;
+    uint64_t* words;
+
+    uint64_t* rank_index; // set bits before each 512-bit block (see build_rank_index_bitset)
+    size_t rank_index_size;
+    uint8_t rank_index_valid; // cleared by every modification
+} bitset;
+
+// Internal use only
+static inline uint32_t __popcount_64_bitset__(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    return (uint32_t)((((x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Internal use only; x must be non-zero
+static inline uint32_t __ctz_64_bitset__(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0)
+    {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Internal use only; position of the k-th (from 0) set bit of word, which must have more than k set bits
+static inline uint32_t __select_64_bitset__(uint64_t word, uint32_t k)
+{
+#if defined(__BMI2__)
+    return __ctz_64_bitset__(_pdep_u64((uint64_t)1 << k, word));
+#else
+    for (; k > 0; k--) word &= word - 1;
+    return __ctz_64_bitset__(word);
+#endif
+}
+
+// Internal use only
+static inline size_t __word_count_bitset__(const size_t bit_count)
+{
+    return (bit_count + 63) / 64;
+}
+
+// Internal use only
+static inline uint8_t __has_avx2_bitset__(void)
+{
+#if defined(BITSET_RUNTIME_DISPATCH)
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+#elif defined(BITSET_AVX2)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+#if defined(BITSET_AVX2)
+// Internal use only; per 64-bit lane popcounts (nibble lookup, summed with SAD)
+__BITSET_AVX2_TARGET__ static inline __m256i __popcount_256_bitset__(const __m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+    const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+// Internal use only
+__BITSET_AVX2_TARGET__ static inline uint64_t __sum_256_bitset__(const __m256i v)
+{
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Internal use only; adds the set bits of whole 4-word blocks of words [0, count) to total, returns the words covered
+__BITSET_AVX2_TARGET__ static inline size_t __popcount_words_avx2_bitset__(const uint64_t* const words, const size_t count, uint64_t* const total)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (const size_t vector_end = count & ~(size_t)3; i < vector_end; i += 4)
+    {
+        acc = _mm256_add_epi64(acc, __popcount_256_bitset__(_mm256_loadu_si256((const __m256i*)(words + i))));
+    }
+    *total += __sum_256_bitset__(acc);
+    return i;
+}
+
+// Internal use only; as __popcount_words_avx2_bitset__, over a[i] & b[i]
+__BITSET_AVX2_TARGET__ static inline size_t __intersection_count_avx2_bitset__(const uint64_t* const a, const uint64_t* const b, const size_t count, uint64_t* const total)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (const size_t vector_end = count & ~(size_t)3; i < vector_end; i += 4)
+    {
+        const __m256i both = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        acc = _mm256_add_epi64(acc, __popcount_256_bitset__(both));
+    }
+    *total += __sum_256_bitset__(acc);
+    return i;
+}
+
+// Internal use only; skips whole 4-word blocks of zero words from w, returns where the scalar scan resumes
+__BITSET_AVX2_TARGET__ static inline size_t __skip_zero_words_avx2_bitset__(const uint64_t* const words, size_t w, const size_t word_count)
+{
+    for (; w + 4 <= word_count; w += 4)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(words + w));
+        if (!_mm256_testz_si256(v, v)) break;
+    }
+    return w;
+}
+#endif
+
+// Internal use only; set bits in words [0, count)
+static inline uint64_t __popcount_words_bitset__(const uint64_t* const words, const size_t count)
+{
+    uint64_t total = 0;
+    size_t i = 0;
+#if defined(BITSET_AVX2)
+    if (__has_avx2_bitset__()) i = __popcount_words_avx2_bitset__(words, count, &total);
+#endif
+    for (; i < count; i++) total += __popcount_64_bitset__(words[i]);
+    return total;
+}
+
+// Internal use only; grows the word buffer (new words zeroed). Returns 0 on success, else 1
+static inline int __reserve_words_bitset__(bitset* const set, const size_t word_count)
+{
+    if (word_count <= set->word_capacity) return 0;
+
+    size_t capacity = set->word_capacity * 2;
+    if (capacity < word_count) capacity = word_count;
+    uint64_t* const words = (uint64_t*)realloc(set->words, capacity * sizeof(uint64_t));
+    if (words == NULL) return 1;
+    memset(words + set->word_capacity, 0, (capacity - set->word_capacity) * sizeof(uint64_t));
+    set->words = words;
+    set->word_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Initializes a bitset of @p bit_count bits, all clear.
+ * @return 0 on success, 1 on allocation error (the bitset is then empty).
+ */
+static inline int set_bitset(bitset* const set, const size_t bit_count)
+{
+    set->bit_count = 0;
+    set->word_capacity = 0;
+    set->words = NULL;
+    set->rank_index = NULL;
+    set->rank_index_size = 0;
+    set->rank_index_valid = 0;
+    if (__reserve_words_bitset__(set, __word_count_bitset__(bit_count)) != 0) return 1;
+    set->bit_count = bit_count;
+    return 0;
+}
+
+static inline bitset* new_bitset(const size_t bit_count)
+{
+    bitset* const set = (bitset*)calloc(1, sizeof(bitset));
+    if (set == NULL) return NULL;
+    if (set_bitset(set, bit_count) != 0)
+    {
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+static inline void clean_bitset(bitset* const set)
+{
+    free(set->words);
+    free(set->rank_index);
+    set->words = NULL;
+    set->rank_index = NULL;
+    set->bit_count = 0;
+    set->word_capacity = 0;
+    set->rank_index_size = 0;
+    set->rank_index_valid = 0;
+}
+
+static inline void free_bitset(bitset* const set)
+{
+    clean_bitset(set);
+    free(set);
+}
+
+/**
+ * @brief Grows or shrinks the bitset to @p bit_count bits; added bits are clear.
+ * @return 0 on success, 1 on allocation error (the bitset is unchanged).
+ */
+static inline int resize_bitset(bitset* const set, const size_t bit_count)
+{
+    const size_t word_count = __word_count_bitset__(bit_count);
+    if (__reserve_words_bitset__(set, word_count) != 0) return 1;
+
+    if (bit_count < set->bit_count)
+    {
+        memset(set->words + word_count, 0, (__word_count_bitset__(set->bit_count) - word_count) * sizeof(uint64_t));
+        if ((bit_count & 63) != 0) set->words[word_count - 1] &= ((uint64_t)1 << (bit_count & 63)) - 1;
+    }
+    set->bit_count = bit_count;
+    set->rank_index_valid = 0;
+    return 0;
+}
+
+/**
+ * @brief Appends one bit (amortised O(1)).
+ * @return 0 on success, 1 on allocation error.
+ */
+static inline int append_bitset(bitset* const set, const uint8_t value)
+{
+    const size_t index = set->bit_count;
+    if (__reserve_words_bitset__(set, __word_count_bitset__(index + 1)) != 0) return 1;
+    set->words[index >> 6] |= (uint64_t)(value != 0) << (index & 63);
+    set->bit_count = index + 1;
+    set->rank_index_valid = 0;
+    return 0;
+}
+
+// index must be < bit_count for set, clear, flip, assign and test
+static inline void set_bit_bitset(bitset* const set, const size_t index)
+{
+    set->words[index >> 6] |= (uint64_t)1 << (index & 63);
+    set->rank_index_valid = 0;
+}
+
+static inline void clear_bit_bitset(bitset* const set, const size_t index)
+{
+    set->words[index >> 6] &= ~((uint64_t)1 << (index & 63));
+    set->rank_index_valid = 0;
+}
+
+static inline void flip_bit_bitset(bitset* const set, const size_t index)
+{
+    set->words[index >> 6] ^= (uint64_t)1 << (index & 63);
+    set->rank_index_valid = 0;
+}
+
+static inline void assign_bit_bitset(bitset* const set, const size_t index, const uint8_t value)
+{
+    const uint64_t mask = (uint64_t)1 << (index & 63);
+    set->words[index >> 6] = (set->words[index >> 6] & ~mask) | ((value != 0) ? mask : 0);
+    set->rank_index_valid = 0;
+}
+
+static inline uint8_t test_bit_bitset(const bitset* const set, const size_t index)
+{
+    return (uint8_t)((set->words[index >> 6] >> (index & 63)) & 1);
+}
+
+static inline void clear_all_bitset(bitset* const set)
+{
+    if (set->bit_count == 0) return;
+    memset(set->words, 0, __word_count_bitset__(set->bit_count) * sizeof(uint64_t));
+    set->rank_index_valid = 0;
+}
+
+static inline void set_all_bitset(bitset* const set)
+{
+    const size_t word_count = __word_count_bitset__(set->bit_count);
+    if (word_count == 0) return;
+    memset(set->words, 0xFF, word_count * sizeof(uint64_t));
+    if ((set->bit_count & 63) != 0) set->words[word_count - 1] = ((uint64_t)1 << (set->bit_count & 63)) - 1;
+    set->rank_index_valid = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Bulk operations
+// ---------------------------------------------------------------------------------------------------------------------------
+
+// Internal use only; defines NAME(dst, src, count) applying dst[i] = SCALAR(dst[i], src[i]) over count words,
+// with AVX2_NAME as its 4-words-at-a-time kernel (returning the words covered)
+#if defined(BITSET_AVX2)
+    #define __BITSET_DEFINE_BULK__(NAME, AVX2_NAME, VECTOR, SCALAR) \
+    __BITSET_AVX2_TARGET__ static inline size_t AVX2_NAME(uint64_t* const dst, const uint64_t* const src, const size_t count) \
+    { \
+        size_t i = 0; \
+        for (const size_t vector_end = count & ~(size_t)3; i < vector_end; i += 4) \
+        { \
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i)); \
+            const __m256i b = _mm256_loadu_si256((const __m256i*)(src + i)); \
+            _mm256_storeu_si256((__m256i*)(dst + i), VECTOR(a, b)); \
+        } \
+        return i; \
+    } \
+    static inline void NAME(uint64_t* const dst, const uint64_t* const src, const size_t count) \
+    { \
+        size_t i = __has_avx2_bitset__() ? AVX2_NAME(dst, src, count) : 0; \
+        for (; i < count; i++) dst[i] = SCALAR(dst[i], src[i]); \
+    }
+#else
+    #define __BITSET_DEFINE_BULK__(NAME, AVX2_NAME, VECTOR, SCALAR) \
+    static inline void NAME(uint64_t* const dst, const uint64_t* const src, const size_t count) \
+    { \
+        for (size_t i = 0; i < count; i++) dst[i] = SCALAR(dst[i], src[i]); \
+    }
+#endif
+
+#define __BITSET_AND__(A, B) ((A) & (B))
+#define __BITSET_OR__(A, B) ((A) | (B))
+#define __BITSET_XOR__(A, B) ((A) ^ (B))
+#define __BITSET_ANDNOT__(A, B) ((A) & ~(B))
+#define __BITSET_ANDNOT_256__(A, B) _mm256_andnot_si256((B), (A))
+
+__BITSET_DEFINE_BULK__(__and_words_bitset__, __and_words_avx2_bitset__, _mm256_and_si256, __BITSET_AND__)
+__BITSET_DEFINE_BULK__(__or_words_bitset__, __or_words_avx2_bitset__, _mm256_or_si256, __BITSET_OR__)
+__BITSET_DEFINE_BULK__(__xor_words_bitset__, __xor_words_avx2_bitset__, _mm256_xor_si256, __BITSET_XOR__)
+__BITSET_DEFINE_BULK__(__andnot_words_bitset__, __andnot_words_avx2_bitset__, __BITSET_ANDNOT_256__, __BITSET_ANDNOT__)
+
+/*
+    Bulk operations write into dst; bits src does not have count as clear.
+    or / xor grow dst to src's length, so they can fail on allocation (returning 1, dst unchanged); and / andnot cannot.
+*/
+
+static inline int and_bitset(bitset* const dst, const bitset* const src)
+{
+    const size_t dst_words = __word_count_bitset__(dst->bit_count);
+    const size_t src_words = __word_count_bitset__(src->bit_count);
+    const size_t common = (dst_words < src_words) ? dst_words : src_words;
+    __and_words_bitset__(dst->words, src->words, common);
+    if (dst_words > common) memset(dst->words + common, 0, (dst_words - common) * sizeof(uint64_t));
+    dst->rank_index_valid = 0;
+    return 0;
+}
+
+static inline int or_bitset(bitset* const dst, const bitset* const src)
+{
+    if (src->bit_count > dst->bit_count && resize_bitset(dst, src->bit_count) != 0) return 1;
+    __or_words_bitset__(dst->words, src->words, __word_count_bitset__(src->bit_count));
+    dst->rank_index_valid = 0;
+    return 0;
+}
+
+static inline int xor_bitset(bitset* const dst, const bitset* const src)
+{
+    if (src->bit_count > dst->bit_count && resize_bitset(dst, src->bit_count) != 0) return 1;
+    __xor_words_bitset__(dst->words, src->words, __word_count_bitset__(src->bit_count));
+    dst->rank_index_valid = 0;
+    return 0;
+}
+
+// dst = dst & ~src
+static inline int andnot_bitset(bitset* const dst, const bitset* const src)
+{
+    const size_t dst_words = __word_count_bitset__(dst->bit_count);
+    const size_t src_words = __word_count_bitset__(src->bit_count);
+    __andnot_words_bitset__(dst->words, src->words, (dst_words < src_words) ? dst_words : src_words);
+    dst->rank_index_valid = 0;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Counting and searching
+// ---------------------------------------------------------------------------------------------------------------------------
+
+static inline size_t popcount_bitset(const bitset* const set)
+{
+    return (size_t)__popcount_words_bitset__(set->words, __word_count_bitset__(set->bit_count));
+}
+
+/**
+ * @brief Number of bits set in both @p a and @p b, without materialising the intersection.
+ */
+static inline size_t intersection_count_bitset(const bitset* const a, const bitset* const b)
+{
+    const size_t a_words = __word_count_bitset__(a->bit_count);
+    const size_t b_words = __word_count_bitset__(b->bit_count);
+    const size_t count = (a_words < b_words) ? a_words : b_words;
+
+    uint64_t total = 0;
+    size_t i = 0;
+#if defined(BITSET_AVX2)
+    if (__has_avx2_bitset__()) i = __intersection_count_avx2_bitset__(a->words, b->words, count, &total);
+#endif
+    for (; i < count; i++) total += __popcount_64_bitset__(a->words[i] & b->words[i]);
+    return (size_t)total;
+}
+
+/**
+ * @brief Index of the first set bit at or after @p from; bit_count if there is none.
+ * Iterate with: for (size_t i = find_first_set_bitset(s, 0); i < s->bit_count; i = find_first_set_bitset(s, i + 1))
+ */
+static inline size_t find_first_set_bitset(const bitset* const set, const size_t from)
+{
+    if (from >= set->bit_count) return set->bit_count;
+
+    const size_t word_count = __word_count_bitset__(set->bit_count);
+    size_t w = from >> 6;
+    const uint64_t first = set->words[w] & (~(uint64_t)0 << (from & 63));
+    if (first != 0) return (w << 6) + __ctz_64_bitset__(first);
+
+    w++;
+#if defined(BITSET_AVX2)
+    if (__has_avx2_bitset__()) w = __skip_zero_words_avx2_bitset__(set->words, w, word_count);
+#endif
+    for (; w < word_count; w++)
+    {
+        if (set->words[w] != 0) return (w << 6) + __ctz_64_bitset__(set->words[w]);
+    }
+    return set->bit_count;
+}
+
+/**
+ * @brief Writes the indices of every set bit, ascending, to @p out (which must hold popcount_bitset() entries).
+ * @return The number of indices written.
+ */
+static inline size_t get_set_bits_bitset(const bitset* const set, size_t* const out)
+{
+    const size_t word_count = __word_count_bitset__(set->bit_count);
+    size_t written = 0;
+    for (size_t w = 0; w < word_count; w++)
+    {
+        uint64_t word = set->words[w];
+        while (word != 0)
+        {
+            out[written++] = (w << 6) + __ctz_64_bitset__(word);
+            word &= word - 1;
+        }
+    }
+    return written;
+}
+
+/**
+ * @brief Builds the rank / select index (one running count per 512 bits); it stays in use until the next modification.
+ * @return 0 on success, 1 on allocation error.
+ */
+static inline int build_rank_index_bitset(bitset* const set)
+{
+    const size_t word_count = __word_count_bitset__(set->bit_count);
+    const size_t block_count = (word_count + BITSET_RANK_BLOCK_WORDS - 1) / BITSET_RANK_BLOCK_WORDS;
+    if (block_count > set->rank_index_size)
+    {
+        uint64_t* const index = (uint64_t*)realloc(set->rank_index, block_count * sizeof(uint64_t));
+        if (index == NULL) return 1;
+        set->rank_index = index;
+        set->rank_index_size = block_count;
+    }
+
+    uint64_t running = 0;
+    for (size_t block = 0; block < block_count; block++)
+    {
+        set->rank_index[block] = running;
+        const size_t start = block * BITSET_RANK_BLOCK_WORDS;
+        const size_t end = (start + BITSET_RANK_BLOCK_WORDS < word_count) ? start + BITSET_RANK_BLOCK_WORDS : word_count;
+        running += __popcount_words_bitset__(set->words + start, end - start);
+    }
+    set->rank_index_valid = 1;
+    return 0;
+}
+
+/**
+ * @brief Number of set bits in [0, @p index) (index is clamped to bit_count).
+ */
+static inline size_t rank_bitset(const bitset* const set, size_t index)
+{
+    if (index > set->bit_count) index = set->bit_count;
+    const size_t word = index >> 6;
+
+    uint64_t count;
+    if (set->rank_index_valid && word != 0)
+    {
+        size_t block = word / BITSET_RANK_BLOCK_WORDS;
+        if (block * BITSET_RANK_BLOCK_WORDS >= __word_count_bitset__(set->bit_count)) block--; // index == bit_count on a block boundary
+        count = set->rank_index[block] + __popcount_words_bitset__(set->words + block * BITSET_RANK_BLOCK_WORDS, word - block * BITSET_RANK_BLOCK_WORDS);
+    }
+    else count = __popcount_words_bitset__(set->words, word);
+
+    if ((index & 63) != 0) count += __popcount_64_bitset__(set->words[word] & (((uint64_t)1 << (index & 63)) - 1));
+    return (size_t)count;
+}
+
+/**
+ * @brief Index of the set bit of rank @p rank (the (rank + 1)-th set bit); bit_count if there are not that many.
+ */
+static inline size_t select_bitset(const bitset* const set, size_t rank)
+{
+    const size_t word_count = __word_count_bitset__(set->bit_count);
+    size_t w = 0;
+
+    if (set->rank_index_valid && set->rank_index_size > 0)
+    {
+        // Last block whose running count is <= rank
+        size_t low = 0;
+        size_t high = (word_count + BITSET_RANK_BLOCK_WORDS - 1) / BITSET_RANK_BLOCK_WORDS;
+        while (high - low > 1)
+        {
+            const size_t mid = low + (high - low) / 2;
+            if (set->rank_index[mid] <= rank) low = mid;
+            else high = mid;
+        }
+        rank -= set->rank_index[low];
+        w = low * BITSET_RANK_BLOCK_WORDS;
+    }
+
+    for (; w < word_count; w++)
+    {
+        const uint32_t bits = __popcount_64_bitset__(set->words[w]);
+        if (rank < bits) return (w << 6) + __select_64_bitset__(set->words[w], (uint32_t)rank);
+        rank -= bits;
+    }
+    return set->bit_count;
+}
+
+#endif
@@ -0,0 +1,1157 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include "bitset.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROARING_BITMAP_ARRAY_MAX 4096 // array containers hold at most this many values; fuller chunks are bitmaps
+#define ROARING_BITMAP_WORDS 1024 // 64-bit words in a bitmap container (2^16 bits)
+#define ROARING_BITMAP_SERIAL_MAGIC 0x504D4252U // "RBMP"
+#define ROARING_BITMAP_SERIAL_VERSION 1U
+
+/*
+    Compressed set of uint32 values (Roaring layout): values are split by their high 16 bits into chunks of 2^16, and each
+    non-empty chunk is stored in the smallest of three containers:
+        array  - sorted uint16 low halves (up to 4096 values, 2 bytes each)
+        bitmap - 2^16 bits (8 KiB, any cardinality)
+        run    - sorted runs of consecutive values (4 bytes per run)
+    Inserts and removes keep the array / bitmap choice by cardinality; a run container touched by them is expanded first, so
+    call optimize_roaring_bitmap() after bulk changes (or after add_range_roaring_bitmap) to re-pack chunks that compress as runs.
+    Array intersections gallop over the larger side and locate each value within a 16-value block with one AVX2 compare (when the CPU has it).
+*/
+
+enum roaring_container_type
+{
+    ROARING_CONTAINER_ARRAY,
+    ROARING_CONTAINER_BITMAP,
+    ROARING_CONTAINER_RUN
+};
+
+typedef struct roaring_run
+{
+    uint16_t start;
+    uint16_t length; // the run holds start ..= start + length
+} roaring_run;
+
+typedef struct roaring_container
+{
+    uint16_t key; // high 16 bits of every value in the container
+    uint8_t type; // enum roaring_container_type
+    uint32_t cardinality; // 1 ..= 65536
+    uint32_t size; // array: values, run: runs, bitmap: ROARING_BITMAP_WORDS
+    uint32_t capacity; // entries allocated
+    union
+    {
+        uint16_t* values;
+        uint64_t* words;
+        roaring_run* runs;
+    };
+} roaring_container;
+
+typedef struct roaring_bitmap
+{
+    roaring_container* containers; // sorted by key
+    uint32_t size;
+    uint32_t capacity;
+} roaring_bitmap;
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Containers
+// ---------------------------------------------------------------------------------------------------------------------------
+
+// Internal use only
+static inline void __clean_container_roaring_bitmap__(roaring_container* const container)
+{
+    free(container->values); // same pointer for every type
+    container->values = NULL;
+    container->size = 0;
+    container->capacity = 0;
+    container->cardinality = 0;
+}
+
+// Internal use only; room for capacity entries of item_size bytes. Returns 0 on success, else 1
+static inline int __reserve_container_roaring_bitmap__(roaring_container* const container, uint32_t capacity, const size_t item_size)
+{
+    if (capacity <= container->capacity) return 0;
+    if (capacity < container->capacity * 2) capacity = container->capacity * 2;
+    if (capacity < 4) capacity = 4;
+
+    void* const data = realloc(container->values, (size_t)capacity * item_size);
+    if (data == NULL) return 1;
+    container->values = (uint16_t*)data;
+    container->capacity = capacity;
+    return 0;
+}
+
+// Internal use only; sets bits first ..= last of a bitmap container's words
+static inline void __set_range_words_roaring_bitmap__(uint64_t* const words, const uint32_t first, const uint32_t last)
+{
+    const uint32_t first_word = first >> 6;
+    const uint32_t last_word = last >> 6;
+    const uint64_t first_mask = ~(uint64_t)0 << (first & 63);
+    const uint64_t last_mask = ~(uint64_t)0 >> (63 - (last & 63));
+    if (first_word == last_word)
+    {
+        words[first_word] |= first_mask & last_mask;
+        return;
+    }
+    words[first_word] |= first_mask;
+    for (uint32_t w = first_word + 1; w < last_word; w++) words[w] = ~(uint64_t)0;
+    words[last_word] |= last_mask;
+}
+
+// Internal use only; first position >= from whose bit equals value, or 65536
+static inline uint32_t __next_bit_roaring_bitmap__(const uint64_t* const words, const uint32_t from, const uint8_t value)
+{
+    if (from >= 65536) return 65536;
+    uint32_t w = from >> 6;
+    uint64_t word = (value ? words[w] : ~words[w]) & (~(uint64_t)0 << (from & 63));
+    while (word == 0)
+    {
+        if (++w == ROARING_BITMAP_WORDS) return 65536;
+        word = value ? words[w] : ~words[w];
+    }
+    return (w << 6) + __ctz_64_bitset__(word);
+}
+
+// Internal use only; number of runs the container would need
+static inline uint32_t __run_count_roaring_bitmap__(const roaring_container* const container)
+{
+    uint32_t runs = 0;
+    switch (container->type)
+    {
+        case ROARING_CONTAINER_ARRAY:
+            for (uint32_t i = 0; i < container->size; i++)
+            {
+                if (i == 0 || container->values[i] != (uint16_t)(container->values[i - 1] + 1)) runs++;
+            }
+            return runs;
+        case ROARING_CONTAINER_BITMAP:
+        {
+            uint64_t carry = 0; // top bit of the previous word, which continues a run into this one
+            for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++)
+            {
+                const uint64_t word = container->words[w];
+                runs += __popcount_64_bitset__(word & ~((word << 1) | carry)); // run starts
+                carry = word >> 63;
+            }
+            return runs;
+        }
+        case ROARING_CONTAINER_RUN:
+        default:
+            return container->size;
+    }
+}
+
+// Internal use only; array -> bitmap. Returns 0 on success, else 1 (container unchanged)
+static inline int __array_to_bitmap_roaring_bitmap__(roaring_container* const container)
+{
+    uint64_t* const words = (uint64_t*)calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+    if (words == NULL) return 1;
+    for (uint32_t i = 0; i < container->size; i++) words[container->values[i] >> 6] |= (uint64_t)1 << (container->values[i] & 63);
+
+    free(container->values);
+    container->words = words;
+    container->type = ROARING_CONTAINER_BITMAP;
+    container->size = ROARING_BITMAP_WORDS;
+    container->capacity = ROARING_BITMAP_WORDS;
+    return 0;
+}
+
+// Internal use only; bitmap -> array (cardinality must be <= ROARING_BITMAP_ARRAY_MAX). Returns 0 on success, else 1 (container unchanged)
+static inline int __bitmap_to_array_roaring_bitmap__(roaring_container* const container)
+{
+    const uint32_t capacity = (container->cardinality < 4) ? 4 : container->cardinality;
+    uint16_t* const values = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+    if (values == NULL) return 1;
+
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++)
+    {
+        uint64_t word = container->words[w];
+        while (word != 0)
+        {
+            values[count++] = (uint16_t)((w << 6) + __ctz_64_bitset__(word));
+            word &= word - 1;
+        }
+    }
+
+    free(container->words);
+    container->values = values;
+    container->type = ROARING_CONTAINER_ARRAY;
+    container->size = count;
+    container->capacity = capacity;
+    return 0;
+}
+
+// Internal use only; run -> array or bitmap by cardinality. Returns 0 on success, else 1 (container unchanged)
+static inline int __expand_run_roaring_bitmap__(roaring_container* const container)
+{
+    const roaring_run* const runs = container->runs;
+    if (container->cardinality <= ROARING_BITMAP_ARRAY_MAX)
+    {
+        const uint32_t capacity = (container->cardinality < 4) ? 4 : container->cardinality;
+        uint16_t* const values = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+        if (values == NULL) return 1;
+        uint32_t count = 0;
+        for (uint32_t r = 0; r < container->size; r++)
+        {
+            for (uint32_t v = runs[r].start; v <= (uint32_t)runs[r].start + runs[r].length; v++) values[count++] = (uint16_t)v;
+        }
+        container->values = values;
+        container->type = ROARING_CONTAINER_ARRAY;
+        container->size = count;
+        container->capacity = capacity;
+    }
+    else
+    {
+        uint64_t* const words = (uint64_t*)calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+        if (words == NULL) return 1;
+        for (uint32_t r = 0; r < container->size; r++)
+        {
+            __set_range_words_roaring_bitmap__(words, runs[r].start, (uint32_t)runs[r].start + runs[r].length);
+        }
+        container->words = words;
+        container->type = ROARING_CONTAINER_BITMAP;
+        container->size = ROARING_BITMAP_WORDS;
+        container->capacity = ROARING_BITMAP_WORDS;
+    }
+    free((void*)runs);
+    return 0;
+}
+
+// Internal use only; array or bitmap -> run. Returns 0 on success, else 1 (container unchanged)
+static inline int __to_run_roaring_bitmap__(roaring_container* const container)
+{
+    const uint32_t run_count = __run_count_roaring_bitmap__(container);
+    roaring_run* const runs = (roaring_run*)malloc(run_count * sizeof(roaring_run));
+    if (runs == NULL) return 1;
+
+    uint32_t r = 0;
+    if (container->type == ROARING_CONTAINER_ARRAY)
+    {
+        for (uint32_t i = 0; i < container->size; i++)
+        {
+            if (i == 0 || container->values[i] != (uint16_t)(container->values[i - 1] + 1))
+            {
+                runs[r].start = container->values[i];
+                runs[r++].length = 0;
+            }
+            else runs[r - 1].length++;
+        }
+    }
+    else
+    {
+        uint32_t start = __next_bit_roaring_bitmap__(container->words, 0, 1);
+        while (start < 65536)
+        {
+            const uint32_t end = __next_bit_roaring_bitmap__(container->words, start, 0); // one past the run
+            runs[r].start = (uint16_t)start;
+            runs[r++].length = (uint16_t)(end - 1 - start);
+            start = __next_bit_roaring_bitmap__(container->words, end, 1);
+        }
+    }
+
+    free(container->values);
+    container->runs = runs;
+    container->type = ROARING_CONTAINER_RUN;
+    container->size = run_count;
+    container->capacity = run_count;
+    return 0;
+}
+
+// Internal use only; deep copy. Returns 0 on success, else 1
+static inline int __copy_container_roaring_bitmap__(roaring_container* const dst, const roaring_container* const src)
+{
+    size_t bytes;
+    switch (src->type)
+    {
+        case ROARING_CONTAINER_ARRAY: bytes = src->size * sizeof(uint16_t); break;
+        case ROARING_CONTAINER_RUN: bytes = src->size * sizeof(roaring_run); break;
+        case ROARING_CONTAINER_BITMAP:
+        default: bytes = ROARING_BITMAP_WORDS * sizeof(uint64_t); break;
+    }
+
+    *dst = *src;
+    dst->capacity = src->size;
+    dst->values = (uint16_t*)malloc((bytes == 0) ? 1 : bytes);
+    if (dst->values == NULL) return 1;
+    memcpy(dst->values, src->values, bytes);
+    return 0;
+}
+
+// Internal use only; *view is src, or for a run container an expanded copy held in scratch (clean it if *view == scratch)
+static inline int __view_container_roaring_bitmap__(const roaring_container* const src, roaring_container* const scratch, const roaring_container** const view)
+{
+    *view = src;
+    if (src->type != ROARING_CONTAINER_RUN) return 0;
+    if (__copy_container_roaring_bitmap__(scratch, src) != 0) return 1;
+    if (__expand_run_roaring_bitmap__(scratch) != 0)
+    {
+        __clean_container_roaring_bitmap__(scratch);
+        return 1;
+    }
+    *view = scratch;
+    return 0;
+}
+
+// Internal use only
+static inline uint8_t __contains_container_roaring_bitmap__(const roaring_container* const container, const uint16_t value)
+{
+    switch (container->type)
+    {
+        case ROARING_CONTAINER_ARRAY:
+        {
+            uint32_t low = 0, high = container->size;
+            while (low < high)
+            {
+                const uint32_t mid = (low + high) / 2;
+                if (container->values[mid] < value) low = mid + 1;
+                else high = mid;
+            }
+            return low < container->size && container->values[low] == value;
+        }
+        case ROARING_CONTAINER_BITMAP:
+            return (uint8_t)((container->words[value >> 6] >> (value & 63)) & 1);
+        case ROARING_CONTAINER_RUN:
+        default:
+        {
+            // Last run starting at or before value
+            uint32_t low = 0, high = container->size;
+            while (low < high)
+            {
+                const uint32_t mid = (low + high) / 2;
+                if (container->runs[mid].start <= value) low = mid + 1;
+                else high = mid;
+            }
+            return low > 0 && value <= (uint32_t)container->runs[low - 1].start + container->runs[low - 1].length;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Bitmap
+// ---------------------------------------------------------------------------------------------------------------------------
+
+static inline void set_roaring_bitmap(roaring_bitmap* const bitmap)
+{
+    bitmap->containers = NULL;
+    bitmap->size = 0;
+    bitmap->capacity = 0;
+}
+
+static inline roaring_bitmap* new_roaring_bitmap(void)
+{
+    roaring_bitmap* const bitmap = (roaring_bitmap*)calloc(1, sizeof(roaring_bitmap));
+    if (bitmap == NULL) return NULL;
+    set_roaring_bitmap(bitmap);
+    return bitmap;
+}
+
+static inline void clean_roaring_bitmap(roaring_bitmap* const bitmap)
+{
+    for (uint32_t i = 0; i < bitmap->size; i++) __clean_container_roaring_bitmap__(&bitmap->containers[i]);
+    free(bitmap->containers);
+    set_roaring_bitmap(bitmap);
+}
+
+static inline void free_roaring_bitmap(roaring_bitmap* const bitmap)
+{
+    clean_roaring_bitmap(bitmap);
+    free(bitmap);
+}
+
+// Internal use only; index of the first container with key >= key
+static inline uint32_t __find_container_roaring_bitmap__(const roaring_bitmap* const bitmap, const uint16_t key)
+{
+    uint32_t low = 0, high = bitmap->size;
+    if (high > 0 && bitmap->containers[high - 1].key < key) return high; // appends in ascending order skip the search
+    while (low < high)
+    {
+        const uint32_t mid = (low + high) / 2;
+        if (bitmap->containers[mid].key < key) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+// Internal use only; inserts an empty array container at index, or NULL on allocation error
+static inline roaring_container* __insert_container_roaring_bitmap__(roaring_bitmap* const bitmap, const uint32_t index, const uint16_t key)
+{
+    if (bitmap->size == bitmap->capacity)
+    {
+        const uint32_t capacity = (bitmap->capacity == 0) ? 4 : bitmap->capacity * 2;
+        roaring_container* const containers = (roaring_container*)realloc(bitmap->containers, capacity * sizeof(roaring_container));
+        if (containers == NULL) return NULL;
+        bitmap->containers = containers;
+        bitmap->capacity = capacity;
+    }
+
+    memmove(&bitmap->containers[index + 1], &bitmap->containers[index], (bitmap->size - index) * sizeof(roaring_container));
+    bitmap->size++;
+
+    roaring_container* const container = &bitmap->containers[index];
+    memset(container, 0, sizeof(roaring_container));
+    container->key = key;
+    container->type = ROARING_CONTAINER_ARRAY;
+    return container;
+}
+
+// Internal use only
+static inline void __remove_container_roaring_bitmap__(roaring_bitmap* const bitmap, const uint32_t index)
+{
+    __clean_container_roaring_bitmap__(&bitmap->containers[index]);
+    memmove(&bitmap->containers[index], &bitmap->containers[index + 1], (bitmap->size - index - 1) * sizeof(roaring_container));
+    bitmap->size--;
+}
+
+// Internal use only; appends a finished container (taking its data), or frees it if empty. Returns 0 on success, else 1
+static inline int __push_container_roaring_bitmap__(roaring_bitmap* const bitmap, roaring_container* const container)
+{
+    if (container->cardinality == 0)
+    {
+        __clean_container_roaring_bitmap__(container);
+        return 0;
+    }
+    roaring_container* const slot = __insert_container_roaring_bitmap__(bitmap, bitmap->size, container->key);
+    if (slot == NULL)
+    {
+        __clean_container_roaring_bitmap__(container);
+        return 1;
+    }
+    *slot = *container;
+    return 0;
+}
+
+/**
+ * @brief Adds @p value to the set.
+ * @return 0 on success (including when already present), 1 on allocation error.
+ */
+static inline int add_roaring_bitmap(roaring_bitmap* const bitmap, const uint32_t value)
+{
+    const uint16_t key = (uint16_t)(value >> 16);
+    const uint16_t low = (uint16_t)value;
+    const uint32_t index = __find_container_roaring_bitmap__(bitmap, key);
+
+    roaring_container* container;
+    if (index < bitmap->size && bitmap->containers[index].key == key) container = &bitmap->containers[index];
+    else
+    {
+        container = __insert_container_roaring_bitmap__(bitmap, index, key);
+        if (container == NULL) return 1;
+    }
+
+    if (container->type == ROARING_CONTAINER_RUN)
+    {
+        if (__contains_container_roaring_bitmap__(container, low)) return 0;
+        if (__expand_run_roaring_bitmap__(container) != 0) return 1;
+    }
+
+    if (container->type == ROARING_CONTAINER_ARRAY)
+    {
+        uint32_t position = container->size;
+        if (position > 0 && container->values[position - 1] >= low) // not an append
+        {
+            uint32_t first = 0, last = container->size;
+            while (first < last)
+            {
+                const uint32_t mid = (first + last) / 2;
+                if (container->values[mid] < low) first = mid + 1;
+                else last = mid;
+            }
+            if (container->values[first] == low) return 0;
+            position = first;
+        }
+
+        if (container->size == ROARING_BITMAP_ARRAY_MAX)
+        {
+            if (__array_to_bitmap_roaring_bitmap__(container) != 0) return 1;
+        }
+        else
+        {
+            if (__reserve_container_roaring_bitmap__(container, container->size + 1, sizeof(uint16_t)) != 0)
+            {
+                if (container->size == 0) __remove_container_roaring_bitmap__(bitmap, index);
+                return 1;
+            }
+            memmove(&container->values[position + 1], &container->values[position], (container->size - position) * sizeof(uint16_t));
+            container->values[position] = low;
+            container->size++;
+            container->cardinality++;
+            return 0;
+        }
+    }
+
+    uint64_t* const word = &container->words[low >> 6];
+    const uint64_t mask = (uint64_t)1 << (low & 63);
+    if ((*word & mask) == 0)
+    {
+        *word |= mask;
+        container->cardinality++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Removes @p value from the set.
+ * @return 0 on success (including when absent), 1 on allocation error (only when a run container had to be expanded).
+ */
+static inline int remove_roaring_bitmap(roaring_bitmap* const bitmap, const uint32_t value)
+{
+    const uint16_t key = (uint16_t)(value >> 16);
+    const uint16_t low = (uint16_t)value;
+    const uint32_t index = __find_container_roaring_bitmap__(bitmap, key);
+    if (index == bitmap->size || bitmap->containers[index].key != key) return 0;
+
+    roaring_container* const container = &bitmap->containers[index];
+    if (!__contains_container_roaring_bitmap__(container, low)) return 0;
+    if (container->type == ROARING_CONTAINER_RUN && __expand_run_roaring_bitmap__(container) != 0) return 1;
+
+    if (container->type == ROARING_CONTAINER_ARRAY)
+    {
+        uint32_t position = 0;
+        while (container->values[position] != low) position++;
+        memmove(&container->values[position], &container->values[position + 1], (container->size - position - 1) * sizeof(uint16_t));
+        container->size--;
+    }
+    else
+    {
+        container->words[low >> 6] &= ~((uint64_t)1 << (low & 63));
+        if (container->cardinality - 1 == ROARING_BITMAP_ARRAY_MAX)
+        {
+            container->cardinality--;
+            __bitmap_to_array_roaring_bitmap__(container); // stays a (valid) bitmap if this fails
+            return 0;
+        }
+    }
+
+    if (--container->cardinality == 0) __remove_container_roaring_bitmap__(bitmap, index);
+    return 0;
+}
+
+static inline uint8_t contains_roaring_bitmap(const roaring_bitmap* const bitmap, const uint32_t value)
+{
+    const uint16_t key = (uint16_t)(value >> 16);
+    const uint32_t index = __find_container_roaring_bitmap__(bitmap, key);
+    if (index == bitmap->size || bitmap->containers[index].key != key) return 0;
+    return __contains_container_roaring_bitmap__(&bitmap->containers[index], (uint16_t)value);
+}
+
+/**
+ * @brief Adds every value in [@p start, @p end) (end may be 2^32).
+ * Chunks with no values yet become single-run containers; existing ones are filled as bitmaps.
+ * @return 0 on success, 1 on allocation error (a prefix of the range may have been added).
+ */
+static inline int add_range_roaring_bitmap(roaring_bitmap* const bitmap, const uint32_t start, const uint64_t end)
+{
+    if (end <= start) return 0;
+    const uint64_t last = (end > ((uint64_t)1 << 32)) ? UINT32_MAX : end - 1;
+
+    for (uint64_t key = start >> 16; key <= (last >> 16); key++)
+    {
+        const uint32_t first_low = (key == (start >> 16)) ? (start & 0xFFFF) : 0;
+        const uint32_t last_low = (key == (last >> 16)) ? (uint32_t)(last & 0xFFFF) : 0xFFFF;
+        const uint32_t index = __find_container_roaring_bitmap__(bitmap, (uint16_t)key);
+
+        if (index == bitmap->size || bitmap->containers[index].key != key)
+        {
+            roaring_container* const container = __insert_container_roaring_bitmap__(bitmap, index, (uint16_t)key);
+            if (container == NULL) return 1;
+            if (__reserve_container_roaring_bitmap__(container, 1, sizeof(roaring_run)) != 0)
+            {
+                __remove_container_roaring_bitmap__(bitmap, index);
+                return 1;
+            }
+            container->type = ROARING_CONTAINER_RUN;
+            container->runs[0].start = (uint16_t)first_low;
+            container->runs[0].length = (uint16_t)(last_low - first_low);
+            container->size = 1;
+            container->cardinality = last_low - first_low + 1;
+            continue;
+        }
+
+        roaring_container* const container = &bitmap->containers[index];
+        if (container->type == ROARING_CONTAINER_RUN && __expand_run_roaring_bitmap__(container) != 0) return 1;
+        if (container->type == ROARING_CONTAINER_ARRAY && __array_to_bitmap_roaring_bitmap__(container) != 0) return 1;
+        __set_range_words_roaring_bitmap__(container->words, first_low, last_low);
+        container->cardinality = (uint32_t)__popcount_words_bitset__(container->words, ROARING_BITMAP_WORDS);
+        if (container->cardinality <= ROARING_BITMAP_ARRAY_MAX) __bitmap_to_array_roaring_bitmap__(container);
+    }
+    return 0;
+}
+
+/**
+ * @brief Re-packs every container as whichever of array, bitmap or run is smallest.
+ * @return 0 on success, 1 on allocation error (containers that could not be converted are left as they were).
+ */
+static inline int optimize_roaring_bitmap(roaring_bitmap* const bitmap)
+{
+    int result = 0;
+    for (uint32_t i = 0; i < bitmap->size; i++)
+    {
+        roaring_container* const container = &bitmap->containers[i];
+        const size_t run_bytes = (size_t)__run_count_roaring_bitmap__(container) * sizeof(roaring_run);
+        const size_t plain_bytes = (container->cardinality <= ROARING_BITMAP_ARRAY_MAX)
+            ? container->cardinality * sizeof(uint16_t)
+            : ROARING_BITMAP_WORDS * sizeof(uint64_t);
+
+        if (run_bytes < plain_bytes)
+        {
+            if (container->type != ROARING_CONTAINER_RUN) result |= __to_run_roaring_bitmap__(container);
+        }
+        else if (container->type == ROARING_CONTAINER_RUN) result |= __expand_run_roaring_bitmap__(container);
+    }
+    return result;
+}
+
+static inline uint64_t get_cardinality_roaring_bitmap(const roaring_bitmap* const bitmap)
+{
+    uint64_t cardinality = 0;
+    for (uint32_t i = 0; i < bitmap->size; i++) cardinality += bitmap->containers[i].cardinality;
+    return cardinality;
+}
+
+/**
+ * @brief Writes every value, ascending, to @p out (which must hold get_cardinality_roaring_bitmap() entries).
+ * @return The number of values written.
+ */
+static inline uint64_t to_array_roaring_bitmap(const roaring_bitmap* const bitmap, uint32_t* const out)
+{
+    uint64_t written = 0;
+    for (uint32_t i = 0; i < bitmap->size; i++)
+    {
+        const roaring_container* const container = &bitmap->containers[i];
+        const uint32_t high = (uint32_t)container->key << 16;
+        switch (container->type)
+        {
+            case ROARING_CONTAINER_ARRAY:
+                for (uint32_t j = 0; j < container->size; j++) out[written++] = high | container->values[j];
+                break;
+            case ROARING_CONTAINER_BITMAP:
+                for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++)
+                {
+                    uint64_t word = container->words[w];
+                    while (word != 0)
+                    {
+                        out[written++] = high | ((w << 6) + __ctz_64_bitset__(word));
+                        word &= word - 1;
+                    }
+                }
+                break;
+            case ROARING_CONTAINER_RUN:
+            default:
+                for (uint32_t r = 0; r < container->size; r++)
+                {
+                    const uint32_t run_end = (uint32_t)container->runs[r].start + container->runs[r].length;
+                    for (uint32_t v = container->runs[r].start; v <= run_end; v++) out[written++] = high | v;
+                }
+                break;
+        }
+    }
+    return written;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Intersection and union
+// ---------------------------------------------------------------------------------------------------------------------------
+
+// Internal use only; first index >= from with values[index] >= value (or count), by exponential then binary search
+static inline uint32_t __gallop_roaring_bitmap__(const uint16_t* const values, const uint32_t from, const uint32_t count, const uint16_t value)
+{
+    if (from >= count || values[from] >= value) return from;
+
+    uint32_t below = from; // values[below] < value
+    uint32_t step = 1;
+    uint32_t probe = from + 1;
+    while (probe < count && values[probe] < value)
+    {
+        below = probe;
+        step *= 2;
+        probe = from + step;
+    }
+    if (probe > count) probe = count;
+
+    uint32_t low = below + 1, high = probe;
+    while (low < high)
+    {
+        const uint32_t mid = (low + high) / 2;
+        if (values[mid] < value) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+#if defined(BITSET_AVX2)
+// Internal use only; offset of the first of the 16 values at block that is >= value (one must be)
+__BITSET_AVX2_TARGET__ static inline uint32_t __lower_bound_16_avx2_roaring_bitmap__(const uint16_t* const block, const uint16_t value)
+{
+    const __m256i values = _mm256_loadu_si256((const __m256i*)block);
+    const __m256i at_least = _mm256_cmpeq_epi16(_mm256_max_epu16(values, _mm256_set1_epi16((short)value)), values);
+    return __ctz_64_bitset__((uint32_t)_mm256_movemask_epi8(at_least)) / 2;
+}
+#endif
+
+/*
+    Internal use only; intersection of two sorted arrays, written to out (NULL only counts). Returns the count.
+    Walks the smaller array; in the larger one it gallops past 16-value blocks that end below the value, then finds the value's
+    position inside a block with one vector compare.
+*/
+static inline uint32_t __intersect_arrays_roaring_bitmap__(const uint16_t* small, uint32_t small_size, const uint16_t* large, uint32_t large_size, uint16_t* const out)
+{
+    if (small_size > large_size)
+    {
+        const uint16_t* const values = small; small = large; large = values;
+        const uint32_t size = small_size; small_size = large_size; large_size = size;
+    }
+
+#if defined(BITSET_AVX2)
+    const uint8_t use_avx2 = __has_avx2_bitset__();
+#endif
+    uint32_t count = 0;
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < small_size && j < large_size; i++)
+    {
+        const uint16_t value = small[i];
+        if (j + 16 <= large_size && large[j + 15] >= value)
+        {
+#if defined(BITSET_AVX2)
+            if (use_avx2) j += __lower_bound_16_avx2_roaring_bitmap__(large + j, value);
+#endif
+            while (large[j] < value) j++; // scalar scan; already done when the AVX2 compare placed j
+        }
+        else j = __gallop_roaring_bitmap__(large, j, large_size, value);
+
+        if (j < large_size && large[j] == value)
+        {
+            if (out != NULL) out[count] = value;
+            count++;
+            j++;
+        }
+    }
+    return count;
+}
+
+// Internal use only; result (which takes new storage) = a & b, with run containers already expanded. Returns 0 on success, else 1
+static inline int __and_containers_roaring_bitmap__(const roaring_container* a, const roaring_container* b, roaring_container* const result)
+{
+    memset(result, 0, sizeof(roaring_container));
+    result->key = a->key;
+
+    if (a->type == ROARING_CONTAINER_BITMAP && b->type == ROARING_CONTAINER_BITMAP)
+    {
+        result->words = (uint64_t*)malloc(ROARING_BITMAP_WORDS * sizeof(uint64_t));
+        if (result->words == NULL) return 1;
+        memcpy(result->words, a->words, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+        __and_words_bitset__(result->words, b->words, ROARING_BITMAP_WORDS);
+        result->type = ROARING_CONTAINER_BITMAP;
+        result->size = ROARING_BITMAP_WORDS;
+        result->capacity = ROARING_BITMAP_WORDS;
+        result->cardinality = (uint32_t)__popcount_words_bitset__(result->words, ROARING_BITMAP_WORDS);
+        if (result->cardinality <= ROARING_BITMAP_ARRAY_MAX) __bitmap_to_array_roaring_bitmap__(result);
+        return 0;
+    }
+
+    if (a->type == ROARING_CONTAINER_BITMAP)
+    {
+        const roaring_container* const swap = a; a = b; b = swap;
+    }
+    const uint32_t capacity = (a->size < b->size || b->type == ROARING_CONTAINER_BITMAP) ? a->size : b->size;
+    if (__reserve_container_roaring_bitmap__(result, capacity, sizeof(uint16_t)) != 0) return 1;
+    result->type = ROARING_CONTAINER_ARRAY;
+
+    if (b->type == ROARING_CONTAINER_BITMAP)
+    {
+        for (uint32_t i = 0; i < a->size; i++)
+        {
+            const uint16_t value = a->values[i];
+            result->values[result->size] = value;
+            result->size += (uint32_t)((b->words[value >> 6] >> (value & 63)) & 1);
+        }
+    }
+    else result->size = __intersect_arrays_roaring_bitmap__(a->values, a->size, b->values, b->size, result->values);
+
+    result->cardinality = result->size;
+    return 0;
+}
+
+// Internal use only; |a & b| with run containers already expanded
+static inline uint32_t __and_cardinality_containers_roaring_bitmap__(const roaring_container* a, const roaring_container* b)
+{
+    if (a->type == ROARING_CONTAINER_BITMAP && b->type == ROARING_CONTAINER_BITMAP)
+    {
+        bitset a_view = { .bit_count = 65536, .words = a->words };
+        bitset b_view = { .bit_count = 65536, .words = b->words };
+        return (uint32_t)intersection_count_bitset(&a_view, &b_view);
+    }
+    if (a->type == ROARING_CONTAINER_BITMAP)
+    {
+        const roaring_container* const swap = a; a = b; b = swap;
+    }
+    if (b->type == ROARING_CONTAINER_ARRAY) return __intersect_arrays_roaring_bitmap__(a->values, a->size, b->values, b->size, NULL);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < a->size; i++) count += (uint32_t)((b->words[a->values[i] >> 6] >> (a->values[i] & 63)) & 1);
+    return count;
+}
+
+// Internal use only; result (which takes new storage) = a | b, with run containers already expanded. Returns 0 on success, else 1
+static inline int __or_containers_roaring_bitmap__(const roaring_container* a, const roaring_container* b, roaring_container* const result)
+{
+    memset(result, 0, sizeof(roaring_container));
+    result->key = a->key;
+
+    if (a->type == ROARING_CONTAINER_ARRAY && b->type == ROARING_CONTAINER_ARRAY && a->size + b->size <= ROARING_BITMAP_ARRAY_MAX)
+    {
+        if (__reserve_container_roaring_bitmap__(result, a->size + b->size, sizeof(uint16_t)) != 0) return 1;
+        result->type = ROARING_CONTAINER_ARRAY;
+        uint32_t i = 0, j = 0, k = 0;
+        while (i < a->size && j < b->size)
+        {
+            const uint16_t x = a->values[i], y = b->values[j];
+            result->values[k++] = (x < y) ? x : y;
+            i += (x <= y);
+            j += (y <= x);
+        }
+        while (i < a->size) result->values[k++] = a->values[i++];
+        while (j < b->size) result->values[k++] = b->values[j++];
+        result->size = k;
+        result->cardinality = k;
+        return 0;
+    }
+
+    if (b->type == ROARING_CONTAINER_BITMAP)
+    {
+        const roaring_container* const swap = a; a = b; b = swap;
+    }
+    result->words = (uint64_t*)calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+    if (result->words == NULL) return 1;
+    result->type = ROARING_CONTAINER_BITMAP;
+    result->size = ROARING_BITMAP_WORDS;
+    result->capacity = ROARING_BITMAP_WORDS;
+
+    if (a->type == ROARING_CONTAINER_BITMAP) memcpy(result->words, a->words, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+    else for (uint32_t i = 0; i < a->size; i++) result->words[a->values[i] >> 6] |= (uint64_t)1 << (a->values[i] & 63);
+
+    if (b->type == ROARING_CONTAINER_BITMAP) __or_words_bitset__(result->words, b->words, ROARING_BITMAP_WORDS);
+    else for (uint32_t i = 0; i < b->size; i++) result->words[b->values[i] >> 6] |= (uint64_t)1 << (b->values[i] & 63);
+
+    result->cardinality = (uint32_t)__popcount_words_bitset__(result->words, ROARING_BITMAP_WORDS);
+    if (result->cardinality <= ROARING_BITMAP_ARRAY_MAX) __bitmap_to_array_roaring_bitmap__(result);
+    return 0;
+}
+
+/**
+ * @brief New bitmap holding the values in both @p a and @p b.
+ * @return The intersection, or NULL on allocation error.
+ */
+static inline roaring_bitmap* and_roaring_bitmap(const roaring_bitmap* const a, const roaring_bitmap* const b)
+{
+    roaring_bitmap* const result = new_roaring_bitmap();
+    if (result == NULL) return NULL;
+
+    uint32_t i = 0, j = 0;
+    while (i < a->size && j < b->size)
+    {
+        const roaring_container* const x = &a->containers[i];
+        const roaring_container* const y = &b->containers[j];
+        if (x->key != y->key)
+        {
+            if (x->key < y->key) i++;
+            else j++;
+            continue;
+        }
+
+        roaring_container x_scratch, y_scratch, container;
+        const roaring_container* x_view;
+        const roaring_container* y_view;
+        int error = __view_container_roaring_bitmap__(x, &x_scratch, &x_view);
+        if (error == 0)
+        {
+            error = __view_container_roaring_bitmap__(y, &y_scratch, &y_view);
+            if (error == 0)
+            {
+                error = __and_containers_roaring_bitmap__(x_view, y_view, &container);
+                if (error == 0) error = __push_container_roaring_bitmap__(result, &container);
+                if (y_view == &y_scratch) __clean_container_roaring_bitmap__(&y_scratch);
+            }
+            if (x_view == &x_scratch) __clean_container_roaring_bitmap__(&x_scratch);
+        }
+        if (error != 0)
+        {
+            free_roaring_bitmap(result);
+            return NULL;
+        }
+        i++;
+        j++;
+    }
+    return result;
+}
+
+/**
+ * @brief Number of values in both @p a and @p b, without building the intersection.
+ * @return The count, or UINT64_MAX on allocation error (expanding a run container).
+ */
+static inline uint64_t and_cardinality_roaring_bitmap(const roaring_bitmap* const a, const roaring_bitmap* const b)
+{
+    uint64_t count = 0;
+    uint32_t i = 0, j = 0;
+    while (i < a->size && j < b->size)
+    {
+        const roaring_container* const x = &a->containers[i];
+        const roaring_container* const y = &b->containers[j];
+        if (x->key != y->key)
+        {
+            if (x->key < y->key) i++;
+            else j++;
+            continue;
+        }
+
+        roaring_container x_scratch, y_scratch;
+        const roaring_container* x_view;
+        const roaring_container* y_view;
+        if (__view_container_roaring_bitmap__(x, &x_scratch, &x_view) != 0) return UINT64_MAX;
+        if (__view_container_roaring_bitmap__(y, &y_scratch, &y_view) != 0)
+        {
+            if (x_view == &x_scratch) __clean_container_roaring_bitmap__(&x_scratch);
+            return UINT64_MAX;
+        }
+        count += __and_cardinality_containers_roaring_bitmap__(x_view, y_view);
+        if (x_view == &x_scratch) __clean_container_roaring_bitmap__(&x_scratch);
+        if (y_view == &y_scratch) __clean_container_roaring_bitmap__(&y_scratch);
+        i++;
+        j++;
+    }
+    return count;
+}
+
+/**
+ * @brief New bitmap holding the values in @p a or @p b.
+ * @return The union, or NULL on allocation error.
+ */
+static inline roaring_bitmap* or_roaring_bitmap(const roaring_bitmap* const a, const roaring_bitmap* const b)
+{
+    roaring_bitmap* const result = new_roaring_bitmap();
+    if (result == NULL) return NULL;
+
+    uint32_t i = 0, j = 0;
+    while (i < a->size || j < b->size)
+    {
+        roaring_container container;
+        int error;
+        if (j == b->size || (i < a->size && a->containers[i].key < b->containers[j].key))
+        {
+            error = __copy_container_roaring_bitmap__(&container, &a->containers[i++]);
+        }
+        else if (i == a->size || b->containers[j].key < a->containers[i].key)
+        {
+            error = __copy_container_roaring_bitmap__(&container, &b->containers[j++]);
+        }
+        else
+        {
+            roaring_container x_scratch, y_scratch;
+            const roaring_container* x_view;
+            const roaring_container* y_view;
+            error = __view_container_roaring_bitmap__(&a->containers[i++], &x_scratch, &x_view);
+            if (error == 0)
+            {
+                error = __view_container_roaring_bitmap__(&b->containers[j++], &y_scratch, &y_view);
+                if (error == 0)
+                {
+                    error = __or_containers_roaring_bitmap__(x_view, y_view, &container);
+                    if (y_view == &y_scratch) __clean_container_roaring_bitmap__(&y_scratch);
+                }
+                if (x_view == &x_scratch) __clean_container_roaring_bitmap__(&x_scratch);
+            }
+        }
+
+        if (error == 0) error = __push_container_roaring_bitmap__(result, &container);
+        if (error != 0)
+        {
+            free_roaring_bitmap(result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Serialization
+// ---------------------------------------------------------------------------------------------------------------------------
+
+/*
+    Little-endian layout: magic, version and container count (u32 each), then per container its key (u16), type (u8),
+    cardinality and size (u32 each) followed by its payload: size u16 values, 1024 u64 words, or size (start, length) u16 pairs.
+*/
+
+// Internal use only
+static inline uint8_t* __write_roaring_bitmap__(uint8_t* buffer, const uint64_t value, const int bytes)
+{
+    for (int i = 0; i < bytes; i++) *buffer++ = (uint8_t)(value >> (8 * i));
+    return buffer;
+}
+
+// Internal use only
+static inline uint64_t __read_roaring_bitmap__(const uint8_t** const buffer, const int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)(*(*buffer)++) << (8 * i);
+    return value;
+}
+
+// Internal use only; payload bytes of a container in the serialized form
+static inline uint64_t __payload_size_roaring_bitmap__(const uint8_t type, const uint32_t size)
+{
+    switch (type)
+    {
+        case ROARING_CONTAINER_ARRAY: return (uint64_t)size * 2;
+        case ROARING_CONTAINER_RUN: return (uint64_t)size * 4;
+        case ROARING_CONTAINER_BITMAP:
+        default: return ROARING_BITMAP_WORDS * 8;
+    }
+}
+
+static inline uint64_t get_serialized_size_roaring_bitmap(const roaring_bitmap* const bitmap)
+{
+    uint64_t size = 4 + 4 + 4;
+    for (uint32_t i = 0; i < bitmap->size; i++)
+    {
+        size += 2 + 1 + 4 + 4 + __payload_size_roaring_bitmap__(bitmap->containers[i].type, bitmap->containers[i].size);
+    }
+    return size;
+}
+
+/**
+ * @brief Writes the bitmap to @p buffer, which must hold get_serialized_size_roaring_bitmap() bytes.
+ * @return The number of bytes written.
+ */
+static inline uint64_t serialize_roaring_bitmap(const roaring_bitmap* const bitmap, uint8_t* const buffer)
+{
+    uint8_t* ptr = buffer;
+    ptr = __write_roaring_bitmap__(ptr, ROARING_BITMAP_SERIAL_MAGIC, 4);
+    ptr = __write_roaring_bitmap__(ptr, ROARING_BITMAP_SERIAL_VERSION, 4);
+    ptr = __write_roaring_bitmap__(ptr, bitmap->size, 4);
+    for (uint32_t i = 0; i < bitmap->size; i++)
+    {
+        const roaring_container* const container = &bitmap->containers[i];
+        ptr = __write_roaring_bitmap__(ptr, container->key, 2);
+        ptr = __write_roaring_bitmap__(ptr, container->type, 1);
+        ptr = __write_roaring_bitmap__(ptr, container->cardinality, 4);
+        ptr = __write_roaring_bitmap__(ptr, container->size, 4);
+        switch (container->type)
+        {
+            case ROARING_CONTAINER_ARRAY:
+                for (uint32_t j = 0; j < container->size; j++) ptr = __write_roaring_bitmap__(ptr, container->values[j], 2);
+                break;
+            case ROARING_CONTAINER_BITMAP:
+                for (uint32_t j = 0; j < ROARING_BITMAP_WORDS; j++) ptr = __write_roaring_bitmap__(ptr, container->words[j], 8);
+                break;
+            case ROARING_CONTAINER_RUN:
+            default:
+                for (uint32_t j = 0; j < container->size; j++)
+                {
+                    ptr = __write_roaring_bitmap__(ptr, container->runs[j].start, 2);
+                    ptr = __write_roaring_bitmap__(ptr, container->runs[j].length, 2);
+                }
+                break;
+        }
+    }
+    return (uint64_t)(ptr - buffer);
+}
+
+// Internal use only; reads one container's payload into container (type, size and cardinality already set). Returns 0 if well formed
+static inline int __read_container_roaring_bitmap__(roaring_container* const container, const uint8_t** const ptr)
+{
+    switch (container->type)
+    {
+        case ROARING_CONTAINER_ARRAY:
+        {
+            if (container->size == 0 || container->size > ROARING_BITMAP_ARRAY_MAX || container->cardinality != container->size) return 1;
+            if (__reserve_container_roaring_bitmap__(container, container->size, sizeof(uint16_t)) != 0) return 1;
+            for (uint32_t j = 0; j < container->size; j++)
+            {
+                container->values[j] = (uint16_t)__read_roaring_bitmap__(ptr, 2);
+                if (j > 0 && container->values[j] <= container->values[j - 1]) return 1;
+            }
+            return 0;
+        }
+        case ROARING_CONTAINER_BITMAP:
+        {
+            container->words = (uint64_t*)malloc(ROARING_BITMAP_WORDS * sizeof(uint64_t));
+            if (container->words == NULL) return 1;
+            container->capacity = ROARING_BITMAP_WORDS;
+            for (uint32_t j = 0; j < ROARING_BITMAP_WORDS; j++) container->words[j] = __read_roaring_bitmap__(ptr, 8);
+            return container->cardinality == 0 || container->cardinality != __popcount_words_bitset__(container->words, ROARING_BITMAP_WORDS);
+        }
+        case ROARING_CONTAINER_RUN:
+        {
+            if (container->size == 0 || container->size > 32768) return 1;
+            if (__reserve_container_roaring_bitmap__(container, container->size, sizeof(roaring_run)) != 0) return 1;
+            uint64_t cardinality = 0;
+            for (uint32_t j = 0; j < container->size; j++)
+            {
+                roaring_run* const run = &container->runs[j];
+                run->start = (uint16_t)__read_roaring_bitmap__(ptr, 2);
+                run->length = (uint16_t)__read_roaring_bitmap__(ptr, 2);
+                if ((uint32_t)run->start + run->length > 0xFFFF) return 1;
+                if (j > 0 && run->start <= (uint32_t)container->runs[j - 1].start + container->runs[j - 1].length) return 1;
+                cardinality += (uint64_t)run->length + 1;
+            }
+            return cardinality != container->cardinality;
+        }
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief Rebuilds a bitmap written by serialize_roaring_bitmap().
+ * @return The new bitmap, or NULL if the buffer is malformed or allocation failed.
+ */
+static inline roaring_bitmap* deserialize_roaring_bitmap(const uint8_t* const buffer, const uint64_t size)
+{
+    if (size < 12) return NULL;
+
+    const uint8_t* ptr = buffer;
+    const uint8_t* const end = buffer + size;
+    const uint32_t magic = (uint32_t)__read_roaring_bitmap__(&ptr, 4);
+    const uint32_t version = (uint32_t)__read_roaring_bitmap__(&ptr, 4);
+    const uint32_t count = (uint32_t)__read_roaring_bitmap__(&ptr, 4);
+    if (magic != ROARING_BITMAP_SERIAL_MAGIC || version != ROARING_BITMAP_SERIAL_VERSION || count > 65536) return NULL;
+
+    roaring_bitmap* const bitmap = new_roaring_bitmap();
+    if (bitmap == NULL) return NULL;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if ((uint64_t)(end - ptr) < 11) break;
+        roaring_container container;
+        memset(&container, 0, sizeof(roaring_container));
+        container.key = (uint16_t)__read_roaring_bitmap__(&ptr, 2);
+        container.type = (uint8_t)__read_roaring_bitmap__(&ptr, 1);
+        container.cardinality = (uint32_t)__read_roaring_bitmap__(&ptr, 4);
+        container.size = (uint32_t)__read_roaring_bitmap__(&ptr, 4);
+
+        if (container.type > ROARING_CONTAINER_RUN || (uint64_t)(end - ptr) < __payload_size_roaring_bitmap__(container.type, container.size)) break;
+        if (bitmap->size > 0 && container.key <= bitmap->containers[bitmap->size - 1].key) break;
+        if (container.type == ROARING_CONTAINER_BITMAP) container.size = ROARING_BITMAP_WORDS;
+        if (__read_container_roaring_bitmap__(&container, &ptr) != 0)
+        {
+            __clean_container_roaring_bitmap__(&container);
+            break;
+        }
+        if (__push_container_roaring_bitmap__(bitmap, &container) != 0) break;
+    }
+
+    if (bitmap->size != count)
+    {
+        free_roaring_bitmap(bitmap);
+        return NULL;
+    }
+    return bitmap;
+}
+
+#endif
@@ -15,13 +15,7 @@ static inline dyn_array* string_to_dyn_array(const String* const str)
 
     dyn_array* const dyn_str = new_dyn_array(DYN_ARRAY_CHAR_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
 
-    for (int i = 0; i < str->str_length; i++)
-    {
-        char c = str->string[i];
-        append_item_dyn_array(dyn_str, &c);
-    }
-
-    strip_dyn_array(dyn_str);
+    append_range_dyn_array(dyn_str, getCharArr(str), str->str_length);
 
     return dyn_str;
 }
@@ -84,7 +78,7 @@ static inline String* dyn_array_to_string_base(const dyn_array* const dyn_str, c
     
     uint16_t buffer = 0;
     uint8_t bits_in_buffer = 0;
-    for (int i = 0; i < dyn_str->current_size * dyn_str->item_size; i++)
+    for (size_t i = 0; i < dyn_str->current_size * dyn_str->item_size; i++)
     {
         const uint8_t byte = (uint8_t)*get_dyn_array_byte(dyn_str, i);
         buffer = (buffer << 8) | byte;
@@ -363,9 +357,9 @@ static inline uint64_t string_base_to_uint64(const String* const str, const uint
 
     const uint8_t bits_per_char = (index_of_most_significant_bit(base - 1) + 1);
     uint64_t result = 0;
-    for (int i = 0; i < str->str_length; i++)
+    for (size_t i = 0; i < str->str_length; i++)
     {
-        char* pos = __strchr__(chars_arr, str->string[i]);
+        char* pos = __strchr__(chars_arr, getCharArr(str)[i]);
         if (pos == NULL) continue; // invalid character, skip
         uint8_t char_value = (uint8_t)(pos - chars_arr);
         result = (result << bits_per_char) | char_value;
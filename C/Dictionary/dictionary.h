@@ -3,11 +3,13 @@
 
 #include "../Dynamic Array/dyn_array.h"
 #include "../Strings/String.h"
+#include "../Memory/allocator.h"
 #include "../Hashing/xxHash-3-64.h"
 #include "../Conversions/conversions.h"
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #define DICTIONARY_OUTPUT_PTR_BUFFER_SIZE 256
 
@@ -56,6 +58,7 @@ enum dictionary_copy_type
 typedef int(*comparator_func)(const void*, const void*); // return 0 on equality
 typedef void(*cleanup_func)(void*);
 typedef uint8_t(*copy_func)(const void*, void*); // src, dst
+typedef void(*merge_func)(void*, const void*); // existing value (dst), incoming value (src)
 
 // TODO check the custom type works (deep and shallow copies)
 typedef struct Dictionary
@@ -78,6 +81,8 @@ typedef struct Dictionary
     uint64_t* hash_seeds; // or salts
     struct dictionary_entry* first_entry;
     struct dictionary_entry** entries;
+
+    const allocator* allocator; // tables, entries and deep-copied keys / values come from here; NULL uses malloc / free (see set_allocator_dictionary)
 } Dictionary;
 
 static inline uint64_t __get_type_size__(const enum dictionary_key_value_type type)
@@ -203,6 +208,16 @@ static inline cleanup_func __get_type_cleanup_func__(const enum dictionary_key_v
     }
 }
 
+/**
+ * @brief Internal use only; zeroed storage for a deep-copied key or value. A String gets the dictionary's allocator for its characters.
+ */
+static inline void* __alloc_item_dictionary__(const Dictionary* const dict, const enum dictionary_key_value_type type, const uint64_t size)
+{
+    void* const item = mem_calloc(dict->allocator, 1, size);
+    if (item != NULL && type == DICTIONARY_KEY_VALUE_TYPE_STRING) ((String*)item)->allocator = dict->allocator;
+    return item;
+}
+
 /**
  * @brief Initialize a pre-allocated Dictionary structure: set metadata, allocate hash seeds and bucket table, and prepare for use.
  * @param dict Pointer to an existing Dictionary object to initialize. The caller must allocate the Dictionary (e.g., with calloc) before calling.
@@ -238,6 +253,7 @@ static inline void set_dictionary(
     dict->array_count = array_count;
     dict->array_size = array_size;
     dict->first_entry = NULL;
+    dict->allocator = NULL;
 
     // Makes sure is valid
     switch (copy_type)
@@ -319,6 +335,34 @@ static inline Dictionary* new_dictionary_default(const enum dictionary_key_value
     return new_dictionary(8, 256, DICTIONARY_HASH_FUNCTION_DEFAULT, key_type, value_type, DICTIONARY_DEEP_COPY, 0, 0, NULL, NULL, NULL, NULL);
 }
 
+/**
+ * @brief Routes the dictionary's tables, entries and deep-copied keys / values through @p alloc (NULL uses malloc / free).
+ *        String keys / values also take their character buffers from it. Only valid while the dictionary is empty.
+ * @return 0 on success, 1 if the dictionary holds entries or on allocation error (the dictionary is unchanged).
+ */
+static inline uint8_t set_allocator_dictionary(Dictionary* const dict, const allocator* const alloc)
+{
+    if (dict->first_entry != NULL) return 1;
+
+    const uint64_t table_count = (uint64_t)dict->array_count * dict->array_size;
+    uint64_t* const hash_seeds = (uint64_t*)mem_calloc(alloc, dict->array_count, sizeof(uint64_t));
+    struct dictionary_entry** const entries = (struct dictionary_entry**)mem_calloc(alloc, table_count, sizeof(struct dictionary_entry*));
+    if (hash_seeds == NULL || entries == NULL)
+    {
+        mem_free(alloc, entries, table_count * sizeof(struct dictionary_entry*));
+        mem_free(alloc, hash_seeds, dict->array_count * sizeof(uint64_t));
+        return 1;
+    }
+    if (dict->hash_seeds != NULL) memcpy(hash_seeds, dict->hash_seeds, dict->array_count * sizeof(uint64_t));
+
+    mem_free(dict->allocator, dict->entries, table_count * sizeof(struct dictionary_entry*));
+    mem_free(dict->allocator, dict->hash_seeds, dict->array_count * sizeof(uint64_t));
+    dict->hash_seeds = hash_seeds;
+    dict->entries = entries;
+    dict->allocator = alloc;
+    return 0;
+}
+
 static inline uint64_t compute_hash(const enum dictionary_hash_function hash_function, const uint64_t seed, const dyn_array* const key)
 {
     switch (hash_function)
@@ -365,7 +409,7 @@ static inline dyn_array* __dictionary_key_to_dyn_array__(const enum dictionary_k
         case DICTIONARY_KEY_VALUE_TYPE_VECTOR_3:
 			return vector3_to_dyn_array((vector3*)key);
 		case DICTIONARY_KEY_VALUE_TYPE_VECTOR_4:
-			return vector3_to_dyn_array((vector3*)key);
+			return vector4_to_dyn_array((vector4*)key);
 		case DICTIONARY_KEY_VALUE_TYPE_MATRIX_2X2:
 			return matrix_2x2_to_dyn_array((matrix_2x2*)key);
 		case DICTIONARY_KEY_VALUE_TYPE_MATRIX_3X3:
@@ -384,6 +428,31 @@ static inline dyn_array* __dictionary_key_to_dyn_array__(const enum dictionary_k
     }
 }
 
+/**
+ * Points a stack dyn_array at the raw bytes of a key so it can be hashed without allocating or copying.
+ * @param key_view The dyn_array to set; it borrows the key's memory and must NOT be cleaned or freed.
+ * @param key_type The type of the key.
+ * @param key Pointer to the key.
+ * @param key_size Byte size of the key (ignored for DICTIONARY_KEY_VALUE_TYPE_STRING).
+ * @warning Hashes the same bytes as __dictionary_key_to_dyn_array__(), so both produce identical digests.
+ */
+static inline void __set_dictionary_key_view__(dyn_array* const key_view, const enum dictionary_key_value_type key_type, const void* const key, const uint64_t key_size)
+{
+    if (key_type == DICTIONARY_KEY_VALUE_TYPE_STRING)
+    {
+        set_dyn_array(key_view, DYN_ARRAY_CHAR_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+        key_view->data = (void*)getCharArr((const String*)key);
+        key_view->current_size = ((const String*)key)->str_length;
+    }
+    else
+    {
+        set_dyn_array(key_view, DYN_ARRAY_UINT_8T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+        key_view->data = (void*)key;
+        key_view->current_size = key_size;
+    }
+    key_view->max_size = key_view->current_size;
+}
+
 static inline int __ptr_compare__(const void* a, const void* b)
 {
     if (a < b) return -1;
@@ -438,6 +507,61 @@ static inline int __String_compare__(const void* a, const void* b)
     return compareString((const String*)a, (const String*)b);
 }
 
+/**
+ * Compares two raw byte blocks for equality, 16 then 8 bytes at a time before the byte tail.
+ * @return 0 on equality, else 1.
+ * @warning Only equality is meaningful; floats are compared bit-wise (i.e. 0.0f != -0.0f), matching how keys are hashed.
+ */
+static inline int __custom_compare__(const void* a, const void* b, const uint64_t byte_size)
+{
+    const uint8_t* const a_bytes = (const uint8_t*)a;
+    const uint8_t* const b_bytes = (const uint8_t*)b;
+
+    uint64_t i = 0;
+    for (; i + 16 <= byte_size; i += 16)
+    {
+        uint64_t a_words[2], b_words[2];
+        memcpy(a_words, a_bytes + i, 16);
+        memcpy(b_words, b_bytes + i, 16);
+        if ((a_words[0] ^ b_words[0]) | (a_words[1] ^ b_words[1])) return 1;
+    }
+    if (i + 8 <= byte_size)
+    {
+        uint64_t a_word, b_word;
+        memcpy(&a_word, a_bytes + i, 8);
+        memcpy(&b_word, b_bytes + i, 8);
+        if (a_word ^ b_word) return 1;
+        i += 8;
+    }
+    if (i + 4 <= byte_size)
+    {
+        uint32_t a_word, b_word;
+        memcpy(&a_word, a_bytes + i, 4);
+        memcpy(&b_word, b_bytes + i, 4);
+        if (a_word ^ b_word) return 1;
+        i += 4;
+    }
+    for (; i < byte_size; i++)
+    {
+        if (a_bytes[i] != b_bytes[i]) return 1;
+    }
+    return 0;
+}
+
+// Fixed-width wrappers so the byte loop above is fully unrolled for each vector/matrix size
+static inline int __vector_2_compare__(const void* a, const void* b)
+{ return __custom_compare__(a, b, sizeof(vector2)); }
+static inline int __vector_3_compare__(const void* a, const void* b)
+{ return __custom_compare__(a, b, sizeof(vector3)); }
+static inline int __vector_4_compare__(const void* a, const void* b)
+{ return __custom_compare__(a, b, sizeof(vector4)); }
+static inline int __matrix_2x2_compare__(const void* a, const void* b)
+{ return __custom_compare__(a, b, sizeof(matrix_2x2)); }
+static inline int __matrix_3x3_compare__(const void* a, const void* b)
+{ return __custom_compare__(a, b, sizeof(matrix_3x3)); }
+static inline int __matrix_4x4_compare__(const void* a, const void* b)
+{ return __custom_compare__(a, b, sizeof(matrix_4x4)); }
+
 static inline comparator_func __get_dictionary_key_compare_function__(const enum dictionary_key_value_type key_type)
 {
     switch (key_type)
@@ -456,22 +580,23 @@ static inline comparator_func __get_dictionary_key_compare_function__(const enum
             return &__uint32_t_compare__;
         case DICTIONARY_KEY_VALUE_TYPE_UINT64_T:
             return &__uint64_t_compare__;
+        case DICTIONARY_KEY_VALUE_TYPE_VECTOR_2:
+            return &__vector_2_compare__;
+        case DICTIONARY_KEY_VALUE_TYPE_VECTOR_3:
+            return &__vector_3_compare__;
+        case DICTIONARY_KEY_VALUE_TYPE_VECTOR_4:
+            return &__vector_4_compare__;
+        case DICTIONARY_KEY_VALUE_TYPE_MATRIX_2X2:
+            return &__matrix_2x2_compare__;
+        case DICTIONARY_KEY_VALUE_TYPE_MATRIX_3X3:
+            return &__matrix_3x3_compare__;
+        case DICTIONARY_KEY_VALUE_TYPE_MATRIX_4X4:
+            return &__matrix_4x4_compare__;
         default:
             return &__ptr_compare__;
     }
 }
 
-static inline int __custom_compare__(const void* a, const void* b, const uint64_t byte_size)
-{
-    for (int i = 0; i < byte_size; i++)
-    {
-        const uint8_t a = ((uint8_t*)a)[i];
-        const uint8_t b = ((uint8_t*)b)[i];
-        if (a - b) return (a > b) - (a < b);
-    }
-    return 0;
-}
-
 /**
  * Retrieves the value associated with a given key in the dictionary.
  * @param dict Pointer to the dictionary.
@@ -480,14 +605,15 @@ static inline int __custom_compare__(const void* a, const void* b, const uint64_
  */
 static inline void* get_value_dictionary(const Dictionary* const dict, const void* const key)
 {
-    dyn_array* const key_array = __dictionary_key_to_dyn_array__(dict->key_type, key, dict->key_size);
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, dict->key_type, key, dict->key_size);
     if (dict->key_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM)
     {
         const uint64_t custom_key_size = dict->key_size;
         
         for (int i = 0; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
     
             struct dictionary_entry* entry = dict->entries[entry_index];
@@ -495,7 +621,6 @@ static inline void* get_value_dictionary(const Dictionary* const dict, const voi
             {
                 if (__custom_compare__(entry->key, key, custom_key_size) == 0)
                 {
-                    free_dyn_array(key_array);
                     return entry->value;
                 }
                 entry = entry->next_in_bucket;
@@ -508,7 +633,7 @@ static inline void* get_value_dictionary(const Dictionary* const dict, const voi
         
         for (int i = 0; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
     
             struct dictionary_entry* entry = dict->entries[entry_index];
@@ -516,7 +641,6 @@ static inline void* get_value_dictionary(const Dictionary* const dict, const voi
             {
                 if (key_compare_func(entry->key, key) == 0)
                 {
-                    free_dyn_array(key_array);
                     return entry->value;
                 }
                 entry = entry->next_in_bucket;
@@ -524,7 +648,6 @@ static inline void* get_value_dictionary(const Dictionary* const dict, const voi
         }
     }
 
-    free_dyn_array(key_array);
     return NULL;
 }
 
@@ -541,9 +664,10 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
     uint8_t return_code = 0;
 
     // Implementation for inserting key-value pair
-    dyn_array* const key_array = __dictionary_key_to_dyn_array__(dict->key_type, key, dict->key_size);
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, dict->key_type, key, dict->key_size);
 
-    struct dictionary_entry* new_entry = (struct dictionary_entry*)calloc(1, sizeof(struct dictionary_entry));
+    struct dictionary_entry* new_entry = (struct dictionary_entry*)mem_calloc(dict->allocator, 1, sizeof(struct dictionary_entry));
     if (dict->copy_type == DICTIONARY_SHALLOW_COPY)
     {
         new_entry->key = (void*)key;
@@ -551,13 +675,13 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
     }
     else
     {
-        new_entry->key = calloc(1, dict->key_size);
+        new_entry->key = __alloc_item_dictionary__(dict, dict->key_type, dict->key_size);
         if (new_entry->key == NULL) 
             return_code = 2;
         else 
             dict->key_copy_func(key, new_entry->key);
         
-        new_entry->value = calloc(1, dict->value_size);
+        new_entry->value = __alloc_item_dictionary__(dict, dict->value_type, dict->value_size);
         if (new_entry->value == NULL) 
             return_code = 2;
         else 
@@ -576,7 +700,7 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
         
         for (int i = 0; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
 
             // Count entries in this bucket
@@ -609,7 +733,7 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
 
         for (int i = 0; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
 
             // Count entries in this bucket
@@ -658,8 +782,6 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
 
         added_entry = 1;
     }
-    
-    free_dyn_array(key_array);
 
     if (added_entry)
     {
@@ -674,7 +796,21 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
     if (return_code == 0) return return_code;
     // Error occurred; was not inserted, need to delete alocated memory
 
-    free(new_entry);
+    if (dict->copy_type == DICTIONARY_DEEP_COPY)
+    {
+        if (new_entry->key != NULL)
+        {
+            dict->key_cleanup_func(new_entry->key);
+            mem_free(dict->allocator, new_entry->key, dict->key_size);
+        }
+        if (new_entry->value != NULL)
+        {
+            dict->value_cleanup_func(new_entry->value);
+            mem_free(dict->allocator, new_entry->value, dict->value_size);
+        }
+    }
+    mem_free(dict->allocator, new_entry, sizeof(struct dictionary_entry));
+    return return_code;
 }
 
 /**
@@ -686,7 +822,8 @@ static inline uint8_t insert_key_value_pair_dictionary(Dictionary* const dict, c
  */
 static inline uint8_t set_value_dictionary(const Dictionary* const dict, const void* const key, const void* const value)
 {
-    dyn_array* const key_array = __dictionary_key_to_dyn_array__(dict->key_type, key, dict->key_size);
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, dict->key_type, key, dict->key_size);
 
     uint8_t key_found = 0;
     uint8_t return_code = 2;
@@ -698,7 +835,7 @@ static inline uint8_t set_value_dictionary(const Dictionary* const dict, const v
 
         for (; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
     
             struct dictionary_entry* entry = dict->entries[entry_index];
@@ -733,7 +870,7 @@ static inline uint8_t set_value_dictionary(const Dictionary* const dict, const v
 
         for (; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
     
             struct dictionary_entry* entry = dict->entries[entry_index];
@@ -767,10 +904,140 @@ static inline uint8_t set_value_dictionary(const Dictionary* const dict, const v
         return_code = 1;
     }
 
-    free_dyn_array(key_array);
     return return_code;
 }
 
+/**
+ * Finds the entry for a key, or adds a new entry for it, walking each bucket chain exactly once.
+ * Internal use only
+ * @param dict Pointer to the dictionary.
+ * @param key Pointer to the key.
+ * @param inserted Set to 1 if a new entry was added, else 0.
+ * @return The found or new entry, or NULL on allocation failure. New entries have a zeroed value (deep copy) or a NULL value pointer (shallow copy).
+ */
+static inline struct dictionary_entry* __find_or_add_entry_dictionary__(Dictionary* const dict, const void* const key, uint8_t* const inserted)
+{
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, dict->key_type, key, dict->key_size);
+
+    const comparator_func key_compare_func = (dict->key_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM) 
+        ? NULL 
+        : __get_dictionary_key_compare_function__(dict->key_type);
+
+    uint64_t min_entry_stack = 0;
+    uint64_t min_entry_index = 0;
+
+    for (int i = 0; i < dict->array_count; i++)
+    {
+        const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
+        const uint64_t entry_index = i * dict->array_size + index;
+
+        uint64_t entry_stack = 0;
+        struct dictionary_entry* entry = dict->entries[entry_index];
+        while (entry != NULL)
+        {
+            const int compare = (key_compare_func == NULL) 
+                ? __custom_compare__(entry->key, key, dict->key_size) 
+                : key_compare_func(entry->key, key);
+            if (compare == 0)
+            {
+                *inserted = 0;
+                return entry;
+            }
+
+            entry_stack++;
+            entry = entry->next_in_bucket;
+        }
+
+        if (entry_stack < min_entry_stack || i == 0)
+        {
+            min_entry_stack = entry_stack;
+            min_entry_index = entry_index;
+        }
+    }
+
+    struct dictionary_entry* const new_entry = (struct dictionary_entry*)mem_calloc(dict->allocator, 1, sizeof(struct dictionary_entry));
+    if (new_entry == NULL) return NULL;
+
+    if (dict->copy_type == DICTIONARY_SHALLOW_COPY)
+    {
+        new_entry->key = (void*)key;
+        new_entry->value = NULL;
+    }
+    else
+    {
+        new_entry->key = __alloc_item_dictionary__(dict, dict->key_type, dict->key_size);
+        new_entry->value = __alloc_item_dictionary__(dict, dict->value_type, dict->value_size);
+        if (new_entry->key == NULL || new_entry->value == NULL)
+        {
+            mem_free(dict->allocator, new_entry->key, dict->key_size);
+            mem_free(dict->allocator, new_entry->value, dict->value_size);
+            mem_free(dict->allocator, new_entry, sizeof(struct dictionary_entry));
+            return NULL;
+        }
+        dict->key_copy_func(key, new_entry->key);
+        if (dict->value_type == DICTIONARY_KEY_VALUE_TYPE_STRING) writeCharsN((String*)new_entry->value, "", 0);
+    }
+
+    // Insert into the least filled bucket
+    new_entry->next_in_bucket = dict->entries[min_entry_index];
+    if (dict->entries[min_entry_index] != NULL) dict->entries[min_entry_index]->prev_in_bucket = new_entry;
+    dict->entries[min_entry_index] = new_entry;
+
+    new_entry->next_entry = dict->first_entry;
+    if (dict->first_entry != NULL) dict->first_entry->prev_entry = new_entry;
+    dict->first_entry = new_entry;
+
+    *inserted = 1;
+    return new_entry;
+}
+
+/**
+ * Returns the value slot for a key, inserting the key first if it is not present (one hash-and-probe pass).
+ * @param dict Pointer to the dictionary.
+ * @param key Pointer to the key.
+ * @param inserted Optional; set to 1 if the key was inserted, else 0.
+ * @return For DICTIONARY_DEEP_COPY, a pointer to the stored value (zero-initialised when just inserted; an empty String for String values).
+ *         For DICTIONARY_SHALLOW_COPY, a pointer to the stored value pointer (i.e. a void**; NULL when just inserted) so the caller can point it at their own value.
+ *         Returns NULL on allocation failure.
+ */
+static inline void* find_or_insert_dictionary(Dictionary* const dict, const void* const key, uint8_t* const inserted)
+{
+    uint8_t was_inserted = 0;
+    struct dictionary_entry* const entry = __find_or_add_entry_dictionary__(dict, key, &was_inserted);
+    if (inserted != NULL) *inserted = was_inserted;
+    if (entry == NULL) return NULL;
+
+    return (dict->copy_type == DICTIONARY_SHALLOW_COPY) ? (void*)&entry->value : entry->value;
+}
+
+/**
+ * Inserts a key-value pair, or merges the value into the existing one if the key is present (one hash-and-probe pass).
+ * @param dict Pointer to the dictionary.
+ * @param key Pointer to the key.
+ * @param value Pointer to the value.
+ * @param merge Called as merge(existing_value, value) when the key is present. If NULL, the existing value is overwritten like set_value_dictionary().
+ * @return Returns 0 if inserted, 1 if merged into an existing value, 2 on allocation failure.
+ */
+static inline uint8_t upsert_dictionary(Dictionary* const dict, const void* const key, const void* const value, const merge_func merge)
+{
+    uint8_t inserted = 0;
+    struct dictionary_entry* const entry = __find_or_add_entry_dictionary__(dict, key, &inserted);
+    if (entry == NULL) return 2;
+
+    if (inserted || merge == NULL)
+    {
+        if (dict->copy_type == DICTIONARY_SHALLOW_COPY)
+            entry->value = (void*)value;
+        else
+            dict->value_copy_func(value, entry->value);
+        return inserted ? 0 : 1;
+    }
+
+    merge(entry->value, value);
+    return 1;
+}
+
 /**
  * Deletes a key-value pair from the dictionary by key.
  * @param dict Pointer to the dictionary.
@@ -780,7 +1047,8 @@ static inline void delete_key_value_pair_dictionary(Dictionary* const dict, cons
 {
     // Implementation for deleting key-value pair by key
     // Note: This is a simplified version and does not handle all edge cases
-    dyn_array* const key_array = __dictionary_key_to_dyn_array__(dict->key_type, key, dict->key_size);
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, dict->key_type, key, dict->key_size);
 
     if (dict->key_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM)
     {
@@ -788,7 +1056,7 @@ static inline void delete_key_value_pair_dictionary(Dictionary* const dict, cons
 
         for (int i = 0; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
     
             struct dictionary_entry* entry = dict->entries[entry_index];
@@ -827,12 +1095,11 @@ static inline void delete_key_value_pair_dictionary(Dictionary* const dict, cons
                     if (dict->copy_type == DICTIONARY_DEEP_COPY)
                     {
                         dict->key_cleanup_func(entry->key);
-                        free(entry->key);
+                        mem_free(dict->allocator, entry->key, dict->key_size);
                         dict->value_cleanup_func(entry->value);
-                        free(entry->value);
+                        mem_free(dict->allocator, entry->value, dict->value_size);
                     }
-                    free(entry);
-                    free_dyn_array(key_array);
+                    mem_free(dict->allocator, entry, sizeof(struct dictionary_entry));
                     return;
                 }
                 entry = entry->next_in_bucket;
@@ -845,7 +1112,7 @@ static inline void delete_key_value_pair_dictionary(Dictionary* const dict, cons
 
         for (int i = 0; i < dict->array_count; i++)
         {
-            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], key_array);
+            const uint64_t index = compute_index_in_dictionary(dict->hash_function, dict->array_size, dict->hash_seeds[i], &key_view);
             const uint64_t entry_index = i * dict->array_size + index;
     
             struct dictionary_entry* entry = dict->entries[entry_index];
@@ -884,12 +1151,11 @@ static inline void delete_key_value_pair_dictionary(Dictionary* const dict, cons
                     if (dict->copy_type == DICTIONARY_DEEP_COPY)
                     {
                         dict->key_cleanup_func(entry->key);
-                        free(entry->key);
+                        mem_free(dict->allocator, entry->key, dict->key_size);
                         dict->value_cleanup_func(entry->value);
-                        free(entry->value);
+                        mem_free(dict->allocator, entry->value, dict->value_size);
                     }
-                    free(entry);
-                    free_dyn_array(key_array);
+                    mem_free(dict->allocator, entry, sizeof(struct dictionary_entry));
                     return;
                 }
                 entry = entry->next_in_bucket;
@@ -897,7 +1163,6 @@ static inline void delete_key_value_pair_dictionary(Dictionary* const dict, cons
         }
     }
 
-    free_dyn_array(key_array);
 }
 
 /**
@@ -1000,7 +1265,7 @@ static inline String* get_dictionary_entries_key_values_string(const Dictionary*
 
 static inline void clean_dictionary(Dictionary* const dict)
 {
-    if (dict->hash_seeds != NULL) free(dict->hash_seeds);
+    if (dict->hash_seeds != NULL) mem_free(dict->allocator, dict->hash_seeds, dict->array_count * sizeof(uint64_t));
     dict->hash_seeds = NULL;
 
     if (dict->entries != NULL)
@@ -1012,15 +1277,15 @@ static inline void clean_dictionary(Dictionary* const dict)
             if (dict->copy_type == DICTIONARY_DEEP_COPY)
             {
                 dict->key_cleanup_func(entry->key);
-                free(entry->key);
+                mem_free(dict->allocator, entry->key, dict->key_size);
                 dict->value_cleanup_func(entry->value);
-                free(entry->value);
+                mem_free(dict->allocator, entry->value, dict->value_size);
             }
 
-            free(entry);
+            mem_free(dict->allocator, entry, sizeof(struct dictionary_entry));
             entry = next_entry;
         }
-        free(dict->entries);
+        mem_free(dict->allocator, dict->entries, dict->array_count * dict->array_size * sizeof(struct dictionary_entry*));
     }
     dict->entries = NULL;
 }
@@ -0,0 +1,656 @@
+#ifndef PERSISTENT_DICTIONARY_H
+#define PERSISTENT_DICTIONARY_H
+
+#include "dictionary.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#define PERSISTENT_DICTIONARY_BITS_PER_LEVEL 5
+#define PERSISTENT_DICTIONARY_LEVEL_MASK 31
+#define PERSISTENT_DICTIONARY_MAX_DEPTH 13 // 13 levels of 5 bits cover the 64-bit hash; keys with equal hashes then share a collision node
+#define PERSISTENT_DICTIONARY_HASH_SEED XXH3_SEED_DEFAULT
+
+/*
+    A PersistentDictionary is a hash array mapped trie (HAMT) with structural sharing.
+    Nodes are immutable once built: an update copies only the nodes on the path from the root to the changed leaf
+    and shares every other subtree with the previous version. Taking a snapshot therefore only adds a reference to the root.
+    Nodes are reference counted (atomically), so readers can keep using a snapshot on another thread while the writer continues,
+    and a version's nodes are reclaimed once the last handle referencing them is freed.
+*/
+
+enum persistent_dictionary_node_type
+{
+    PERSISTENT_DICTIONARY_NODE_BRANCH,
+    PERSISTENT_DICTIONARY_NODE_LEAF,
+    PERSISTENT_DICTIONARY_NODE_COLLISION, // leaves whose full 64-bit hashes are equal
+};
+
+struct persistent_dictionary_node
+{
+    atomic_uint_fast32_t ref_count;
+    enum persistent_dictionary_node_type type;
+    uint32_t bitmap;      // BRANCH: which of the 32 slots at this level are present
+    uint32_t child_count; // BRANCH, COLLISION
+    uint64_t hash;        // LEAF, COLLISION
+    void* key;            // LEAF
+    void* value;          // LEAF
+    struct persistent_dictionary_node* children[]; // BRANCH (ordered by slot), COLLISION (leaves)
+};
+
+typedef struct PersistentDictionary
+{
+    enum dictionary_hash_function hash_function;
+    enum dictionary_key_value_type key_type;
+    enum dictionary_key_value_type value_type;
+    enum dictionary_copy_type copy_type;
+
+    uint64_t key_size;
+    uint64_t value_size;
+    copy_func key_copy_func;
+    copy_func value_copy_func;
+    cleanup_func key_cleanup_func;
+    cleanup_func value_cleanup_func;
+    comparator_func key_compare_func; // NULL for DICTIONARY_KEY_VALUE_TYPE_CUSTOM (compared with __custom_compare__)
+
+    uint64_t count;
+    struct persistent_dictionary_node* root; // NULL when empty
+} PersistentDictionary;
+
+/**
+ * @brief Initialize a pre-allocated, empty PersistentDictionary.
+ * @see set_dictionary() for the parameters; there are no bucket arrays, so no array count or size is needed.
+ */
+static inline void set_persistent_dictionary(
+    PersistentDictionary* const dict,
+    const enum dictionary_hash_function hash_function,
+    const enum dictionary_key_value_type key_type,
+    const enum dictionary_key_value_type value_type,
+    const enum dictionary_copy_type copy_type,
+    const uint64_t custom_key_size,
+    const uint64_t custom_value_size,
+    const copy_func custom_key_copy_func,
+    const copy_func custom_value_copy_func,
+    const cleanup_func custom_key_cleanup_func,
+    const cleanup_func custom_value_cleanup_func
+) {
+    dict->hash_function = hash_function;
+    dict->key_type = key_type;
+    dict->value_type = value_type;
+    dict->copy_type = (copy_type == DICTIONARY_DEEP_COPY) ? DICTIONARY_DEEP_COPY : DICTIONARY_SHALLOW_COPY;
+    dict->count = 0;
+    dict->root = NULL;
+
+    if (dict->key_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM)
+    {
+        dict->key_size = custom_key_size;
+        dict->key_copy_func = custom_key_copy_func;
+        dict->key_cleanup_func = custom_key_cleanup_func;
+        dict->key_compare_func = NULL;
+    }
+    else
+    {
+        dict->key_size = __get_type_size__(dict->key_type);
+        dict->key_copy_func = __get_copy_func__(dict->key_type);
+        dict->key_cleanup_func = __get_type_cleanup_func__(dict->key_type);
+        dict->key_compare_func = __get_dictionary_key_compare_function__(dict->key_type);
+    }
+
+    if (dict->value_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM)
+    {
+        dict->value_size = custom_value_size;
+        dict->value_copy_func = custom_value_copy_func;
+        dict->value_cleanup_func = custom_value_cleanup_func;
+    }
+    else
+    {
+        dict->value_size = __get_type_size__(dict->value_type);
+        dict->value_copy_func = __get_copy_func__(dict->value_type);
+        dict->value_cleanup_func = __get_type_cleanup_func__(dict->value_type);
+    }
+}
+
+static inline PersistentDictionary* new_persistent_dictionary(
+    const enum dictionary_hash_function hash_function,
+    const enum dictionary_key_value_type key_type,
+    const enum dictionary_key_value_type value_type,
+    const enum dictionary_copy_type copy_type,
+    const uint64_t custom_key_size,
+    const uint64_t custom_value_size,
+    const copy_func custom_key_copy_func,
+    const copy_func custom_value_copy_func,
+    const cleanup_func custom_key_cleanup_func,
+    const cleanup_func custom_value_cleanup_func
+) {
+    PersistentDictionary* const dict = (PersistentDictionary*)calloc(1, sizeof(PersistentDictionary));
+    set_persistent_dictionary(dict, hash_function, key_type, value_type, copy_type,
+        custom_key_size, custom_value_size, custom_key_copy_func, custom_value_copy_func, custom_key_cleanup_func, custom_value_cleanup_func);
+    return dict;
+}
+
+/**
+ * @brief creates a new deep-copying persistent dictionary, can not call DICTIONARY_KEY_VALUE_TYPE_CUSTOM for either type.
+ */
+static inline PersistentDictionary* new_persistent_dictionary_default(const enum dictionary_key_value_type key_type, const enum dictionary_key_value_type value_type)
+{
+    if (key_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM || value_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM)
+    {
+        return NULL;
+    }
+
+    return new_persistent_dictionary(DICTIONARY_HASH_FUNCTION_DEFAULT, key_type, value_type, DICTIONARY_DEEP_COPY, 0, 0, NULL, NULL, NULL, NULL);
+}
+
+// Internal use only
+static inline uint32_t __popcount_32__(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555U);
+    x = (x & 0x33333333U) + ((x >> 2) & 0x33333333U);
+    return (((x + (x >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+#endif
+}
+
+// Internal use only
+static inline uint32_t __level_index_persistent_dictionary__(const uint64_t hash, const uint32_t depth)
+{
+    return (uint32_t)(hash >> (depth * PERSISTENT_DICTIONARY_BITS_PER_LEVEL)) & PERSISTENT_DICTIONARY_LEVEL_MASK;
+}
+
+// Internal use only
+static inline uint64_t __hash_key_persistent_dictionary__(const PersistentDictionary* const dict, const void* const key)
+{
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, dict->key_type, key, dict->key_size);
+    return compute_hash(dict->hash_function, PERSISTENT_DICTIONARY_HASH_SEED, &key_view);
+}
+
+// Internal use only
+static inline int __key_compare_persistent_dictionary__(const PersistentDictionary* const dict, const void* const a, const void* const b)
+{
+    return (dict->key_compare_func == NULL) ? __custom_compare__(a, b, dict->key_size) : dict->key_compare_func(a, b);
+}
+
+// Internal use only
+static inline struct persistent_dictionary_node* __alloc_node_persistent_dictionary__(const enum persistent_dictionary_node_type type, const uint32_t child_count)
+{
+    struct persistent_dictionary_node* const node = (struct persistent_dictionary_node*)calloc(1,
+        sizeof(struct persistent_dictionary_node) + child_count * sizeof(struct persistent_dictionary_node*));
+    if (node == NULL) return NULL;
+
+    atomic_init(&node->ref_count, 1);
+    node->type = type;
+    node->child_count = child_count;
+    return node;
+}
+
+// Internal use only
+static inline struct persistent_dictionary_node* __retain_node_persistent_dictionary__(struct persistent_dictionary_node* const node)
+{
+    if (node != NULL) atomic_fetch_add_explicit(&node->ref_count, 1, memory_order_relaxed);
+    return node;
+}
+
+// Internal use only; frees the node (and recursively releases its children) once the last reference is dropped
+static inline void __release_node_persistent_dictionary__(const PersistentDictionary* const dict, struct persistent_dictionary_node* const node)
+{
+    if (node == NULL) return;
+    if (atomic_fetch_sub_explicit(&node->ref_count, 1, memory_order_acq_rel) != 1) return;
+
+    if (node->type == PERSISTENT_DICTIONARY_NODE_LEAF)
+    {
+        if (dict->copy_type == DICTIONARY_DEEP_COPY)
+        {
+            dict->key_cleanup_func(node->key);
+            free(node->key);
+            dict->value_cleanup_func(node->value);
+            free(node->value);
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < node->child_count; i++)
+        {
+            __release_node_persistent_dictionary__(dict, node->children[i]);
+        }
+    }
+    free(node);
+}
+
+// Internal use only
+static inline struct persistent_dictionary_node* __new_leaf_persistent_dictionary__(const PersistentDictionary* const dict, const uint64_t hash, const void* const key, const void* const value)
+{
+    struct persistent_dictionary_node* const leaf = __alloc_node_persistent_dictionary__(PERSISTENT_DICTIONARY_NODE_LEAF, 0);
+    if (leaf == NULL) return NULL;
+    leaf->hash = hash;
+
+    if (dict->copy_type == DICTIONARY_SHALLOW_COPY)
+    {
+        leaf->key = (void*)key;
+        leaf->value = (void*)value;
+        return leaf;
+    }
+
+    leaf->key = calloc(1, dict->key_size);
+    leaf->value = calloc(1, dict->value_size);
+    if (leaf->key == NULL || leaf->value == NULL)
+    {
+        free(leaf->key);
+        free(leaf->value);
+        free(leaf);
+        return NULL;
+    }
+    dict->key_copy_func(key, leaf->key);
+    dict->value_copy_func(value, leaf->value);
+    return leaf;
+}
+
+// Internal use only; builds the smallest subtree holding two leaves (both references are taken over)
+static inline struct persistent_dictionary_node* __join_leaves_persistent_dictionary__(struct persistent_dictionary_node* const first, struct persistent_dictionary_node* const second, const uint32_t depth)
+{
+    if (first->hash == second->hash || depth >= PERSISTENT_DICTIONARY_MAX_DEPTH)
+    {
+        struct persistent_dictionary_node* const collision = __alloc_node_persistent_dictionary__(PERSISTENT_DICTIONARY_NODE_COLLISION, 2);
+        if (collision == NULL) return NULL;
+        collision->hash = first->hash;
+        collision->children[0] = first;
+        collision->children[1] = second;
+        return collision;
+    }
+
+    const uint32_t first_index = __level_index_persistent_dictionary__(first->hash, depth);
+    const uint32_t second_index = __level_index_persistent_dictionary__(second->hash, depth);
+
+    if (first_index == second_index)
+    {
+        struct persistent_dictionary_node* const branch = __alloc_node_persistent_dictionary__(PERSISTENT_DICTIONARY_NODE_BRANCH, 1);
+        if (branch == NULL) return NULL;
+        branch->bitmap = 1u << first_index;
+        branch->children[0] = __join_leaves_persistent_dictionary__(first, second, depth + 1);
+        if (branch->children[0] == NULL) { free(branch); return NULL; }
+        return branch;
+    }
+
+    struct persistent_dictionary_node* const branch = __alloc_node_persistent_dictionary__(PERSISTENT_DICTIONARY_NODE_BRANCH, 2);
+    if (branch == NULL) return NULL;
+    branch->bitmap = (1u << first_index) | (1u << second_index);
+    branch->children[(first_index < second_index) ? 0 : 1] = first;
+    branch->children[(first_index < second_index) ? 1 : 0] = second;
+    return branch;
+}
+
+// Internal use only; returns a copy of `node` whose child at `position` is replaced (or inserted / removed), sharing every other child
+static inline struct persistent_dictionary_node* __copy_with_child_persistent_dictionary__(
+    const struct persistent_dictionary_node* const node,
+    const uint32_t position,
+    struct persistent_dictionary_node* const child, // NULL to remove
+    const uint8_t insert,
+    const uint32_t new_bitmap
+) {
+    const uint32_t new_count = node->child_count + (insert ? 1 : 0) - (child == NULL ? 1 : 0);
+    struct persistent_dictionary_node* const copy = __alloc_node_persistent_dictionary__(node->type, new_count);
+    if (copy == NULL) return NULL;
+    copy->bitmap = new_bitmap;
+    copy->hash = node->hash;
+
+    uint32_t c = 0;
+    for (uint32_t i = 0; i < node->child_count; i++)
+    {
+        if (i == position)
+        {
+            if (insert) copy->children[c++] = child;
+            if (child == NULL) continue;
+            if (!insert) { copy->children[c++] = child; continue; }
+        }
+        copy->children[c++] = __retain_node_persistent_dictionary__(node->children[i]);
+    }
+    if (insert && position == node->child_count) copy->children[c++] = child;
+    return copy;
+}
+
+// Internal use only
+enum __persistent_dictionary_assoc_mode__
+{
+    __PERSISTENT_DICTIONARY_INSERT__, // fail if the key exists
+    __PERSISTENT_DICTIONARY_SET__,    // fail if the key is missing
+    __PERSISTENT_DICTIONARY_PUT__,    // insert or replace
+};
+
+/*
+    Internal use only
+    Returns the new version of `node` with the leaf added/replaced, or `node` itself (unretained) if nothing changed.
+    *status: 0 added, 1 replaced, 2 key exists (INSERT), 3 key missing (SET), 4 allocation failure
+*/
+static inline struct persistent_dictionary_node* __assoc_persistent_dictionary__(
+    const PersistentDictionary* const dict,
+    struct persistent_dictionary_node* const node,
+    const uint32_t depth,
+    const uint64_t hash,
+    const void* const key,
+    const void* const value,
+    const enum __persistent_dictionary_assoc_mode__ mode,
+    uint8_t* const status
+) {
+    if (node == NULL)
+    {
+        if (mode == __PERSISTENT_DICTIONARY_SET__) { *status = 3; return NULL; }
+        struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+        *status = (leaf == NULL) ? 4 : 0;
+        return leaf;
+    }
+
+    switch (node->type)
+    {
+        case PERSISTENT_DICTIONARY_NODE_LEAF:
+        {
+            if (node->hash == hash && __key_compare_persistent_dictionary__(dict, node->key, key) == 0)
+            {
+                if (mode == __PERSISTENT_DICTIONARY_INSERT__) { *status = 2; return node; }
+                struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+                *status = (leaf == NULL) ? 4 : 1;
+                return (leaf == NULL) ? node : leaf;
+            }
+            if (mode == __PERSISTENT_DICTIONARY_SET__) { *status = 3; return node; }
+
+            struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+            if (leaf == NULL) { *status = 4; return node; }
+            struct persistent_dictionary_node* const joined = __join_leaves_persistent_dictionary__(__retain_node_persistent_dictionary__(node), leaf, depth);
+            if (joined == NULL)
+            {
+                __release_node_persistent_dictionary__(dict, node);
+                __release_node_persistent_dictionary__(dict, leaf);
+                *status = 4;
+                return node;
+            }
+            *status = 0;
+            return joined;
+        }
+        case PERSISTENT_DICTIONARY_NODE_COLLISION:
+        {
+            if (node->hash != hash)
+            {
+                if (mode == __PERSISTENT_DICTIONARY_SET__) { *status = 3; return node; }
+
+                struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+                if (leaf == NULL) { *status = 4; return node; }
+                struct persistent_dictionary_node* const joined = __join_leaves_persistent_dictionary__(__retain_node_persistent_dictionary__(node), leaf, depth);
+                if (joined == NULL)
+                {
+                    __release_node_persistent_dictionary__(dict, node);
+                    __release_node_persistent_dictionary__(dict, leaf);
+                    *status = 4;
+                    return node;
+                }
+                *status = 0;
+                return joined;
+            }
+
+            for (uint32_t i = 0; i < node->child_count; i++)
+            {
+                if (__key_compare_persistent_dictionary__(dict, node->children[i]->key, key) != 0) continue;
+
+                if (mode == __PERSISTENT_DICTIONARY_INSERT__) { *status = 2; return node; }
+                struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+                if (leaf == NULL) { *status = 4; return node; }
+                struct persistent_dictionary_node* const copy = __copy_with_child_persistent_dictionary__(node, i, leaf, 0, 0);
+                if (copy == NULL) { __release_node_persistent_dictionary__(dict, leaf); *status = 4; return node; }
+                *status = 1;
+                return copy;
+            }
+
+            if (mode == __PERSISTENT_DICTIONARY_SET__) { *status = 3; return node; }
+            struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+            if (leaf == NULL) { *status = 4; return node; }
+            struct persistent_dictionary_node* const copy = __copy_with_child_persistent_dictionary__(node, node->child_count, leaf, 1, 0);
+            if (copy == NULL) { __release_node_persistent_dictionary__(dict, leaf); *status = 4; return node; }
+            *status = 0;
+            return copy;
+        }
+        case PERSISTENT_DICTIONARY_NODE_BRANCH:
+        default:
+        {
+            const uint32_t bit = 1u << __level_index_persistent_dictionary__(hash, depth);
+            const uint32_t position = __popcount_32__(node->bitmap & (bit - 1));
+
+            if ((node->bitmap & bit) == 0)
+            {
+                if (mode == __PERSISTENT_DICTIONARY_SET__) { *status = 3; return node; }
+                struct persistent_dictionary_node* const leaf = __new_leaf_persistent_dictionary__(dict, hash, key, value);
+                if (leaf == NULL) { *status = 4; return node; }
+                struct persistent_dictionary_node* const copy = __copy_with_child_persistent_dictionary__(node, position, leaf, 1, node->bitmap | bit);
+                if (copy == NULL) { __release_node_persistent_dictionary__(dict, leaf); *status = 4; return node; }
+                *status = 0;
+                return copy;
+            }
+
+            struct persistent_dictionary_node* const child = node->children[position];
+            struct persistent_dictionary_node* const new_child = __assoc_persistent_dictionary__(dict, child, depth + 1, hash, key, value, mode, status);
+            if (new_child == child) return node; // unchanged (or failed)
+
+            struct persistent_dictionary_node* const copy = __copy_with_child_persistent_dictionary__(node, position, new_child, 0, node->bitmap);
+            if (copy == NULL) { __release_node_persistent_dictionary__(dict, new_child); *status = 4; return node; }
+            return copy;
+        }
+    }
+}
+
+/*
+    Internal use only
+    Returns the new version of `node` without the key (NULL if it becomes empty), or `node` itself (unretained) if nothing changed.
+    *status: 0 removed, 1 key missing, 4 allocation failure
+*/
+static inline struct persistent_dictionary_node* __dissoc_persistent_dictionary__(
+    const PersistentDictionary* const dict,
+    struct persistent_dictionary_node* const node,
+    const uint32_t depth,
+    const uint64_t hash,
+    const void* const key,
+    uint8_t* const status
+) {
+    if (node == NULL) { *status = 1; return NULL; }
+
+    switch (node->type)
+    {
+        case PERSISTENT_DICTIONARY_NODE_LEAF:
+            if (node->hash == hash && __key_compare_persistent_dictionary__(dict, node->key, key) == 0)
+            {
+                *status = 0;
+                return NULL;
+            }
+            *status = 1;
+            return node;
+        case PERSISTENT_DICTIONARY_NODE_COLLISION:
+            if (node->hash == hash)
+            {
+                for (uint32_t i = 0; i < node->child_count; i++)
+                {
+                    if (__key_compare_persistent_dictionary__(dict, node->children[i]->key, key) != 0) continue;
+
+                    *status = 0;
+                    if (node->child_count == 2) return __retain_node_persistent_dictionary__(node->children[1 - i]);
+
+                    struct persistent_dictionary_node* const copy = __copy_with_child_persistent_dictionary__(node, i, NULL, 0, 0);
+                    if (copy == NULL) { *status = 4; return node; }
+                    return copy;
+                }
+            }
+            *status = 1;
+            return node;
+        case PERSISTENT_DICTIONARY_NODE_BRANCH:
+        default:
+        {
+            const uint32_t bit = 1u << __level_index_persistent_dictionary__(hash, depth);
+            if ((node->bitmap & bit) == 0) { *status = 1; return node; }
+            const uint32_t position = __popcount_32__(node->bitmap & (bit - 1));
+
+            struct persistent_dictionary_node* const child = node->children[position];
+            struct persistent_dictionary_node* const new_child = __dissoc_persistent_dictionary__(dict, child, depth + 1, hash, key, status);
+            if (new_child == child) return node; // unchanged (or failed)
+
+            if (new_child == NULL && node->child_count == 1) return NULL;
+
+            // Collapse a branch left holding a single leaf (or collision node) so lookups stay short
+            if (new_child == NULL && node->child_count == 2 && depth > 0)
+            {
+                struct persistent_dictionary_node* const other = node->children[1 - position];
+                if (other->type != PERSISTENT_DICTIONARY_NODE_BRANCH) return __retain_node_persistent_dictionary__(other);
+            }
+            if (new_child != NULL && new_child->type != PERSISTENT_DICTIONARY_NODE_BRANCH && node->child_count == 1 && depth > 0)
+            {
+                return new_child;
+            }
+
+            const uint32_t new_bitmap = (new_child == NULL) ? (node->bitmap & ~bit) : node->bitmap;
+            struct persistent_dictionary_node* const copy = __copy_with_child_persistent_dictionary__(node, position, new_child, 0, new_bitmap);
+            if (copy == NULL) { __release_node_persistent_dictionary__(dict, new_child); *status = 4; return node; }
+            return copy;
+        }
+    }
+}
+
+// Internal use only
+static inline uint8_t __update_root_persistent_dictionary__(PersistentDictionary* const dict, const void* const key, const void* const value, const enum __persistent_dictionary_assoc_mode__ mode)
+{
+    const uint64_t hash = __hash_key_persistent_dictionary__(dict, key);
+    uint8_t status = 0;
+    struct persistent_dictionary_node* const new_root = __assoc_persistent_dictionary__(dict, dict->root, 0, hash, key, value, mode, &status);
+
+    if (new_root != dict->root)
+    {
+        __release_node_persistent_dictionary__(dict, dict->root);
+        dict->root = new_root;
+    }
+    if (status == 0) dict->count++;
+    return status;
+}
+
+/**
+ * Takes a point-in-time snapshot of the dictionary in O(1); the snapshot and the original then evolve independently.
+ * @param dict Pointer to the persistent dictionary.
+ * @return A new handle sharing every node with @p dict, or NULL on allocation failure.
+ * @warning The caller is responsible for freeing the returned snapshot with free_persistent_dictionary().
+ */
+static inline PersistentDictionary* snapshot_persistent_dictionary(const PersistentDictionary* const dict)
+{
+    PersistentDictionary* const snapshot = (PersistentDictionary*)malloc(sizeof(PersistentDictionary));
+    if (snapshot == NULL) return NULL;
+
+    *snapshot = *dict;
+    __retain_node_persistent_dictionary__(snapshot->root);
+    return snapshot;
+}
+
+/**
+ * Retrieves the value associated with a given key in the dictionary.
+ * @param dict Pointer to the persistent dictionary.
+ * @param key Pointer to the key.
+ * @return Pointer to the value associated with the key, or NULL if the key is not found.
+ * @warning The value is shared with every snapshot that contains it, so it must not be modified in place.
+ */
+static inline const void* get_value_persistent_dictionary(const PersistentDictionary* const dict, const void* const key)
+{
+    const uint64_t hash = __hash_key_persistent_dictionary__(dict, key);
+
+    const struct persistent_dictionary_node* node = dict->root;
+    for (uint32_t depth = 0; node != NULL; depth++)
+    {
+        switch (node->type)
+        {
+            case PERSISTENT_DICTIONARY_NODE_LEAF:
+                if (node->hash == hash && __key_compare_persistent_dictionary__(dict, node->key, key) == 0) return node->value;
+                return NULL;
+            case PERSISTENT_DICTIONARY_NODE_COLLISION:
+                if (node->hash != hash) return NULL;
+                for (uint32_t i = 0; i < node->child_count; i++)
+                {
+                    if (__key_compare_persistent_dictionary__(dict, node->children[i]->key, key) == 0) return node->children[i]->value;
+                }
+                return NULL;
+            case PERSISTENT_DICTIONARY_NODE_BRANCH:
+            default:
+            {
+                const uint32_t bit = 1u << __level_index_persistent_dictionary__(hash, depth);
+                if ((node->bitmap & bit) == 0) return NULL;
+                node = node->children[__popcount_32__(node->bitmap & (bit - 1))];
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Inserts a key-value pair, copying only the path from the root to the new leaf.
+ * @return Returns 0 on success, else error (1 duplicate key found; 2 allocation error)
+ */
+static inline uint8_t insert_key_value_pair_persistent_dictionary(PersistentDictionary* const dict, const void* const key, const void* const value)
+{
+    const uint8_t status = __update_root_persistent_dictionary__(dict, key, value, __PERSISTENT_DICTIONARY_INSERT__);
+    if (status == 0) return 0;
+    return (status == 2) ? 1 : 2;
+}
+
+/**
+ * Replaces the value of an existing key, copying only the path from the root to the changed leaf.
+ * @return Returns 0 on success, else error (1 key not found; 2 allocation error)
+ */
+static inline uint8_t set_value_persistent_dictionary(PersistentDictionary* const dict, const void* const key, const void* const value)
+{
+    const uint8_t status = __update_root_persistent_dictionary__(dict, key, value, __PERSISTENT_DICTIONARY_SET__);
+    if (status == 1) return 0;
+    return (status == 3) ? 1 : 2;
+}
+
+/**
+ * Inserts a key-value pair, or replaces the value if the key is present.
+ * @return Returns 0 if inserted, 1 if replaced, 2 on allocation error
+ */
+static inline uint8_t put_persistent_dictionary(PersistentDictionary* const dict, const void* const key, const void* const value)
+{
+    const uint8_t status = __update_root_persistent_dictionary__(dict, key, value, __PERSISTENT_DICTIONARY_PUT__);
+    return (status <= 1) ? status : 2;
+}
+
+/**
+ * Deletes a key-value pair by key, copying only the path from the root to the removed leaf.
+ * @return Returns 0 on success, else error (1 key not found; 2 allocation error)
+ */
+static inline uint8_t delete_key_value_pair_persistent_dictionary(PersistentDictionary* const dict, const void* const key)
+{
+    const uint64_t hash = __hash_key_persistent_dictionary__(dict, key);
+    uint8_t status = 0;
+    struct persistent_dictionary_node* const new_root = __dissoc_persistent_dictionary__(dict, dict->root, 0, hash, key, &status);
+
+    if (status != 0) return (status == 1) ? 1 : 2;
+
+    __release_node_persistent_dictionary__(dict, dict->root);
+    dict->root = new_root;
+    dict->count--;
+    return 0;
+}
+
+static inline uint64_t count_persistent_dictionary(const PersistentDictionary* const dict)
+{
+    return dict->count;
+}
+
+/**
+ * Drops this handle's reference to its version; nodes no longer referenced by any snapshot are freed.
+ */
+static inline void clean_persistent_dictionary(PersistentDictionary* const dict)
+{
+    __release_node_persistent_dictionary__(dict, dict->root);
+    dict->root = NULL;
+    dict->count = 0;
+}
+
+static inline void free_persistent_dictionary(PersistentDictionary* const dict)
+{
+    clean_persistent_dictionary(dict);
+    free(dict);
+}
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef SHARDED_DICTIONARY_H
+#define SHARDED_DICTIONARY_H
+
+#include "dictionary.h"
+#include "../Threading/threading.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define SHARDED_DICTIONARY_MAX_SHARD_BITS 16
+#define SHARDED_DICTIONARY_ROUTE_SEED 0x9E3779B97F4A7C15ULL // kept apart from the shards' own hash seeds
+#define SHARDED_DICTIONARY_MIN_BULK_PER_THREAD 4096 // below this, bulk inserts stay on the calling thread
+
+/*
+    A ShardedDictionary routes every key to one of 2^shard_bits independent Dictionary shards using the top bits of the key's hash.
+    A key only ever lives in one shard, so point operations touch a single shard, and bulk loads can build every shard on its own thread.
+*/
+typedef struct ShardedDictionary
+{
+    uint8_t shard_bits;
+    uint32_t shard_count;
+    Dictionary* shards;
+} ShardedDictionary;
+
+/**
+ * @brief Initialize a pre-allocated ShardedDictionary; every shard is initialized with set_dictionary() using the same parameters.
+ * @param sharded_dict Pointer to an existing ShardedDictionary object to initialize.
+ * @param shard_bits log2 of the number of shards (at most SHARDED_DICTIONARY_MAX_SHARD_BITS).
+ * @param array_size Number of buckets per array in EACH shard.
+ * @see set_dictionary() for the remaining parameters.
+ */
+static inline void set_sharded_dictionary(
+    ShardedDictionary* const sharded_dict,
+    uint8_t shard_bits,
+    const uint16_t array_count, const uint64_t array_size,
+    const enum dictionary_hash_function hash_function,
+    const enum dictionary_key_value_type key_type,
+    const enum dictionary_key_value_type value_type,
+    const enum dictionary_copy_type copy_type,
+    const uint64_t custom_key_size,
+    const uint64_t custom_value_size,
+    const copy_func custom_key_copy_func,
+    const copy_func custom_value_copy_func,
+    const cleanup_func custom_key_cleanup_func,
+    const cleanup_func custom_value_cleanup_func
+) {
+    if (shard_bits > SHARDED_DICTIONARY_MAX_SHARD_BITS) shard_bits = SHARDED_DICTIONARY_MAX_SHARD_BITS;
+
+    sharded_dict->shard_bits = shard_bits;
+    sharded_dict->shard_count = 1u << shard_bits;
+    sharded_dict->shards = (Dictionary*)calloc(sharded_dict->shard_count, sizeof(Dictionary));
+
+    for (uint32_t i = 0; i < sharded_dict->shard_count; i++)
+    {
+        set_dictionary(&sharded_dict->shards[i], array_count, array_size, hash_function, key_type, value_type, copy_type,
+            custom_key_size, custom_value_size, custom_key_copy_func, custom_value_copy_func, custom_key_cleanup_func, custom_value_cleanup_func);
+    }
+}
+
+static inline ShardedDictionary* new_sharded_dictionary(
+    const uint8_t shard_bits,
+    const uint16_t array_count, const uint64_t array_size,
+    const enum dictionary_hash_function hash_function,
+    const enum dictionary_key_value_type key_type,
+    const enum dictionary_key_value_type value_type,
+    const enum dictionary_copy_type copy_type,
+    const uint64_t custom_key_size,
+    const uint64_t custom_value_size,
+    const copy_func custom_key_copy_func,
+    const copy_func custom_value_copy_func,
+    const cleanup_func custom_key_cleanup_func,
+    const cleanup_func custom_value_cleanup_func
+) {
+    ShardedDictionary* const sharded_dict = (ShardedDictionary*)calloc(1, sizeof(ShardedDictionary));
+    set_sharded_dictionary(sharded_dict, shard_bits, array_count, array_size, hash_function, key_type, value_type, copy_type,
+        custom_key_size, custom_value_size, custom_key_copy_func, custom_value_copy_func, custom_key_cleanup_func, custom_value_cleanup_func);
+    return sharded_dict;
+}
+
+/**
+ * @brief creates a new sharded dictionary with the same per-shard defaults as new_dictionary_default(), can not call DICTIONARY_KEY_VALUE_TYPE_CUSTOM for either type.
+ */
+static inline ShardedDictionary* new_sharded_dictionary_default(const uint8_t shard_bits, const enum dictionary_key_value_type key_type, const enum dictionary_key_value_type value_type)
+{
+    if (key_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM || value_type == DICTIONARY_KEY_VALUE_TYPE_CUSTOM)
+    {
+        return NULL;
+    }
+
+    return new_sharded_dictionary(shard_bits, 8, 256, DICTIONARY_HASH_FUNCTION_DEFAULT, key_type, value_type, DICTIONARY_DEEP_COPY, 0, 0, NULL, NULL, NULL, NULL);
+}
+
+/**
+ * @brief Returns the index of the shard that owns @p key.
+ */
+static inline uint32_t get_shard_index_sharded_dictionary(const ShardedDictionary* const sharded_dict, const void* const key)
+{
+    if (sharded_dict->shard_bits == 0) return 0;
+
+    const Dictionary* const first_shard = &sharded_dict->shards[0];
+    dyn_array key_view;
+    __set_dictionary_key_view__(&key_view, first_shard->key_type, key, first_shard->key_size);
+
+    const uint64_t hash = compute_hash(first_shard->hash_function, SHARDED_DICTIONARY_ROUTE_SEED, &key_view);
+    return (uint32_t)(hash >> (64 - sharded_dict->shard_bits));
+}
+
+/**
+ * @brief Returns the shard that owns @p key.
+ */
+static inline Dictionary* get_shard_sharded_dictionary(const ShardedDictionary* const sharded_dict, const void* const key)
+{
+    return &sharded_dict->shards[get_shard_index_sharded_dictionary(sharded_dict, key)];
+}
+
+/**
+ * @see get_value_dictionary()
+ */
+static inline void* get_value_sharded_dictionary(const ShardedDictionary* const sharded_dict, const void* const key)
+{
+    return get_value_dictionary(get_shard_sharded_dictionary(sharded_dict, key), key);
+}
+
+/**
+ * @see insert_key_value_pair_dictionary()
+ */
+static inline uint8_t insert_key_value_pair_sharded_dictionary(ShardedDictionary* const sharded_dict, const void* const key, const void* const value)
+{
+    return insert_key_value_pair_dictionary(get_shard_sharded_dictionary(sharded_dict, key), key, value);
+}
+
+/**
+ * @see set_value_dictionary()
+ */
+static inline uint8_t set_value_sharded_dictionary(const ShardedDictionary* const sharded_dict, const void* const key, const void* const value)
+{
+    return set_value_dictionary(get_shard_sharded_dictionary(sharded_dict, key), key, value);
+}
+
+/**
+ * @see find_or_insert_dictionary()
+ */
+static inline void* find_or_insert_sharded_dictionary(ShardedDictionary* const sharded_dict, const void* const key, uint8_t* const inserted)
+{
+    return find_or_insert_dictionary(get_shard_sharded_dictionary(sharded_dict, key), key, inserted);
+}
+
+/**
+ * @see upsert_dictionary()
+ */
+static inline uint8_t upsert_sharded_dictionary(ShardedDictionary* const sharded_dict, const void* const key, const void* const value, const merge_func merge)
+{
+    return upsert_dictionary(get_shard_sharded_dictionary(sharded_dict, key), key, value, merge);
+}
+
+/**
+ * @see delete_key_value_pair_dictionary()
+ */
+static inline void delete_key_value_pair_sharded_dictionary(ShardedDictionary* const sharded_dict, const void* const key)
+{
+    delete_key_value_pair_dictionary(get_shard_sharded_dictionary(sharded_dict, key), key);
+}
+
+// Internal use only
+struct __sharded_dictionary_bulk_context__
+{
+    ShardedDictionary* sharded_dict;
+    const uint8_t* keys;
+    const uint8_t* values;
+    uint8_t* return_codes; // per shard; each is written only by the thread building that shard
+};
+
+// Internal use only
+static inline uint32_t __bulk_route_sharded_dictionary__(void* const context_ptr, const uint64_t i)
+{
+    const struct __sharded_dictionary_bulk_context__* const context = (const struct __sharded_dictionary_bulk_context__*)context_ptr;
+    return get_shard_index_sharded_dictionary(context->sharded_dict, context->keys + i * context->sharded_dict->shards[0].key_size);
+}
+
+// Internal use only
+static inline void __bulk_build_sharded_dictionary__(void* const context_ptr, const uint32_t shard, const uint64_t* const items, const uint64_t item_count)
+{
+    struct __sharded_dictionary_bulk_context__* const context = (struct __sharded_dictionary_bulk_context__*)context_ptr;
+    Dictionary* const dict = &context->sharded_dict->shards[shard];
+
+    for (uint64_t o = 0; o < item_count; o++)
+    {
+        const uint64_t i = items[o];
+        const uint8_t return_code = insert_key_value_pair_dictionary(dict, context->keys + i * dict->key_size, context->values + i * dict->value_size);
+        if (return_code > context->return_codes[shard]) context->return_codes[shard] = return_code;
+    }
+}
+
+/**
+ * @brief Inserts @p count key-value pairs, partitioning them by shard and building the shards in parallel without locking.
+ * Items are routed and grouped by shard across threads (see run_sharded_partition), then each thread inserts into its own disjoint set of shards.
+ * @param sharded_dict Pointer to the sharded dictionary.
+ * @param keys Array of @p count keys, each key_size bytes (i.e. an array of the key type).
+ * @param values Array of @p count values, each value_size bytes (i.e. an array of the value type).
+ * @param count Number of key-value pairs.
+ * @param thread_count Number of threads to use; 0 uses get_hardware_thread_count(). Capped by the shard count.
+ * @return Returns 0 on success, else the worst insert_key_value_pair_dictionary() error (1 duplicate key skipped; 2 deep copying error), or 3 on allocation failure (nothing is inserted).
+ * @warning With DICTIONARY_SHALLOW_COPY the dictionary points into @p keys and @p values, so they must outlive it.
+ */
+static inline uint8_t bulk_insert_sharded_dictionary(ShardedDictionary* const sharded_dict, const void* const keys, const void* const values, const uint64_t count, unsigned int thread_count)
+{
+    if (count == 0) return 0;
+
+    if (thread_count == 0) thread_count = get_hardware_thread_count();
+    if (thread_count > sharded_dict->shard_count) thread_count = sharded_dict->shard_count;
+    if (thread_count > count / SHARDED_DICTIONARY_MIN_BULK_PER_THREAD) thread_count = (unsigned int)(count / SHARDED_DICTIONARY_MIN_BULK_PER_THREAD);
+    if (thread_count < 1) thread_count = 1;
+
+    const uint64_t key_size = sharded_dict->shards[0].key_size;
+    const uint64_t value_size = sharded_dict->shards[0].value_size;
+
+    if (thread_count == 1)
+    {
+        uint8_t worst_code = 0;
+        for (uint64_t i = 0; i < count; i++)
+        {
+            const uint8_t return_code = insert_key_value_pair_sharded_dictionary(sharded_dict, (const uint8_t*)keys + i * key_size, (const uint8_t*)values + i * value_size);
+            if (return_code > worst_code) worst_code = return_code;
+        }
+        return worst_code;
+    }
+
+    struct __sharded_dictionary_bulk_context__ context;
+    context.sharded_dict = sharded_dict;
+    context.keys = (const uint8_t*)keys;
+    context.values = (const uint8_t*)values;
+    context.return_codes = (uint8_t*)calloc(sharded_dict->shard_count, sizeof(uint8_t));
+    if (context.return_codes == NULL) return 3;
+
+    if (run_sharded_partition(thread_count, count, sharded_dict->shard_count, __bulk_route_sharded_dictionary__, __bulk_build_sharded_dictionary__, &context) != 0)
+    {
+        free(context.return_codes);
+        return 3;
+    }
+
+    uint8_t worst_code = 0;
+    for (uint32_t shard = 0; shard < sharded_dict->shard_count; shard++)
+    {
+        if (context.return_codes[shard] > worst_code) worst_code = context.return_codes[shard];
+    }
+
+    free(context.return_codes);
+    return worst_code;
+}
+
+static inline void clean_sharded_dictionary(ShardedDictionary* const sharded_dict)
+{
+    if (sharded_dict->shards == NULL) return;
+
+    for (uint32_t i = 0; i < sharded_dict->shard_count; i++)
+    {
+        clean_dictionary(&sharded_dict->shards[i]);
+    }
+    free(sharded_dict->shards);
+    sharded_dict->shards = NULL;
+}
+
+static inline void free_sharded_dictionary(ShardedDictionary* const sharded_dict)
+{
+    clean_sharded_dictionary(sharded_dict);
+    free(sharded_dict);
+}
+
+#endif
@@ -9,9 +9,56 @@
 #include "../Vectors/matrix_3x3.h"
 #include "../Vectors/matrix_4x4.h"
 #include "../Strings/String.h"
+#include "../Memory/allocator.h"
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN64  // windows platform
+	#include <malloc.h>
+#endif
+
+#if defined(__linux__) && defined(_GNU_SOURCE) // mremap is a GNU extension
+	#include <sys/mman.h>
+	#define DYN_ARRAY_USE_MREMAP 1
+#else
+	#define DYN_ARRAY_USE_MREMAP 0
+#endif
+
+// File-backed arrays (map_dyn_array) need POSIX mmap and ftruncate, which strict ISO C modes hide unless a POSIX feature macro is set
+#if (defined(__unix__) || defined(__APPLE__)) && (!defined(__STRICT_ANSI__) || defined(_POSIX_C_SOURCE) || defined(_XOPEN_SOURCE) || defined(_GNU_SOURCE) || defined(_DEFAULT_SOURCE))
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#define DYN_ARRAY_USE_FILE_MAP 1
+#else
+	#define DYN_ARRAY_USE_FILE_MAP 0
+#endif
+
+#ifndef DYN_ARRAY_PAGE_SIZE
+	#define DYN_ARRAY_PAGE_SIZE 4096
+#endif
+#define DYN_ARRAY_CAPPED_DOUBLE_MAX_STEP (64u * 1024u * 1024u) // bytes; DYN_ARRAY_EXPANSION_CAPPED_DOUBLE stops doubling past this step
+#define DYN_ARRAY_MREMAP_THRESHOLD (1024u * 1024u) // bytes; DYN_ARRAY_EXPANSION_PAGE buffers at least this large are mmap-backed (when DYN_ARRAY_USE_MREMAP)
+#define DYN_ARRAY_ALIGN_SIMD 32 // bytes; one AVX register
+#define DYN_ARRAY_ALIGN_CACHE_LINE 64 // bytes; vector4 items never straddle a line, matrix_4x4 items fill exactly one
+#ifndef DYN_ARRAY_INLINE_BYTES
+	#define DYN_ARRAY_INLINE_BYTES 0 // bytes stored inside the struct before spilling to the heap (e.g. 64 fits a matrix_4x4 or a SHA-512 digest); 0 compiles inline storage out
+#endif
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+	#define __DYN_ARRAY_INLINE_ALIGN__ _Alignas(16)
+#elif defined(__GNUC__) || defined(__clang__) // C99
+	#define __DYN_ARRAY_INLINE_ALIGN__ __attribute__((aligned(16)))
+#else
+	#define __DYN_ARRAY_INLINE_ALIGN__
+#endif
+
+enum dyn_array_map_mode {
+	DYN_ARRAY_MAP_READ_ONLY, // the array cannot grow or be written
+	DYN_ARRAY_MAP_READ_WRITE, // writes go to the file; growing extends it
+};
 
 enum dyn_array_type {
 	DYN_ARRAY_NO_TYPE,
@@ -33,17 +80,30 @@ enum dyn_array_type {
 };
 
 enum dyn_array_expansion_type {
-	DYN_ARRAY_EXPANSION_DOUBLE,
-	DYN_ARRAY_EXPANSION_FIXED
+	DYN_ARRAY_EXPANSION_DOUBLE,        // 2n + 1
+	DYN_ARRAY_EXPANSION_FIXED,         // n + 1
+	DYN_ARRAY_EXPANSION_ONE_AND_HALF,  // 1.5n + 1
+	DYN_ARRAY_EXPANSION_CAPPED_DOUBLE, // 2n + 1 until the step exceeds DYN_ARRAY_CAPPED_DOUBLE_MAX_STEP bytes, then linear in that step
+	DYN_ARRAY_EXPANSION_PAGE           // 1.5n + 1 rounded up to whole pages; large buffers are resized in place with mremap on Linux
 };
 
 typedef struct dyn_array {
 	enum dyn_array_type type;
 	enum dyn_array_expansion_type expansion_type;
-	unsigned int current_size;
-	unsigned int max_size;
-	unsigned int item_size; // bytes
+	size_t current_size;
+	size_t max_size;
+	size_t item_size; // bytes
 	void* data;
+	uint8_t is_mapped; // data is an anonymous mapping (DYN_ARRAY_EXPANSION_PAGE with DYN_ARRAY_USE_MREMAP only)
+	int map_fd; // file descriptor of a file-backed array (map_dyn_array), else -1
+	enum dyn_array_map_mode map_mode;
+	size_t realloc_count; // statistics: times the buffer has been allocated, resized or released
+	size_t alignment; // bytes; 0 uses the allocator default (see set_alignment_dyn_array)
+	const allocator* allocator; // heap buffers come from here; NULL uses malloc / realloc / free (see set_allocator_dyn_array)
+#if DYN_ARRAY_INLINE_BYTES > 0
+	uint8_t allow_inline; // small buffers live in inline_data instead of the heap (see set_inline_dyn_array)
+	__DYN_ARRAY_INLINE_ALIGN__ uint8_t inline_data[DYN_ARRAY_INLINE_BYTES];
+#endif
 } dyn_array;
 
 #define dyn_get_void_ptr(DYN_ARRAY_STRUCT_PTR, INDEX) ((DYN_ARRAY_STRUCT_PTR)->data + (INDEX)*((DYN_ARRAY_STRUCT_PTR)->item_size))
@@ -89,6 +149,15 @@ static inline void set_dyn_array(dyn_array* const dyn_struct, const enum dyn_arr
 	dyn_struct->current_size = 0;
 	dyn_struct->max_size = 0;
 	dyn_struct->data = NULL;
+	dyn_struct->is_mapped = 0;
+	dyn_struct->map_fd = -1;
+	dyn_struct->map_mode = DYN_ARRAY_MAP_READ_WRITE;
+	dyn_struct->realloc_count = 0;
+	dyn_struct->alignment = 0;
+	dyn_struct->allocator = NULL;
+#if DYN_ARRAY_INLINE_BYTES > 0
+	dyn_struct->allow_inline = 0;
+#endif
 
 	switch (dyn_struct->type)
 	{
@@ -150,15 +219,68 @@ static inline struct dyn_array* new_dyn_array(const enum dyn_array_type type, co
 	return dyn_struct;
 }
 
+/*
+	As set_dyn_array, but the first DYN_ARRAY_INLINE_BYTES bytes are stored inside the struct itself,
+	spilling to the heap only once the array outgrows them. Same as set_dyn_array while DYN_ARRAY_INLINE_BYTES is 0 (the default).
+	WARNING: data then points into the struct, so it must NOT be copied by value (assignment/memcpy); use move_dyn_array
+*/
+static inline void set_inline_dyn_array(dyn_array* const dyn_struct, const enum dyn_array_type type, const enum dyn_array_expansion_type expansion_type)
+{
+	set_dyn_array(dyn_struct, type, expansion_type);
+#if DYN_ARRAY_INLINE_BYTES > 0
+	dyn_struct->allow_inline = 1;
+#endif
+}
+
+static inline uint8_t is_inline_dyn_array(const dyn_array* const dyn_struct)
+{
+#if DYN_ARRAY_INLINE_BYTES > 0
+	return dyn_struct->data != NULL && dyn_struct->data == (const void*)dyn_struct->inline_data;
+#else
+	(void)dyn_struct;
+	return 0;
+#endif
+}
+
+/*
+	Moves src into dst (dst must be clean/unset), repointing inline storage at dst; src is left empty
+*/
+static inline void move_dyn_array(dyn_array* const dst, dyn_array* const src)
+{
+	memcpy(dst, src, sizeof(dyn_array));
+#if DYN_ARRAY_INLINE_BYTES > 0
+	if (is_inline_dyn_array(src)) dst->data = dst->inline_data;
+#endif
+
+	src->current_size = 0;
+	src->max_size = 0;
+	src->data = NULL;
+	src->is_mapped = 0;
+	src->map_fd = -1;
+}
+
+/*
+	Takes the array's heap buffers from alloc from now on (NULL restores malloc / realloc / free), e.g. &arena->allocator;
+	alloc must outlive the array. Only the buffer is affected (the struct is the caller's or new_dyn_array's), and
+	DYN_ARRAY_EXPANSION_PAGE then grows through alloc instead of mmap.
+	Returns 0 on success, else 1 (the array already holds a heap buffer, or is file-backed)
+*/
+static inline int set_allocator_dyn_array(dyn_array* const dyn_struct, const allocator* const alloc)
+{
+	if (dyn_struct->map_fd >= 0 || (dyn_struct->data != NULL && !is_inline_dyn_array(dyn_struct))) return 1;
+	dyn_struct->allocator = alloc;
+	return 0;
+}
+
 /*
 	To be used for custom data types; only once BEFORE adding any items
 */
-static inline void override_item_size_dyn_array(dyn_array* const dyn_struct, const unsigned int size)
+static inline void override_item_size_dyn_array(dyn_array* const dyn_struct, const size_t size)
 {
 	dyn_struct->item_size = size;
 }
 
-static inline void* get_dyn_array(const dyn_array* const dyn_struct, const unsigned int index)
+static inline void* get_dyn_array(const dyn_array* const dyn_struct, const size_t index)
 {
 	if (dyn_struct == NULL) return NULL;
 	if (index >= dyn_struct->current_size) return NULL;
@@ -200,7 +322,7 @@ static inline void* get_dyn_array(const dyn_array* const dyn_struct, const unsig
 	}
 }
 
-static inline char* get_dyn_array_byte(const dyn_array* const dyn_struct, const unsigned int byte_index)
+static inline char* get_dyn_array_byte(const dyn_array* const dyn_struct, const size_t byte_index)
 {
 	if (dyn_struct == NULL) return NULL;
 	if (byte_index >= dyn_struct->current_size * dyn_struct->item_size) return NULL;
@@ -257,43 +379,238 @@ static inline void* get_last_dyn_array(const dyn_array* const dyn_struct)
 	}
 }
 
-static inline void* add_slot_dyn_array(dyn_array* const dyn_struct)
+// Internal use only; rounds a capacity up so the buffer fills whole pages (DYN_ARRAY_EXPANSION_PAGE only)
+static inline size_t __round_capacity_dyn_array__(const enum dyn_array_expansion_type expansion_type, const size_t item_size, const size_t capacity)
 {
-	if (dyn_struct->current_size == dyn_struct->max_size)
+	size_t items = capacity;
+	if (expansion_type == DYN_ARRAY_EXPANSION_PAGE && item_size != 0)
 	{
-		switch (dyn_struct->expansion_type)
+		const size_t bytes = (items * item_size + DYN_ARRAY_PAGE_SIZE - 1) / DYN_ARRAY_PAGE_SIZE * DYN_ARRAY_PAGE_SIZE;
+		items = bytes / item_size;
+	}
+	return items;
+}
+
+// Internal use only; the capacity after one growth step of the given policy, and at least min_size
+static inline size_t __next_capacity_dyn_array__(const enum dyn_array_expansion_type expansion_type, const size_t max_size, const size_t item_size, const size_t min_size)
+{
+	size_t capacity;
+	switch (expansion_type)
+	{
+		case DYN_ARRAY_EXPANSION_FIXED:
+			capacity = max_size + 1;
+			break;
+		case DYN_ARRAY_EXPANSION_ONE_AND_HALF:
+		case DYN_ARRAY_EXPANSION_PAGE:
+			capacity = max_size + max_size / 2 + 1;
+			break;
+		case DYN_ARRAY_EXPANSION_CAPPED_DOUBLE:
 		{
-			case DYN_ARRAY_EXPANSION_FIXED:
-				dyn_struct->max_size = dyn_struct->max_size + 1;		
-				break;
-			case DYN_ARRAY_EXPANSION_DOUBLE:
-			default:
-				dyn_struct->max_size = 2 * dyn_struct->max_size + 1;		
-				break;
+			const size_t max_step = (item_size == 0 || DYN_ARRAY_CAPPED_DOUBLE_MAX_STEP / item_size == 0) ? 1 : DYN_ARRAY_CAPPED_DOUBLE_MAX_STEP / item_size;
+			capacity = max_size + ((max_size + 1 < max_step) ? max_size + 1 : max_step);
+			break;
 		}
-		dyn_struct->data = realloc(dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size);
+		case DYN_ARRAY_EXPANSION_DOUBLE:
+		default:
+			capacity = 2 * max_size + 1;
+			break;
 	}
+	if (capacity < min_size) capacity = min_size;
+	return __round_capacity_dyn_array__(expansion_type, item_size, capacity);
+}
 
-	dyn_struct->current_size++;
-	return get_last_dyn_array(dyn_struct);
+// Internal use only; alignment 0 uses plain malloc (or the array's allocator)
+static inline void* __alloc_data_dyn_array__(const dyn_array* const dyn_struct, const size_t alignment, const size_t bytes)
+{
+	if (dyn_struct->allocator != NULL) return mem_alloc_aligned(dyn_struct->allocator, bytes, alignment);
+	if (alignment == 0) return malloc(bytes);
+	return __aligned_malloc_memory__(bytes, alignment);
 }
 
-static inline void* pop_slot_dyn_array(dyn_array* const dyn_struct, const unsigned int index)
+// Internal use only; releases a buffer of bytes from __alloc_data_dyn_array__ (or realloc when unaligned)
+static inline void __release_data_dyn_array__(const dyn_array* const dyn_struct, const size_t alignment, void* const data, const size_t bytes)
 {
-	if (dyn_struct->current_size == 0) return NULL;
-	if (index >= dyn_struct->current_size) return NULL;
+	if (dyn_struct->allocator != NULL)
+	{
+		mem_free_aligned(dyn_struct->allocator, data, bytes);
+		return;
+	}
+#ifdef _WIN64
+	if (alignment != 0)
+	{
+		_aligned_free(data);
+		return;
+	}
+#else
+	(void)alignment;
+#endif
+	free(data);
+}
 
-	void* const item_ptr = get_dyn_array(dyn_struct, index);
+// Internal use only
+static inline void __free_data_dyn_array__(dyn_array* const dyn_struct)
+{
+	if (dyn_struct->data == NULL) return;
+	if (is_inline_dyn_array(dyn_struct))
+	{
+		dyn_struct->data = NULL;
+		return;
+	}
+#if DYN_ARRAY_USE_MREMAP
+	if (dyn_struct->is_mapped) munmap(dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size);
+	else
+#endif
+	__release_data_dyn_array__(dyn_struct, dyn_struct->alignment, dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size);
+	dyn_struct->data = NULL;
+	dyn_struct->is_mapped = 0;
+	dyn_struct->realloc_count++;
+}
+
+#if DYN_ARRAY_USE_FILE_MAP
+/*
+	Internal use only
+	Resizes a file-backed array: the file is truncated / extended to max_size items and the mapping moved to match.
+	Returns 0 on success, else 1 (read-only mapping or system error)
+*/
+static inline int __resize_file_map_dyn_array__(dyn_array* const dyn_struct, const size_t max_size)
+{
+	if (dyn_struct->map_mode == DYN_ARRAY_MAP_READ_ONLY) return 1;
+
+	const size_t old_bytes = dyn_struct->max_size * dyn_struct->item_size;
+	const size_t new_bytes = max_size * dyn_struct->item_size;
+	if (ftruncate(dyn_struct->map_fd, (off_t)new_bytes) != 0) return 1;
+
+	void* data = NULL;
+	if (new_bytes != 0)
+	{
+#if DYN_ARRAY_USE_MREMAP
+		if (dyn_struct->data != NULL) data = mremap(dyn_struct->data, old_bytes, new_bytes, MREMAP_MAYMOVE);
+		else
+#endif
+		{
+			// The contents live in the file, so a fresh mapping replaces the old one without copying
+			data = mmap(NULL, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, dyn_struct->map_fd, 0);
+			if (data != MAP_FAILED && dyn_struct->data != NULL) munmap(dyn_struct->data, old_bytes);
+		}
+		if (data == MAP_FAILED) return 1;
+	}
+	else if (dyn_struct->data != NULL) munmap(dyn_struct->data, old_bytes);
+
+	dyn_struct->data = data;
+	dyn_struct->max_size = max_size;
+	dyn_struct->realloc_count++;
+	return 0;
+}
+#endif
+
+/*
+	Internal use only
+	Resizes the buffer to exactly max_size items (never below current_size).
+	Returns 0 on success, else 1 (allocation error; the buffer is left untouched)
+*/
+static inline int __resize_dyn_array__(dyn_array* const dyn_struct, const size_t max_size)
+{
+	if (max_size == dyn_struct->max_size && (max_size == 0 || dyn_struct->data != NULL)) return 0;
+#if DYN_ARRAY_USE_FILE_MAP
+	if (dyn_struct->map_fd >= 0) return __resize_file_map_dyn_array__(dyn_struct, max_size);
+#endif
+	if (max_size == 0)
+	{
+		__free_data_dyn_array__(dyn_struct);
+		dyn_struct->max_size = 0;
+		return 0;
+	}
 
-	for (int i = index; i < dyn_struct->current_size - 1; i++)
+	const size_t new_bytes = max_size * dyn_struct->item_size;
+	const uint8_t was_inline = is_inline_dyn_array(dyn_struct);
+	void* data;
+
+#if DYN_ARRAY_INLINE_BYTES > 0
+	if (dyn_struct->allow_inline && dyn_struct->alignment <= 16 && new_bytes <= DYN_ARRAY_INLINE_BYTES)
 	{
-		void* const i_ptr = get_dyn_array(dyn_struct, i);
-		void* const next_i_ptr = get_dyn_array(dyn_struct, i+1);
-		for (int j = 0; j < dyn_struct->item_size; j++)
+		// Fits inside the struct: move any heap contents back in and release the heap buffer
+		if (!was_inline)
 		{
-			*((char*)i_ptr + j) = *((char*)next_i_ptr + j);
+			if (dyn_struct->data != NULL) memcpy(dyn_struct->inline_data, dyn_struct->data, dyn_struct->current_size * dyn_struct->item_size);
+			__free_data_dyn_array__(dyn_struct);
+			dyn_struct->data = dyn_struct->inline_data;
 		}
+		dyn_struct->max_size = DYN_ARRAY_INLINE_BYTES / dyn_struct->item_size;
+		return 0;
 	}
+#endif
+
+#if DYN_ARRAY_USE_MREMAP
+	const size_t old_bytes = dyn_struct->max_size * dyn_struct->item_size;
+	if (dyn_struct->expansion_type == DYN_ARRAY_EXPANSION_PAGE && new_bytes >= DYN_ARRAY_MREMAP_THRESHOLD && dyn_struct->allocator == NULL)
+	{
+		if (dyn_struct->is_mapped)
+		{
+			// Moves page table entries rather than copying the contents
+			data = mremap(dyn_struct->data, old_bytes, new_bytes, MREMAP_MAYMOVE);
+			if (data == MAP_FAILED) return 1;
+		}
+		else
+		{
+			data = mmap(NULL, new_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (data == MAP_FAILED) return 1;
+			if (dyn_struct->data != NULL) memcpy(data, dyn_struct->data, (old_bytes < new_bytes) ? old_bytes : new_bytes);
+			if (!was_inline) __release_data_dyn_array__(dyn_struct, dyn_struct->alignment, dyn_struct->data, old_bytes);
+			dyn_struct->is_mapped = 1;
+		}
+	}
+	else if (dyn_struct->is_mapped)
+	{
+		data = __alloc_data_dyn_array__(dyn_struct, dyn_struct->alignment, new_bytes);
+		if (data == NULL) return 1;
+		memcpy(data, dyn_struct->data, (old_bytes < new_bytes) ? old_bytes : new_bytes);
+		munmap(dyn_struct->data, old_bytes);
+		dyn_struct->is_mapped = 0;
+	}
+	else
+#endif
+	if (was_inline || dyn_struct->alignment != 0)
+	{
+		// Spill to the heap, or grow manually since there is no aligned realloc
+		data = __alloc_data_dyn_array__(dyn_struct, dyn_struct->alignment, new_bytes);
+		if (data == NULL) return 1;
+		if (dyn_struct->data != NULL) memcpy(data, dyn_struct->data, dyn_struct->current_size * dyn_struct->item_size);
+		if (!was_inline) __release_data_dyn_array__(dyn_struct, dyn_struct->alignment, dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size);
+	}
+	else
+	{
+		data = mem_realloc(dyn_struct->allocator, dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size, new_bytes);
+		if (data == NULL) return 1;
+	}
+
+	dyn_struct->data = data;
+	dyn_struct->max_size = max_size;
+	dyn_struct->realloc_count++;
+	return 0;
+}
+
+/*
+	Returns the new (uninitialized) last slot, or NULL if growing failed
+*/
+static inline void* add_slot_dyn_array(dyn_array* const dyn_struct)
+{
+	if (dyn_struct->current_size == dyn_struct->max_size)
+	{
+		const size_t max_size = __next_capacity_dyn_array__(dyn_struct->expansion_type, dyn_struct->max_size, dyn_struct->item_size, dyn_struct->current_size + 1);
+		if (__resize_dyn_array__(dyn_struct, max_size) != 0) return NULL;
+	}
+
+	dyn_struct->current_size++;
+	return get_last_dyn_array(dyn_struct);
+}
+
+static inline void* pop_slot_dyn_array(dyn_array* const dyn_struct, const size_t index)
+{
+	if (dyn_struct->current_size == 0) return NULL;
+	if (index >= dyn_struct->current_size) return NULL;
+
+	void* const item_ptr = get_dyn_array(dyn_struct, index);
+	memmove(item_ptr, (char*)item_ptr + dyn_struct->item_size, (dyn_struct->current_size - index - 1) * dyn_struct->item_size);
 
 	dyn_struct->current_size--;
 	return item_ptr;
@@ -302,29 +619,214 @@ static inline void* pop_slot_dyn_array(dyn_array* const dyn_struct, const unsign
 static inline void append_item_dyn_array(dyn_array* const dyn_array, const void* const item)
 {
 	void* const slot = add_slot_dyn_array(dyn_array);
-	for (int i = 0; i < dyn_array->item_size; i++)
+	if (slot == NULL) return;
+	memcpy(slot, item, dyn_array->item_size);
+}
+
+// Internal use only; grows the buffer (with a single resize) so it can hold at least min_size items
+static inline int __grow_to_dyn_array__(dyn_array* const dyn_struct, const size_t min_size)
+{
+	if (min_size <= dyn_struct->max_size) return 0;
+	return __resize_dyn_array__(dyn_struct, __next_capacity_dyn_array__(dyn_struct->expansion_type, dyn_struct->max_size, dyn_struct->item_size, min_size));
+}
+
+/*
+	Inserts count items (copied from items, which must not point into this array) before index, shifting later items up.
+	Returns 0 on success, else 1 (index out of range or allocation error)
+*/
+static inline int insert_range_dyn_array(dyn_array* const dyn_struct, const size_t index, const void* const items, const size_t count)
+{
+	if (index > dyn_struct->current_size) return 1;
+	if (count == 0) return 0;
+	if (__grow_to_dyn_array__(dyn_struct, dyn_struct->current_size + count) != 0) return 1;
+
+	char* const at = (char*)dyn_struct->data + index * dyn_struct->item_size;
+	memmove(at + count * dyn_struct->item_size, at, (dyn_struct->current_size - index) * dyn_struct->item_size);
+	memcpy(at, items, count * dyn_struct->item_size);
+	dyn_struct->current_size += count;
+	return 0;
+}
+
+/*
+	Removes count items starting at index, shifting later items down.
+	Returns 0 on success, else 1 (range out of bounds)
+*/
+static inline int erase_range_dyn_array(dyn_array* const dyn_struct, const size_t index, const size_t count)
+{
+	if (index > dyn_struct->current_size || count > dyn_struct->current_size - index) return 1;
+	if (count == 0) return 0;
+
+	char* const at = (char*)dyn_struct->data + index * dyn_struct->item_size;
+	memmove(at, at + count * dyn_struct->item_size, (dyn_struct->current_size - index - count) * dyn_struct->item_size);
+	dyn_struct->current_size -= count;
+	return 0;
+}
+
+/*
+	Appends count items (copied from items, which must not point into this array).
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int append_range_dyn_array(dyn_array* const dyn_struct, const void* const items, const size_t count)
+{
+	return insert_range_dyn_array(dyn_struct, dyn_struct->current_size, items, count);
+}
+
+/*
+	Removes the item at index in O(1) by moving the last item into its place (does not preserve order).
+	Returns 0 on success, else 1 (index out of range)
+*/
+static inline int swap_remove_dyn_array(dyn_array* const dyn_struct, const size_t index)
+{
+	if (index >= dyn_struct->current_size) return 1;
+
+	dyn_struct->current_size--;
+	if (index != dyn_struct->current_size)
 	{
-		*((char*)slot + i) = *((char*)item + i);
+		memcpy((char*)dyn_struct->data + index * dyn_struct->item_size,
+			(char*)dyn_struct->data + dyn_struct->current_size * dyn_struct->item_size,
+			dyn_struct->item_size);
 	}
+	return 0;
 }
 
-static inline int strip_dyn_array(dyn_array* const dyn_struct)
+/*
+	Aligns the start of the buffer to alignment bytes (0 restores the allocator default), e.g. DYN_ARRAY_ALIGN_SIMD
+	so batch kernels can use aligned AVX loads, or DYN_ARRAY_ALIGN_CACHE_LINE for vector4/matrix_4x4 arrays.
+	Existing items are moved to a new buffer if needed. Arrays aligned past 16 bytes do not use inline storage.
+	Returns 0 on success, else 1 (alignment not a power of two, not a multiple of sizeof(void*) or above DYN_ARRAY_PAGE_SIZE; or allocation error)
+*/
+static inline int set_alignment_dyn_array(dyn_array* const dyn_struct, const size_t alignment)
+{
+	if (alignment != 0 && ((alignment & (alignment - 1)) != 0 || alignment % sizeof(void*) != 0 || alignment > DYN_ARRAY_PAGE_SIZE)) return 1;
+	if (alignment == dyn_struct->alignment) return 0;
+
+	const uint8_t was_inline = is_inline_dyn_array(dyn_struct);
+	const uint8_t stays_inline = was_inline && alignment <= 16;
+	if (dyn_struct->data != NULL && !dyn_struct->is_mapped && dyn_struct->map_fd < 0 && !stays_inline) // mappings are page aligned
+	{
+		const size_t bytes = dyn_struct->max_size * dyn_struct->item_size;
+		void* const data = __alloc_data_dyn_array__(dyn_struct, alignment, bytes);
+		if (data == NULL) return 1;
+		memcpy(data, dyn_struct->data, dyn_struct->current_size * dyn_struct->item_size);
+		if (!was_inline) __release_data_dyn_array__(dyn_struct, dyn_struct->alignment, dyn_struct->data, bytes);
+		dyn_struct->data = data;
+		dyn_struct->realloc_count++;
+	}
+	dyn_struct->alignment = alignment;
+	return 0;
+}
+
+/*
+	Ensures room for at least capacity items without further reallocation.
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int reserve_dyn_array(dyn_array* const dyn_struct, const size_t capacity)
+{
+	if (capacity <= dyn_struct->max_size) return 0;
+	return __resize_dyn_array__(dyn_struct, __round_capacity_dyn_array__(dyn_struct->expansion_type, dyn_struct->item_size, capacity));
+}
+
+/*
+	Releases unused capacity (DYN_ARRAY_EXPANSION_PAGE keeps whole pages); an empty array releases its buffer.
+	Returns 0 on success, else 1 (allocation error; the buffer is left untouched)
+*/
+static inline int shrink_to_fit_dyn_array(dyn_array* const dyn_struct)
+{
+	if (dyn_struct->current_size == 0) return __resize_dyn_array__(dyn_struct, 0);
+	const size_t max_size = __round_capacity_dyn_array__(dyn_struct->expansion_type, dyn_struct->item_size, dyn_struct->current_size);
+	if (max_size >= dyn_struct->max_size) return 0;
+	return __resize_dyn_array__(dyn_struct, max_size);
+}
+
+static inline int64_t strip_dyn_array(dyn_array* const dyn_struct)
 {
 	if (dyn_struct->current_size == 0) return -1;
 
-	if (dyn_struct->current_size < dyn_struct->max_size)
+	shrink_to_fit_dyn_array(dyn_struct);
+	return (int64_t)dyn_struct->max_size;
+}
+
+/*
+	Opens path as a dyn_array of the given type whose data is the file itself (mmap, MAP_SHARED): no read or copy at load,
+	and the page cache is shared with other processes mapping the same file. The file must hold a whole number of items.
+	DYN_ARRAY_MAP_READ_WRITE creates the file if missing; adding items extends it (ftruncate, then remap) by the expansion
+	policy, and clean_dyn_array / free_dyn_array trim it back to exactly current_size items.
+	Pointers into data are invalidated whenever the array grows. POSIX only (returns NULL without DYN_ARRAY_USE_FILE_MAP).
+	Returns NULL if the file cannot be opened / mapped or its size is not a multiple of the item size
+*/
+static inline dyn_array* map_dyn_array(const char* const path, const enum dyn_array_type type, const enum dyn_array_map_mode mode)
+{
+#if DYN_ARRAY_USE_FILE_MAP
+	dyn_array* const dyn_struct = (dyn_array*)calloc(1, sizeof(dyn_array));
+	if (dyn_struct == NULL) return NULL;
+	set_dyn_array(dyn_struct, type, DYN_ARRAY_EXPANSION_DOUBLE);
+	dyn_struct->map_mode = mode;
+
+	const int read_only = (mode == DYN_ARRAY_MAP_READ_ONLY);
+	dyn_struct->map_fd = open(path, read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+	struct stat file_stat;
+	if (dyn_struct->map_fd < 0 || fstat(dyn_struct->map_fd, &file_stat) != 0 || (size_t)file_stat.st_size % dyn_struct->item_size != 0)
 	{
-		dyn_struct->max_size = dyn_struct->current_size;
-		dyn_struct->data = realloc(dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size);
+		if (dyn_struct->map_fd >= 0) close(dyn_struct->map_fd);
+		free(dyn_struct);
+		return NULL;
 	}
 
-	return dyn_struct->max_size;
+	const size_t bytes = (size_t)file_stat.st_size;
+	if (bytes != 0)
+	{
+		dyn_struct->data = mmap(NULL, bytes, read_only ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, dyn_struct->map_fd, 0);
+		if (dyn_struct->data == MAP_FAILED)
+		{
+			close(dyn_struct->map_fd);
+			free(dyn_struct);
+			return NULL;
+		}
+	}
+	dyn_struct->current_size = bytes / dyn_struct->item_size;
+	dyn_struct->max_size = dyn_struct->current_size;
+	return dyn_struct;
+#else
+	(void)path; (void)type; (void)mode;
+	return NULL;
+#endif
+}
+
+/*
+	Flushes a file-backed array's items to disk (msync); a no-op for other arrays.
+	Returns 0 on success, else 1
+*/
+static inline int sync_dyn_array(const dyn_array* const dyn_struct)
+{
+#if DYN_ARRAY_USE_FILE_MAP
+	if (dyn_struct->map_fd < 0 || dyn_struct->data == NULL || dyn_struct->current_size == 0) return 0;
+	return (msync(dyn_struct->data, dyn_struct->current_size * dyn_struct->item_size, MS_SYNC) == 0) ? 0 : 1;
+#else
+	(void)dyn_struct;
+	return 0;
+#endif
 }
 
 static inline void clean_dyn_array(dyn_array* const dyn_struct)
 {
-	if (dyn_struct->data != NULL) free(dyn_struct->data);
-	dyn_struct->data = NULL;
+#if DYN_ARRAY_USE_FILE_MAP
+	if (dyn_struct->map_fd >= 0)
+	{
+		// Trim unused capacity so the file holds exactly the items
+		if (dyn_struct->data != NULL) munmap(dyn_struct->data, dyn_struct->max_size * dyn_struct->item_size);
+		if (dyn_struct->map_mode == DYN_ARRAY_MAP_READ_WRITE)
+		{
+			if (ftruncate(dyn_struct->map_fd, (off_t)(dyn_struct->current_size * dyn_struct->item_size)) != 0)
+			{
+				// On failure the file just keeps its spare capacity
+			}
+		}
+		close(dyn_struct->map_fd);
+		dyn_struct->map_fd = -1;
+		dyn_struct->data = NULL;
+	}
+#endif
+	__free_data_dyn_array__(dyn_struct);
 	dyn_struct->current_size = 0;
 	dyn_struct->max_size = 0;
 }
@@ -0,0 +1,702 @@
+#ifndef DYN_ARRAY_PARALLEL_H
+#define DYN_ARRAY_PARALLEL_H
+
+#include "dyn_array.h"
+#include "dyn_array_search.h" // AVX2 target / runtime dispatch
+#include "../Threading/thread_pool.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DYN_ARRAY_PARALLEL_CHUNK_BYTES (256u * 1024u) // input bytes per task; keeps a chunk's inputs and outputs within L2
+#define DYN_ARRAY_PARALLEL_MIN_BYTES (128u * 1024u) // smaller arrays run serially on the calling thread
+
+/*
+	Parallel algorithms over dyn_array items: for_each, transform (map), filter, reduce and prefix sum.
+	Work is split into chunks of DYN_ARRAY_PARALLEL_CHUNK_BYTES (by item_size) that the pool's threads claim one at a time;
+	chunk results are combined in array order, so filter is stable and reduce only needs an associative operator.
+	A NULL pool, a pool without workers, or an array under DYN_ARRAY_PARALLEL_MIN_BYTES runs serially.
+	reduce_op_dyn_array and prefix_sum_dyn_array have built-in operators for the numeric types (AVX2 for 32-bit ints and floats,
+	picked at runtime the same way as dyn_array_search.h).
+*/
+
+typedef void (*dyn_array_for_each_func)(void* item, void* context);
+typedef void (*dyn_array_transform_func)(const void* item, void* out, void* context);
+typedef uint8_t (*dyn_array_filter_func)(const void* item, void* context); // nonzero keeps the item
+typedef void (*dyn_array_reduce_func)(void* accumulator, const void* item, void* context); // must be associative
+
+enum dyn_array_reduce_op {
+	DYN_ARRAY_REDUCE_SUM, // wraps on integer overflow
+	DYN_ARRAY_REDUCE_MIN,
+	DYN_ARRAY_REDUCE_MAX,
+};
+
+// Internal use only
+enum __dyn_array_numeric_kind__ {
+	__DYN_ARRAY_NUMERIC_NONE__,
+	__DYN_ARRAY_NUMERIC_I32__,
+	__DYN_ARRAY_NUMERIC_U32__,
+	__DYN_ARRAY_NUMERIC_U8__,
+	__DYN_ARRAY_NUMERIC_U16__,
+	__DYN_ARRAY_NUMERIC_U64__,
+	__DYN_ARRAY_NUMERIC_F32__,
+};
+
+struct __dyn_array_parallel_args__
+{
+	const dyn_array* src;
+	dyn_array* dst;
+	size_t start;
+	size_t end;
+	void* context;
+	dyn_array_for_each_func for_each;
+	dyn_array_transform_func transform;
+	dyn_array_filter_func filter;
+	dyn_array_reduce_func reduce;
+	enum dyn_array_reduce_op op;
+	enum __dyn_array_numeric_kind__ kind;
+	uint8_t* flags; // filter: one keep flag per item
+	size_t offset; // filter: first output slot; prefix sum: unused
+	size_t kept; // filter: items kept by this chunk
+	uint8_t* partial; // reduce: this chunk's accumulator
+	_Alignas(8) uint8_t total[8]; // reduce_op / prefix sum: this chunk's result, then (prefix sum) its carry-in
+};
+
+// Internal use only
+static inline enum __dyn_array_numeric_kind__ __numeric_kind_dyn_array__(const dyn_array* const dyn_struct)
+{
+	switch (dyn_struct->type)
+	{
+		case DYN_ARRAY_INT_TYPE:
+			return (sizeof(int) == 4) ? __DYN_ARRAY_NUMERIC_I32__ : __DYN_ARRAY_NUMERIC_NONE__;
+		case DYN_ARRAY_UINT_TYPE:
+			return (sizeof(unsigned int) == 4) ? __DYN_ARRAY_NUMERIC_U32__ : __DYN_ARRAY_NUMERIC_NONE__;
+		case DYN_ARRAY_UINT_8T_TYPE:
+			return __DYN_ARRAY_NUMERIC_U8__;
+		case DYN_ARRAY_UINT_16T_TYPE:
+			return __DYN_ARRAY_NUMERIC_U16__;
+		case DYN_ARRAY_UINT_32T_TYPE:
+			return __DYN_ARRAY_NUMERIC_U32__;
+		case DYN_ARRAY_UINT_64T_TYPE:
+			return __DYN_ARRAY_NUMERIC_U64__;
+		case DYN_ARRAY_VECTOR_FLOAT_TYPE:
+			return (sizeof(VECTOR_FLT) == sizeof(float)) ? __DYN_ARRAY_NUMERIC_F32__ : __DYN_ARRAY_NUMERIC_NONE__;
+		default:
+			return __DYN_ARRAY_NUMERIC_NONE__;
+	}
+}
+
+// Internal use only; items per chunk (all of them when the work should run serially)
+static inline size_t __chunk_items_dyn_array__(const thread_pool* const pool, const size_t count, const size_t item_size)
+{
+	if (pool == NULL || pool->thread_count == 0 || count * item_size < DYN_ARRAY_PARALLEL_MIN_BYTES) return (count == 0) ? 1 : count;
+	const size_t chunk = DYN_ARRAY_PARALLEL_CHUNK_BYTES / item_size;
+	return (chunk == 0) ? 1 : chunk;
+}
+
+// Internal use only
+static inline size_t __chunk_count_dyn_array__(const thread_pool* const pool, const size_t count, const size_t item_size)
+{
+	const size_t chunk = __chunk_items_dyn_array__(pool, count, item_size);
+	return (count == 0) ? 1 : (count + chunk - 1) / chunk;
+}
+
+/*
+	Internal use only
+	Splits [0, count) into chunks, copies proto into each chunk's args and runs func over them (serially when small or without a pool).
+	If proto->partial is set, chunk c gets the accumulator at partial + c * item_size.
+	single is used when there is only one chunk, avoiding an allocation.
+	Returns the chunk args (free them unless they are single), or NULL on allocation error
+*/
+static inline struct __dyn_array_parallel_args__* __run_chunks_dyn_array__(thread_pool* const pool, const struct __dyn_array_parallel_args__* const proto, struct __dyn_array_parallel_args__* const single, const thread_func func, const size_t count, const size_t item_size, size_t* const chunk_count)
+{
+	const size_t chunk = __chunk_items_dyn_array__(pool, count, item_size);
+	const size_t chunks = __chunk_count_dyn_array__(pool, count, item_size);
+
+	struct __dyn_array_parallel_args__* const args = (chunks == 1) ? single : (struct __dyn_array_parallel_args__*)malloc(chunks * sizeof(struct __dyn_array_parallel_args__));
+	if (args == NULL) return NULL;
+	for (size_t c = 0; c < chunks; c++)
+	{
+		args[c] = *proto;
+		args[c].start = c * chunk;
+		args[c].end = (c + 1 == chunks) ? count : (c + 1) * chunk;
+		if (proto->partial != NULL) args[c].partial = proto->partial + c * item_size;
+	}
+
+	if (chunks == 1) func(args);
+	else run_thread_pool(pool, func, args, sizeof(*args), chunks);
+	*chunk_count = chunks;
+	return args;
+}
+
+/*
+	----- for_each / transform -----
+*/
+
+// Internal use only
+static inline void __for_each_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	uint8_t* const data = (uint8_t*)args->src->data;
+	const size_t item_size = args->src->item_size;
+	for (size_t i = args->start; i < args->end; i++) args->for_each(data + i * item_size, args->context);
+}
+
+/*
+	Calls func on every item (in no particular order across chunks); func may modify the item in place.
+	Returns 0 on success, else 1 (allocation error; no item has been visited)
+*/
+static inline int for_each_dyn_array(dyn_array* const dyn_struct, const dyn_array_for_each_func func, void* const context, thread_pool* const pool)
+{
+	struct __dyn_array_parallel_args__ proto = { 0 };
+	proto.src = dyn_struct;
+	proto.context = context;
+	proto.for_each = func;
+
+	struct __dyn_array_parallel_args__ single;
+	size_t chunks;
+	struct __dyn_array_parallel_args__* const args = __run_chunks_dyn_array__(pool, &proto, &single, __for_each_chunk_dyn_array__, dyn_struct->current_size, dyn_struct->item_size, &chunks);
+	if (args == NULL) return 1;
+	if (args != &single) free(args);
+	return 0;
+}
+
+// Internal use only
+static inline void __transform_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	const uint8_t* const in = (const uint8_t*)args->src->data;
+	uint8_t* const out = (uint8_t*)args->dst->data;
+	const size_t in_size = args->src->item_size;
+	const size_t out_size = args->dst->item_size;
+	for (size_t i = args->start; i < args->end; i++) args->transform(in + i * in_size, out + i * out_size, args->context);
+}
+
+/*
+	dst[i] = func(src[i]) for every item. dst must already be set (its type / item_size is the output item);
+	its contents are replaced and it ends with src->current_size items. dst must not be src.
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int transform_dyn_array(const dyn_array* const src, dyn_array* const dst, const dyn_array_transform_func func, void* const context, thread_pool* const pool)
+{
+	if (reserve_dyn_array(dst, src->current_size) != 0) return 1;
+	dst->current_size = src->current_size;
+
+	struct __dyn_array_parallel_args__ proto = { 0 };
+	proto.src = src;
+	proto.dst = dst;
+	proto.context = context;
+	proto.transform = func;
+
+	struct __dyn_array_parallel_args__ single;
+	size_t chunks;
+	struct __dyn_array_parallel_args__* const args = __run_chunks_dyn_array__(pool, &proto, &single, __transform_chunk_dyn_array__, src->current_size, src->item_size, &chunks);
+	if (args == NULL) return 1;
+	if (args != &single) free(args);
+	return 0;
+}
+
+/*
+	----- filter -----
+*/
+
+// Internal use only
+static inline void __filter_flag_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	const uint8_t* const data = (const uint8_t*)args->src->data;
+	const size_t item_size = args->src->item_size;
+	size_t kept = 0;
+	for (size_t i = args->start; i < args->end; i++)
+	{
+		const uint8_t keep = (args->filter(data + i * item_size, args->context) != 0);
+		args->flags[i] = keep;
+		kept += keep;
+	}
+	args->kept = kept;
+}
+
+// Internal use only
+static inline void __filter_copy_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	const uint8_t* const data = (const uint8_t*)args->src->data;
+	const size_t item_size = args->src->item_size;
+	uint8_t* out = (uint8_t*)args->dst->data + args->offset * item_size;
+	for (size_t i = args->start; i < args->end; i++)
+	{
+		if (!args->flags[i]) continue;
+		memcpy(out, data + i * item_size, item_size);
+		out += item_size;
+	}
+}
+
+/*
+	Appends the items of src for which func returns nonzero to dst, in their original order.
+	dst must already be set with the same item_size as src, and must not be src.
+	Returns 0 on success, else 1 (item size mismatch or allocation error; dst is left untouched)
+*/
+static inline int filter_dyn_array(const dyn_array* const src, dyn_array* const dst, const dyn_array_filter_func func, void* const context, thread_pool* const pool)
+{
+	if (src->item_size != dst->item_size) return 1;
+	const size_t n = src->current_size;
+
+	uint8_t* const flags = (uint8_t*)malloc(n ? n : 1);
+	if (flags == NULL) return 1;
+
+	struct __dyn_array_parallel_args__ proto = { 0 };
+	proto.src = src;
+	proto.dst = dst;
+	proto.context = context;
+	proto.filter = func;
+	proto.flags = flags;
+
+	// Pass 1: evaluate func once per item and count what each chunk keeps
+	struct __dyn_array_parallel_args__ single;
+	size_t chunks;
+	struct __dyn_array_parallel_args__* const args = __run_chunks_dyn_array__(pool, &proto, &single, __filter_flag_chunk_dyn_array__, n, src->item_size, &chunks);
+	if (args == NULL)
+	{
+		free(flags);
+		return 1;
+	}
+
+	size_t total = dst->current_size;
+	for (size_t c = 0; c < chunks; c++)
+	{
+		args[c].offset = total;
+		total += args[c].kept;
+	}
+
+	int return_code = 1;
+	if (reserve_dyn_array(dst, total) == 0)
+	{
+		// Pass 2: each chunk copies its kept items to its own run of dst
+		if (chunks == 1) __filter_copy_chunk_dyn_array__(args);
+		else run_thread_pool(pool, __filter_copy_chunk_dyn_array__, args, sizeof(*args), chunks);
+		dst->current_size = total;
+		return_code = 0;
+	}
+
+	if (args != &single) free(args);
+	free(flags);
+	return return_code;
+}
+
+/*
+	----- reduce -----
+*/
+
+// Internal use only
+static inline void __reduce_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	const uint8_t* const data = (const uint8_t*)args->src->data;
+	const size_t item_size = args->src->item_size;
+	for (size_t i = args->start; i < args->end; i++) args->reduce(args->partial, data + i * item_size, args->context);
+}
+
+/*
+	Folds every item into result with func, starting from identity (result and identity are item_size bytes).
+	func(accumulator, item) must be associative and identity neutral, since chunks are folded separately and then combined in order.
+	Returns 0 on success, else 1 (allocation error; result is left untouched)
+*/
+static inline int reduce_dyn_array(const dyn_array* const dyn_struct, const dyn_array_reduce_func func, const void* const identity, void* const result, void* const context, thread_pool* const pool)
+{
+	const size_t item_size = dyn_struct->item_size;
+	const size_t chunk_count = __chunk_count_dyn_array__(pool, dyn_struct->current_size, item_size);
+	uint8_t* const partials = (uint8_t*)malloc(chunk_count * item_size);
+	if (partials == NULL) return 1;
+	for (size_t c = 0; c < chunk_count; c++) memcpy(partials + c * item_size, identity, item_size);
+
+	struct __dyn_array_parallel_args__ proto = { 0 };
+	proto.src = dyn_struct;
+	proto.context = context;
+	proto.reduce = func;
+	proto.partial = partials;
+
+	struct __dyn_array_parallel_args__ single;
+	size_t chunks;
+	struct __dyn_array_parallel_args__* const args = __run_chunks_dyn_array__(pool, &proto, &single, __reduce_chunk_dyn_array__, dyn_struct->current_size, item_size, &chunks);
+	if (args == NULL)
+	{
+		free(partials);
+		return 1;
+	}
+
+	memcpy(result, identity, item_size);
+	for (size_t c = 0; c < chunks; c++) func(result, partials + c * item_size, context);
+
+	if (args != &single) free(args);
+	free(partials);
+	return 0;
+}
+
+// Internal use only
+#define __DYN_ARRAY_REDUCE_LOOP__(T, COMBINE) \
+	{ \
+		const T* const data = (const T*)args->src->data; \
+		T acc; \
+		memcpy(&acc, args->total, sizeof(T)); \
+		for (; i < args->end; i++) \
+		{ \
+			const T v = data[i]; \
+			acc = COMBINE; \
+		} \
+		memcpy(args->total, &acc, sizeof(T)); \
+	}
+
+// Internal use only
+#define __DYN_ARRAY_REDUCE_TYPE__(T) \
+	switch (args->op) \
+	{ \
+		case DYN_ARRAY_REDUCE_SUM: __DYN_ARRAY_REDUCE_LOOP__(T, (T)(acc + v)) break; \
+		case DYN_ARRAY_REDUCE_MIN: __DYN_ARRAY_REDUCE_LOOP__(T, (v < acc) ? v : acc) break; \
+		default: __DYN_ARRAY_REDUCE_LOOP__(T, (v > acc) ? v : acc) break; \
+	}
+
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+// Internal use only; reduces the 32-bit items of the chunk 8 at a time from index i into args->total, returning the first item left
+__DYN_ARRAY_AVX2_TARGET__ static inline size_t __reduce_op_avx2_dyn_array__(struct __dyn_array_parallel_args__* const args, size_t i)
+{
+	if (args->op == DYN_ARRAY_REDUCE_SUM) // lanes start from the (zero) accumulator
+	{
+		switch (args->kind)
+		{
+			case __DYN_ARRAY_NUMERIC_I32__:
+			case __DYN_ARRAY_NUMERIC_U32__:
+			{
+				const uint32_t* const data = (const uint32_t*)args->src->data;
+				__m256i lanes = _mm256_setzero_si256();
+				for (; i + 8 <= args->end; i += 8) lanes = _mm256_add_epi32(lanes, _mm256_loadu_si256((const __m256i*)(data + i)));
+				uint32_t values[8];
+				_mm256_storeu_si256((__m256i*)values, lanes);
+				uint32_t acc = 0;
+				for (int k = 0; k < 8; k++) acc += values[k];
+				memcpy(args->total, &acc, sizeof(acc));
+				break;
+			}
+			case __DYN_ARRAY_NUMERIC_F32__:
+			{
+				const float* const data = (const float*)args->src->data;
+				__m256 lanes = _mm256_setzero_ps();
+				for (; i + 8 <= args->end; i += 8) lanes = _mm256_add_ps(lanes, _mm256_loadu_ps(data + i));
+				float values[8];
+				_mm256_storeu_ps(values, lanes);
+				float acc = 0;
+				for (int k = 0; k < 8; k++) acc += values[k];
+				memcpy(args->total, &acc, sizeof(acc));
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	else // min / max lanes start from the first item, which is idempotent
+	{
+		switch (args->kind)
+		{
+			case __DYN_ARRAY_NUMERIC_I32__:
+			{
+				const int32_t* const data = (const int32_t*)args->src->data;
+				__m256i lanes = _mm256_set1_epi32(data[i]);
+				for (; i + 8 <= args->end; i += 8)
+				{
+					const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+					lanes = (args->op == DYN_ARRAY_REDUCE_MIN) ? _mm256_min_epi32(lanes, v) : _mm256_max_epi32(lanes, v);
+				}
+				int32_t values[8];
+				_mm256_storeu_si256((__m256i*)values, lanes);
+				int32_t acc = values[0];
+				for (int k = 1; k < 8; k++) acc = (args->op == DYN_ARRAY_REDUCE_MIN) ? ((values[k] < acc) ? values[k] : acc) : ((values[k] > acc) ? values[k] : acc);
+				memcpy(args->total, &acc, sizeof(acc));
+				break;
+			}
+			case __DYN_ARRAY_NUMERIC_U32__:
+			{
+				const uint32_t* const data = (const uint32_t*)args->src->data;
+				__m256i lanes = _mm256_set1_epi32((int)data[i]);
+				for (; i + 8 <= args->end; i += 8)
+				{
+					const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+					lanes = (args->op == DYN_ARRAY_REDUCE_MIN) ? _mm256_min_epu32(lanes, v) : _mm256_max_epu32(lanes, v);
+				}
+				uint32_t values[8];
+				_mm256_storeu_si256((__m256i*)values, lanes);
+				uint32_t acc = values[0];
+				for (int k = 1; k < 8; k++) acc = (args->op == DYN_ARRAY_REDUCE_MIN) ? ((values[k] < acc) ? values[k] : acc) : ((values[k] > acc) ? values[k] : acc);
+				memcpy(args->total, &acc, sizeof(acc));
+				break;
+			}
+			case __DYN_ARRAY_NUMERIC_F32__:
+			{
+				const float* const data = (const float*)args->src->data;
+				__m256 lanes = _mm256_set1_ps(data[i]);
+				for (; i + 8 <= args->end; i += 8)
+				{
+					const __m256 v = _mm256_loadu_ps(data + i);
+					lanes = (args->op == DYN_ARRAY_REDUCE_MIN) ? _mm256_min_ps(lanes, v) : _mm256_max_ps(lanes, v);
+				}
+				float values[8];
+				_mm256_storeu_ps(values, lanes);
+				float acc = values[0];
+				for (int k = 1; k < 8; k++) acc = (args->op == DYN_ARRAY_REDUCE_MIN) ? ((values[k] < acc) ? values[k] : acc) : ((values[k] > acc) ? values[k] : acc);
+				memcpy(args->total, &acc, sizeof(acc));
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	return i;
+}
+#endif
+
+// Internal use only
+static inline void __reduce_op_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	const size_t item_size = args->src->item_size;
+	size_t i = args->start;
+
+	// Sums start from 0; min / max start from the chunk's first item
+	if (args->op == DYN_ARRAY_REDUCE_SUM) memset(args->total, 0, sizeof(args->total));
+	else memcpy(args->total, (const uint8_t*)args->src->data + i * item_size, item_size);
+
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+	if (__has_avx2_dyn_array__()) i = __reduce_op_avx2_dyn_array__(args, i);
+#endif
+
+	// Remaining items (all of them without AVX2)
+	switch (args->kind)
+	{
+		case __DYN_ARRAY_NUMERIC_I32__:
+			if (args->op == DYN_ARRAY_REDUCE_SUM) __DYN_ARRAY_REDUCE_TYPE__(uint32_t) // two's complement wrap without signed overflow
+			else __DYN_ARRAY_REDUCE_TYPE__(int32_t)
+			break;
+		case __DYN_ARRAY_NUMERIC_U32__: __DYN_ARRAY_REDUCE_TYPE__(uint32_t) break;
+		case __DYN_ARRAY_NUMERIC_U8__: __DYN_ARRAY_REDUCE_TYPE__(uint8_t) break;
+		case __DYN_ARRAY_NUMERIC_U16__: __DYN_ARRAY_REDUCE_TYPE__(uint16_t) break;
+		case __DYN_ARRAY_NUMERIC_U64__: __DYN_ARRAY_REDUCE_TYPE__(uint64_t) break;
+		case __DYN_ARRAY_NUMERIC_F32__: __DYN_ARRAY_REDUCE_TYPE__(float) break;
+		default: break;
+	}
+}
+
+/*
+	Built-in sum / min / max of a numeric dyn_array (INT, UINT, UINT_*, VECTOR_FLOAT) into result (one item).
+	Integer sums wrap; float sums are accumulated per lane and per chunk, so rounding can differ from a sequential loop.
+	Returns 0 on success, else 1 (non-numeric type, min / max of an empty array, or allocation error; result is left untouched)
+*/
+static inline int reduce_op_dyn_array(const dyn_array* const dyn_struct, const enum dyn_array_reduce_op op, void* const result, thread_pool* const pool)
+{
+	const enum __dyn_array_numeric_kind__ kind = __numeric_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_NUMERIC_NONE__) return 1;
+	if (dyn_struct->current_size == 0)
+	{
+		if (op != DYN_ARRAY_REDUCE_SUM) return 1;
+		memset(result, 0, dyn_struct->item_size);
+		return 0;
+	}
+
+	struct __dyn_array_parallel_args__ proto = { 0 };
+	proto.src = dyn_struct;
+	proto.op = op;
+	proto.kind = kind;
+
+	struct __dyn_array_parallel_args__ single;
+	size_t chunks;
+	struct __dyn_array_parallel_args__* const args = __run_chunks_dyn_array__(pool, &proto, &single, __reduce_op_chunk_dyn_array__, dyn_struct->current_size, dyn_struct->item_size, &chunks);
+	if (args == NULL) return 1;
+
+	// Combine chunk totals in order with the scalar loop (each total acts as one item)
+	struct __dyn_array_parallel_args__ combine = proto;
+	dyn_array totals_view;
+	set_dyn_array(&totals_view, dyn_struct->type, DYN_ARRAY_EXPANSION_DOUBLE);
+	uint8_t totals[8 * 64];
+	uint8_t* const totals_data = (chunks <= 64) ? totals : (uint8_t*)malloc(chunks * dyn_struct->item_size);
+	if (totals_data == NULL)
+	{
+		if (args != &single) free(args);
+		return 1;
+	}
+	for (size_t c = 0; c < chunks; c++) memcpy(totals_data + c * dyn_struct->item_size, args[c].total, dyn_struct->item_size);
+	totals_view.data = totals_data;
+	totals_view.current_size = chunks;
+	totals_view.max_size = chunks;
+	combine.src = &totals_view;
+	combine.start = 0;
+	combine.end = chunks;
+	__reduce_op_chunk_dyn_array__(&combine);
+	memcpy(result, combine.total, dyn_struct->item_size);
+
+	if (totals_data != totals) free(totals_data);
+	if (args != &single) free(args);
+	return 0;
+}
+
+/*
+	----- prefix sum -----
+*/
+
+// Internal use only
+#define __DYN_ARRAY_SCAN_LOOP__(T) \
+	{ \
+		T* const data = (T*)args->src->data; \
+		T acc = 0; \
+		for (; i < args->end; i++) \
+		{ \
+			acc = (T)(acc + data[i]); \
+			data[i] = acc; \
+		} \
+		memcpy(args->total, &acc, sizeof(T)); \
+	}
+
+// Internal use only
+#define __DYN_ARRAY_ADD_CARRY_LOOP__(T) \
+	{ \
+		T* const data = (T*)args->src->data; \
+		T carry; \
+		memcpy(&carry, args->total, sizeof(T)); \
+		for (; i < args->end; i++) data[i] = (T)(data[i] + carry); \
+	}
+
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+// Internal use only; inclusive scan of data[i, end) 8 items at a time into *acc, returning the first item left
+__DYN_ARRAY_AVX2_TARGET__ static inline size_t __scan_u32_avx2_dyn_array__(uint32_t* const data, size_t i, const size_t end, uint32_t* const acc)
+{
+	// Log-step scan within each 128-bit half, then carry the low half's total into the high half
+	__m256i carry = _mm256_set1_epi32((int)*acc);
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+		v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+		v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+		const __m256i low_total = _mm256_permute2x128_si256(_mm256_shuffle_epi32(v, 0xFF), _mm256_shuffle_epi32(v, 0xFF), 0x08);
+		v = _mm256_add_epi32(_mm256_add_epi32(v, low_total), carry);
+		_mm256_storeu_si256((__m256i*)(data + i), v);
+		carry = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(7));
+	}
+	*acc = (uint32_t)_mm256_extract_epi32(carry, 0);
+	return i;
+}
+
+// Internal use only; adds carry to data[i, end) 8 items at a time, returning the first item left
+__DYN_ARRAY_AVX2_TARGET__ static inline size_t __add_carry_u32_avx2_dyn_array__(uint32_t* const data, size_t i, const size_t end, const uint32_t carry)
+{
+	const __m256i carry_lanes = _mm256_set1_epi32((int)carry);
+	for (; i + 8 <= end; i += 8)
+	{
+		_mm256_storeu_si256((__m256i*)(data + i), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(data + i)), carry_lanes));
+	}
+	return i;
+}
+#endif
+
+// Internal use only; inclusive scan of the chunk in place, leaving the chunk total in args->total
+static inline void __scan_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	size_t i = args->start;
+	switch (args->kind)
+	{
+		case __DYN_ARRAY_NUMERIC_I32__: // two's complement wrap without signed overflow
+		case __DYN_ARRAY_NUMERIC_U32__:
+		{
+			uint32_t* const data = (uint32_t*)args->src->data;
+			uint32_t acc = 0;
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+			if (__has_avx2_dyn_array__()) i = __scan_u32_avx2_dyn_array__(data, i, args->end, &acc);
+#endif
+			for (; i < args->end; i++)
+			{
+				acc += data[i];
+				data[i] = acc;
+			}
+			memcpy(args->total, &acc, sizeof(acc));
+			break;
+		}
+		case __DYN_ARRAY_NUMERIC_U8__: __DYN_ARRAY_SCAN_LOOP__(uint8_t) break;
+		case __DYN_ARRAY_NUMERIC_U16__: __DYN_ARRAY_SCAN_LOOP__(uint16_t) break;
+		case __DYN_ARRAY_NUMERIC_U64__: __DYN_ARRAY_SCAN_LOOP__(uint64_t) break;
+		case __DYN_ARRAY_NUMERIC_F32__: __DYN_ARRAY_SCAN_LOOP__(float) break;
+		default: break;
+	}
+}
+
+// Internal use only; adds the chunk's carry-in (args->total) to every item
+static inline void __add_carry_chunk_dyn_array__(void* const arg)
+{
+	struct __dyn_array_parallel_args__* const args = (struct __dyn_array_parallel_args__*)arg;
+	size_t i = args->start;
+	switch (args->kind)
+	{
+		case __DYN_ARRAY_NUMERIC_I32__:
+		case __DYN_ARRAY_NUMERIC_U32__:
+		{
+			uint32_t* const data = (uint32_t*)args->src->data;
+			uint32_t carry;
+			memcpy(&carry, args->total, sizeof(carry));
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+			if (__has_avx2_dyn_array__()) i = __add_carry_u32_avx2_dyn_array__(data, i, args->end, carry);
+#endif
+			for (; i < args->end; i++) data[i] += carry;
+			break;
+		}
+		case __DYN_ARRAY_NUMERIC_U8__: __DYN_ARRAY_ADD_CARRY_LOOP__(uint8_t) break;
+		case __DYN_ARRAY_NUMERIC_U16__: __DYN_ARRAY_ADD_CARRY_LOOP__(uint16_t) break;
+		case __DYN_ARRAY_NUMERIC_U64__: __DYN_ARRAY_ADD_CARRY_LOOP__(uint64_t) break;
+		case __DYN_ARRAY_NUMERIC_F32__: __DYN_ARRAY_ADD_CARRY_LOOP__(float) break;
+		default: break;
+	}
+}
+
+/*
+	In-place inclusive prefix sum of a numeric dyn_array (INT, UINT, UINT_*, VECTOR_FLOAT): item i becomes the sum of items 0..i.
+	Integer sums wrap. In parallel, chunks are scanned independently, then each adds the total of the chunks before it.
+	Returns 0 on success, else 1 (non-numeric type or allocation error; the array is left untouched)
+*/
+static inline int prefix_sum_dyn_array(dyn_array* const dyn_struct, thread_pool* const pool)
+{
+	const enum __dyn_array_numeric_kind__ kind = __numeric_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_NUMERIC_NONE__) return 1;
+	if (dyn_struct->current_size == 0) return 0;
+
+	struct __dyn_array_parallel_args__ proto = { 0 };
+	proto.src = dyn_struct;
+	proto.kind = kind;
+
+	// Pass 1: scan each chunk on its own
+	struct __dyn_array_parallel_args__ single;
+	size_t chunks;
+	struct __dyn_array_parallel_args__* const args = __run_chunks_dyn_array__(pool, &proto, &single, __scan_chunk_dyn_array__, dyn_struct->current_size, dyn_struct->item_size, &chunks);
+	if (args == NULL) return 1;
+	if (chunks == 1) return 0;
+
+	// Exclusive scan of the chunk totals: each chunk's total becomes its carry-in
+	uint8_t running[8] = { 0 };
+	for (size_t c = 0; c < chunks; c++)
+	{
+		uint8_t chunk_total[8];
+		memcpy(chunk_total, args[c].total, sizeof(chunk_total));
+		memcpy(args[c].total, running, sizeof(running));
+		switch (kind)
+		{
+			case __DYN_ARRAY_NUMERIC_I32__:
+			case __DYN_ARRAY_NUMERIC_U32__: { uint32_t a, b; memcpy(&a, running, 4); memcpy(&b, chunk_total, 4); a += b; memcpy(running, &a, 4); break; }
+			case __DYN_ARRAY_NUMERIC_U8__: { running[0] = (uint8_t)(running[0] + chunk_total[0]); break; }
+			case __DYN_ARRAY_NUMERIC_U16__: { uint16_t a, b; memcpy(&a, running, 2); memcpy(&b, chunk_total, 2); a = (uint16_t)(a + b); memcpy(running, &a, 2); break; }
+			case __DYN_ARRAY_NUMERIC_U64__: { uint64_t a, b; memcpy(&a, running, 8); memcpy(&b, chunk_total, 8); a += b; memcpy(running, &a, 8); break; }
+			case __DYN_ARRAY_NUMERIC_F32__: { float a, b; memcpy(&a, running, 4); memcpy(&b, chunk_total, 4); a += b; memcpy(running, &a, 4); break; }
+			default: break;
+		}
+	}
+
+	// Pass 2: add the carry-ins (the first chunk has none)
+	run_thread_pool(pool, __add_carry_chunk_dyn_array__, args + 1, sizeof(*args), chunks - 1);
+	free(args);
+	return 0;
+}
+
+#endif
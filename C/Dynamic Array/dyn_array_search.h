@@ -0,0 +1,578 @@
+#ifndef DYN_ARRAY_SEARCH_H
+#define DYN_ARRAY_SEARCH_H
+
+#include "dyn_array.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+/*
+	Vectorised find / count / contains / min_max / sum over numeric dyn_arrays
+	(CHAR, INT, UINT, UINT_8T, UINT_16T, UINT_32T, UINT_64T, VECTOR_FLOAT).
+	On x86 with GCC or Clang the AVX2 kernels are compiled for AVX2 regardless of the compiler flags and picked at runtime
+	from the CPU's features; otherwise AVX2 is used only when the compiler targets it. Without AVX2, find / count / contains
+	use SSE2 (baseline on x86-64) and the rest fall back to scalar loops. Other item types are not supported.
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define DYN_ARRAY_SEARCH_AVX2
+	#if defined(__AVX2__)
+		#define __DYN_ARRAY_AVX2_TARGET__
+	#else
+		#define DYN_ARRAY_SEARCH_RUNTIME_DISPATCH
+		#define __DYN_ARRAY_AVX2_TARGET__ __attribute__((target("avx2")))
+	#endif
+#elif defined(__AVX2__)
+	#include <immintrin.h>
+	#define DYN_ARRAY_SEARCH_AVX2
+	#define __DYN_ARRAY_AVX2_TARGET__
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DYN_ARRAY_SEARCH_SSE2
+#endif
+
+// Internal use only
+enum __dyn_array_search_kind__ {
+	__DYN_ARRAY_SEARCH_NONE__,
+	__DYN_ARRAY_SEARCH_I8__,
+	__DYN_ARRAY_SEARCH_U8__,
+	__DYN_ARRAY_SEARCH_U16__,
+	__DYN_ARRAY_SEARCH_I32__,
+	__DYN_ARRAY_SEARCH_U32__,
+	__DYN_ARRAY_SEARCH_U64__,
+	__DYN_ARRAY_SEARCH_F32__,
+	__DYN_ARRAY_SEARCH_F64__,
+};
+
+// Internal use only
+static inline enum __dyn_array_search_kind__ __search_kind_dyn_array__(const dyn_array* const dyn_struct)
+{
+	switch (dyn_struct->type)
+	{
+		case DYN_ARRAY_CHAR_TYPE:
+			return (CHAR_MIN < 0) ? __DYN_ARRAY_SEARCH_I8__ : __DYN_ARRAY_SEARCH_U8__;
+		case DYN_ARRAY_INT_TYPE:
+			return (sizeof(int) == 4) ? __DYN_ARRAY_SEARCH_I32__ : __DYN_ARRAY_SEARCH_NONE__;
+		case DYN_ARRAY_UINT_TYPE:
+			return (sizeof(unsigned int) == 4) ? __DYN_ARRAY_SEARCH_U32__ : __DYN_ARRAY_SEARCH_NONE__;
+		case DYN_ARRAY_UINT_8T_TYPE:
+			return __DYN_ARRAY_SEARCH_U8__;
+		case DYN_ARRAY_UINT_16T_TYPE:
+			return __DYN_ARRAY_SEARCH_U16__;
+		case DYN_ARRAY_UINT_32T_TYPE:
+			return __DYN_ARRAY_SEARCH_U32__;
+		case DYN_ARRAY_UINT_64T_TYPE:
+			return __DYN_ARRAY_SEARCH_U64__;
+		case DYN_ARRAY_VECTOR_FLOAT_TYPE:
+			if (sizeof(VECTOR_FLT) == sizeof(float)) return __DYN_ARRAY_SEARCH_F32__;
+			return (sizeof(VECTOR_FLT) == sizeof(double)) ? __DYN_ARRAY_SEARCH_F64__ : __DYN_ARRAY_SEARCH_NONE__;
+		default:
+			return __DYN_ARRAY_SEARCH_NONE__;
+	}
+}
+
+// Internal use only
+static inline uint8_t __has_avx2_dyn_array__(void)
+{
+#if defined(DYN_ARRAY_SEARCH_RUNTIME_DISPATCH)
+	return __builtin_cpu_supports("avx2") ? 1 : 0;
+#elif defined(DYN_ARRAY_SEARCH_AVX2)
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+// Internal use only; x must be nonzero
+static inline uint32_t __ctz_32_dyn_array__(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (uint32_t)__builtin_ctz(x);
+#else
+	uint32_t n = 0;
+	while ((x & 1) == 0)
+	{
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+// Internal use only
+static inline uint32_t __popcount_32_dyn_array__(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (uint32_t)__builtin_popcount(x);
+#else
+	x = x - ((x >> 1) & 0x55555555U);
+	x = (x & 0x33333333U) + ((x >> 2) & 0x33333333U);
+	return (((x + (x >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+#endif
+}
+
+/*
+	----- scalar kernels (items [start, count)) -----
+*/
+
+// Internal use only
+#define __DYN_ARRAY_SCALAR_SWITCH__(LOOP) \
+	switch (kind) \
+	{ \
+		case __DYN_ARRAY_SEARCH_I8__: LOOP(int8_t) break; \
+		case __DYN_ARRAY_SEARCH_U8__: LOOP(uint8_t) break; \
+		case __DYN_ARRAY_SEARCH_U16__: LOOP(uint16_t) break; \
+		case __DYN_ARRAY_SEARCH_I32__: LOOP(int32_t) break; \
+		case __DYN_ARRAY_SEARCH_U32__: LOOP(uint32_t) break; \
+		case __DYN_ARRAY_SEARCH_U64__: LOOP(uint64_t) break; \
+		case __DYN_ARRAY_SEARCH_F32__: LOOP(float) break; \
+		case __DYN_ARRAY_SEARCH_F64__: LOOP(double) break; \
+		default: break; \
+	}
+
+// Internal use only
+#define __DYN_ARRAY_FIND_SCALAR_LOOP__(T) \
+	{ \
+		const T* const items = (const T*)data; \
+		T needle; \
+		memcpy(&needle, value, sizeof(T)); \
+		for (size_t i = start; i < count; i++) if (items[i] == needle) return i; \
+	}
+
+// Internal use only; index of the first match, else count
+static inline size_t __find_scalar_dyn_array__(const uint8_t* const data, const size_t start, const size_t count, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_FIND_SCALAR_LOOP__)
+	return count;
+}
+
+// Internal use only
+#define __DYN_ARRAY_COUNT_SCALAR_LOOP__(T) \
+	{ \
+		const T* const items = (const T*)data; \
+		T needle; \
+		memcpy(&needle, value, sizeof(T)); \
+		for (size_t i = start; i < count; i++) matches += (items[i] == needle); \
+	}
+
+// Internal use only
+static inline size_t __count_scalar_dyn_array__(const uint8_t* const data, const size_t start, const size_t count, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	size_t matches = 0;
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_COUNT_SCALAR_LOOP__)
+	return matches;
+}
+
+// Internal use only; min_out / max_out hold the running extremes (one item each)
+#define __DYN_ARRAY_MIN_MAX_SCALAR_LOOP__(T) \
+	{ \
+		const T* const items = (const T*)data; \
+		T lo, hi; \
+		memcpy(&lo, min_out, sizeof(T)); \
+		memcpy(&hi, max_out, sizeof(T)); \
+		for (size_t i = start; i < count; i++) \
+		{ \
+			lo = (items[i] < lo) ? items[i] : lo; \
+			hi = (items[i] > hi) ? items[i] : hi; \
+		} \
+		memcpy(min_out, &lo, sizeof(T)); \
+		memcpy(max_out, &hi, sizeof(T)); \
+	}
+
+// Internal use only
+static inline void __min_max_scalar_dyn_array__(const uint8_t* const data, const size_t start, const size_t count, const enum __dyn_array_search_kind__ kind, void* const min_out, void* const max_out)
+{
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_MIN_MAX_SCALAR_LOOP__)
+}
+
+// Internal use only; integers accumulate in a wrapping uint64_t, floats in a double
+static inline void __sum_scalar_dyn_array__(const uint8_t* const data, const size_t start, const size_t count, const enum __dyn_array_search_kind__ kind, uint64_t* const int_acc, double* const float_acc)
+{
+	uint64_t acc = *int_acc;
+	double facc = *float_acc;
+	switch (kind)
+	{
+		case __DYN_ARRAY_SEARCH_I8__: for (size_t i = start; i < count; i++) acc += (uint64_t)(int64_t)((const int8_t*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_U8__: for (size_t i = start; i < count; i++) acc += ((const uint8_t*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_U16__: for (size_t i = start; i < count; i++) acc += ((const uint16_t*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_I32__: for (size_t i = start; i < count; i++) acc += (uint64_t)(int64_t)((const int32_t*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_U32__: for (size_t i = start; i < count; i++) acc += ((const uint32_t*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_U64__: for (size_t i = start; i < count; i++) acc += ((const uint64_t*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_F32__: for (size_t i = start; i < count; i++) facc += ((const float*)data)[i]; break;
+		case __DYN_ARRAY_SEARCH_F64__: for (size_t i = start; i < count; i++) facc += ((const double*)data)[i]; break;
+		default: break;
+	}
+	*int_acc = acc;
+	*float_acc = facc;
+}
+
+/*
+	----- SSE2 kernels (find / count) -----
+*/
+
+#if defined(DYN_ARRAY_SEARCH_SSE2)
+
+// Internal use only; the needle repeated across 16 bytes
+static inline __m128i __broadcast_sse2_dyn_array__(const size_t width, const void* const value)
+{
+	uint8_t bytes[16];
+	for (size_t i = 0; i < 16; i += width) memcpy(bytes + i, value, width);
+	return _mm_loadu_si128((const __m128i*)bytes);
+}
+
+// Internal use only; SSE2 has no 64-bit compare, so both 32-bit halves must match
+#define __DYN_ARRAY_CMPEQ_EPI64_SSE2__(A, B) \
+	_mm_and_si128(_mm_cmpeq_epi32((A), (B)), _mm_shuffle_epi32(_mm_cmpeq_epi32((A), (B)), _MM_SHUFFLE(2, 3, 0, 1)))
+
+// Internal use only; EQ sets every byte of each matching item in v
+#define __DYN_ARRAY_SSE2_EQ_SWITCH__(LOOP) \
+	switch (kind) \
+	{ \
+		case __DYN_ARRAY_SEARCH_I8__: \
+		case __DYN_ARRAY_SEARCH_U8__: LOOP(_mm_cmpeq_epi8(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_U16__: LOOP(_mm_cmpeq_epi16(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_I32__: \
+		case __DYN_ARRAY_SEARCH_U32__: LOOP(_mm_cmpeq_epi32(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_U64__: LOOP(__DYN_ARRAY_CMPEQ_EPI64_SSE2__(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_F32__: LOOP(_mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(v), _mm_castsi128_ps(needle)))) break; \
+		case __DYN_ARRAY_SEARCH_F64__: LOOP(_mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(v), _mm_castsi128_pd(needle)))) break; \
+		default: break; \
+	}
+
+// Internal use only
+#define __DYN_ARRAY_FIND_SSE2_LOOP__(EQ) \
+	for (; i + lanes <= count; i += lanes) \
+	{ \
+		const __m128i v = _mm_loadu_si128((const __m128i*)(data + i * width)); \
+		const uint32_t mask = (uint32_t)_mm_movemask_epi8(EQ); \
+		if (mask != 0) return i + __ctz_32_dyn_array__(mask) / width; \
+	}
+
+// Internal use only
+static inline size_t __find_sse2_dyn_array__(const uint8_t* const data, const size_t count, const size_t width, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	const __m128i needle = __broadcast_sse2_dyn_array__(width, value);
+	const size_t lanes = 16 / width;
+	size_t i = 0;
+	__DYN_ARRAY_SSE2_EQ_SWITCH__(__DYN_ARRAY_FIND_SSE2_LOOP__)
+	return __find_scalar_dyn_array__(data, i, count, kind, value);
+}
+
+// Internal use only; each matching item sets width mask bits
+#define __DYN_ARRAY_COUNT_SSE2_LOOP__(EQ) \
+	for (; i + lanes <= count; i += lanes) \
+	{ \
+		const __m128i v = _mm_loadu_si128((const __m128i*)(data + i * width)); \
+		bits += __popcount_32_dyn_array__((uint32_t)_mm_movemask_epi8(EQ)); \
+	}
+
+// Internal use only
+static inline size_t __count_sse2_dyn_array__(const uint8_t* const data, const size_t count, const size_t width, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	const __m128i needle = __broadcast_sse2_dyn_array__(width, value);
+	const size_t lanes = 16 / width;
+	size_t i = 0;
+	size_t bits = 0;
+	__DYN_ARRAY_SSE2_EQ_SWITCH__(__DYN_ARRAY_COUNT_SSE2_LOOP__)
+	return bits / width + __count_scalar_dyn_array__(data, i, count, kind, value);
+}
+
+#endif
+
+/*
+	----- AVX2 kernels -----
+*/
+
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+
+// Internal use only; the needle repeated across 32 bytes
+__DYN_ARRAY_AVX2_TARGET__ static inline __m256i __broadcast_avx2_dyn_array__(const size_t width, const void* const value)
+{
+	uint8_t bytes[32];
+	for (size_t i = 0; i < 32; i += width) memcpy(bytes + i, value, width);
+	return _mm256_loadu_si256((const __m256i*)bytes);
+}
+
+// Internal use only; EQ sets every byte of each matching item in v
+#define __DYN_ARRAY_AVX2_EQ_SWITCH__(LOOP) \
+	switch (kind) \
+	{ \
+		case __DYN_ARRAY_SEARCH_I8__: \
+		case __DYN_ARRAY_SEARCH_U8__: LOOP(_mm256_cmpeq_epi8(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_U16__: LOOP(_mm256_cmpeq_epi16(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_I32__: \
+		case __DYN_ARRAY_SEARCH_U32__: LOOP(_mm256_cmpeq_epi32(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_U64__: LOOP(_mm256_cmpeq_epi64(v, needle)) break; \
+		case __DYN_ARRAY_SEARCH_F32__: LOOP(_mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(needle), _CMP_EQ_OQ))) break; \
+		case __DYN_ARRAY_SEARCH_F64__: LOOP(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(needle), _CMP_EQ_OQ))) break; \
+		default: break; \
+	}
+
+// Internal use only; stops at the first vector holding a match
+#define __DYN_ARRAY_FIND_AVX2_LOOP__(EQ) \
+	for (; i + lanes <= count; i += lanes) \
+	{ \
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * width)); \
+		const uint32_t mask = (uint32_t)_mm256_movemask_epi8(EQ); \
+		if (mask != 0) return i + __ctz_32_dyn_array__(mask) / width; \
+	}
+
+// Internal use only
+__DYN_ARRAY_AVX2_TARGET__ static inline size_t __find_avx2_dyn_array__(const uint8_t* const data, const size_t count, const size_t width, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	const __m256i needle = __broadcast_avx2_dyn_array__(width, value);
+	const size_t lanes = 32 / width;
+	size_t i = 0;
+	__DYN_ARRAY_AVX2_EQ_SWITCH__(__DYN_ARRAY_FIND_AVX2_LOOP__)
+	return __find_scalar_dyn_array__(data, i, count, kind, value);
+}
+
+// Internal use only; each matching item sets width mask bits
+#define __DYN_ARRAY_COUNT_AVX2_LOOP__(EQ) \
+	for (; i + lanes <= count; i += lanes) \
+	{ \
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * width)); \
+		bits += __popcount_32_dyn_array__((uint32_t)_mm256_movemask_epi8(EQ)); \
+	}
+
+// Internal use only
+__DYN_ARRAY_AVX2_TARGET__ static inline size_t __count_avx2_dyn_array__(const uint8_t* const data, const size_t count, const size_t width, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	const __m256i needle = __broadcast_avx2_dyn_array__(width, value);
+	const size_t lanes = 32 / width;
+	size_t i = 0;
+	size_t bits = 0;
+	__DYN_ARRAY_AVX2_EQ_SWITCH__(__DYN_ARRAY_COUNT_AVX2_LOOP__)
+	return bits / width + __count_scalar_dyn_array__(data, i, count, kind, value);
+}
+
+// Internal use only; float min / max on integer-typed registers so every kind shares one loop
+#define __DYN_ARRAY_MIN_PS__(A, B) _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(A), _mm256_castsi256_ps(B)))
+#define __DYN_ARRAY_MAX_PS__(A, B) _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(A), _mm256_castsi256_ps(B)))
+#define __DYN_ARRAY_MIN_PD__(A, B) _mm256_castpd_si256(_mm256_min_pd(_mm256_castsi256_pd(A), _mm256_castsi256_pd(B)))
+#define __DYN_ARRAY_MAX_PD__(A, B) _mm256_castpd_si256(_mm256_max_pd(_mm256_castsi256_pd(A), _mm256_castsi256_pd(B)))
+
+// Internal use only; lanes start from the running extremes, then fold into them
+#define __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(T, MIN, MAX) \
+	{ \
+		const size_t lanes = 32 / sizeof(T); \
+		__m256i lo = __broadcast_avx2_dyn_array__(sizeof(T), min_out); \
+		__m256i hi = __broadcast_avx2_dyn_array__(sizeof(T), max_out); \
+		for (; i + lanes <= count; i += lanes) \
+		{ \
+			const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * sizeof(T))); \
+			lo = MIN(lo, v); \
+			hi = MAX(hi, v); \
+		} \
+		T values[32 / sizeof(T)]; \
+		_mm256_storeu_si256((__m256i*)values, lo); \
+		__min_max_scalar_dyn_array__((const uint8_t*)values, 0, lanes, kind, min_out, max_out); \
+		_mm256_storeu_si256((__m256i*)values, hi); \
+		__min_max_scalar_dyn_array__((const uint8_t*)values, 0, lanes, kind, min_out, max_out); \
+	}
+
+// Internal use only; min_out / max_out hold the running extremes (one item each)
+__DYN_ARRAY_AVX2_TARGET__ static inline void __min_max_avx2_dyn_array__(const uint8_t* const data, const size_t count, const enum __dyn_array_search_kind__ kind, void* const min_out, void* const max_out)
+{
+	size_t i = 0;
+	switch (kind)
+	{
+		case __DYN_ARRAY_SEARCH_I8__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(int8_t, _mm256_min_epi8, _mm256_max_epi8) break;
+		case __DYN_ARRAY_SEARCH_U8__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(uint8_t, _mm256_min_epu8, _mm256_max_epu8) break;
+		case __DYN_ARRAY_SEARCH_U16__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(uint16_t, _mm256_min_epu16, _mm256_max_epu16) break;
+		case __DYN_ARRAY_SEARCH_I32__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(int32_t, _mm256_min_epi32, _mm256_max_epi32) break;
+		case __DYN_ARRAY_SEARCH_U32__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(uint32_t, _mm256_min_epu32, _mm256_max_epu32) break;
+		case __DYN_ARRAY_SEARCH_F32__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(float, __DYN_ARRAY_MIN_PS__, __DYN_ARRAY_MAX_PS__) break;
+		case __DYN_ARRAY_SEARCH_F64__: __DYN_ARRAY_MIN_MAX_AVX2_LOOP__(double, __DYN_ARRAY_MIN_PD__, __DYN_ARRAY_MAX_PD__) break;
+		default: break; // no unsigned 64-bit min / max in AVX2
+	}
+	__min_max_scalar_dyn_array__(data, i, count, kind, min_out, max_out);
+}
+
+// Internal use only; integers widen into four 64-bit lanes, floats into four double lanes
+__DYN_ARRAY_AVX2_TARGET__ static inline void __sum_avx2_dyn_array__(const uint8_t* const data, const size_t count, const enum __dyn_array_search_kind__ kind, uint64_t* const int_acc, double* const float_acc)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc = zero;
+	__m256d facc = _mm256_setzero_pd();
+	size_t i = 0;
+
+	switch (kind)
+	{
+		case __DYN_ARRAY_SEARCH_I8__: // bias to unsigned, sum with SAD, then remove the bias
+		case __DYN_ARRAY_SEARCH_U8__:
+		{
+			const __m256i bias = (kind == __DYN_ARRAY_SEARCH_I8__) ? _mm256_set1_epi8((char)0x80) : zero;
+			for (; i + 32 <= count; i += 32) acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), bias), zero));
+			if (kind == __DYN_ARRAY_SEARCH_I8__) *int_acc -= (uint64_t)i * 128;
+			break;
+		}
+		case __DYN_ARRAY_SEARCH_U16__:
+			for (; i + 16 <= count; i += 16)
+			{
+				const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * 2));
+				const __m256i pairs = _mm256_add_epi32(_mm256_unpacklo_epi16(v, zero), _mm256_unpackhi_epi16(v, zero));
+				acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_unpacklo_epi32(pairs, zero), _mm256_unpackhi_epi32(pairs, zero)));
+			}
+			break;
+		case __DYN_ARRAY_SEARCH_I32__:
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+				acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+				acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+			}
+			break;
+		case __DYN_ARRAY_SEARCH_U32__:
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+				acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_unpacklo_epi32(v, zero), _mm256_unpackhi_epi32(v, zero)));
+			}
+			break;
+		case __DYN_ARRAY_SEARCH_U64__:
+			for (; i + 4 <= count; i += 4) acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i*)(data + i * 8)));
+			break;
+		case __DYN_ARRAY_SEARCH_F32__:
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256 v = _mm256_loadu_ps((const float*)(data + i * 4));
+				facc = _mm256_add_pd(facc, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+				facc = _mm256_add_pd(facc, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+			}
+			break;
+		case __DYN_ARRAY_SEARCH_F64__:
+			for (; i + 4 <= count; i += 4) facc = _mm256_add_pd(facc, _mm256_loadu_pd((const double*)(data + i * 8)));
+			break;
+		default:
+			break;
+	}
+
+	uint64_t lanes[4];
+	double flanes[4];
+	_mm256_storeu_si256((__m256i*)lanes, acc);
+	_mm256_storeu_pd(flanes, facc);
+	for (int k = 0; k < 4; k++)
+	{
+		*int_acc += lanes[k];
+		*float_acc += flanes[k];
+	}
+	__sum_scalar_dyn_array__(data, i, count, kind, int_acc, float_acc);
+}
+
+#endif
+
+/*
+	----- public API -----
+*/
+
+/*
+	Index of the first item equal to value (one item of the array's type), else -1.
+	Floats compare by value: 0.0 matches -0.0 and NaN matches nothing.
+	Returns -1 for unsupported types
+*/
+static inline int64_t find_dyn_array(const dyn_array* const dyn_struct, const void* const value)
+{
+	const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_SEARCH_NONE__) return -1;
+
+	const uint8_t* const data = (const uint8_t*)dyn_struct->data;
+	const size_t count = dyn_struct->current_size;
+	size_t index;
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+	if (__has_avx2_dyn_array__()) index = __find_avx2_dyn_array__(data, count, dyn_struct->item_size, kind, value);
+	else
+#endif
+#if defined(DYN_ARRAY_SEARCH_SSE2)
+	index = __find_sse2_dyn_array__(data, count, dyn_struct->item_size, kind, value);
+#else
+	index = __find_scalar_dyn_array__(data, 0, count, kind, value);
+#endif
+	return (index < count) ? (int64_t)index : -1;
+}
+
+/*
+	Number of items equal to value (one item of the array's type); 0 for unsupported types
+*/
+static inline size_t count_dyn_array(const dyn_array* const dyn_struct, const void* const value)
+{
+	const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_SEARCH_NONE__) return 0;
+
+	const uint8_t* const data = (const uint8_t*)dyn_struct->data;
+	const size_t count = dyn_struct->current_size;
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+	if (__has_avx2_dyn_array__()) return __count_avx2_dyn_array__(data, count, dyn_struct->item_size, kind, value);
+#endif
+#if defined(DYN_ARRAY_SEARCH_SSE2)
+	return __count_sse2_dyn_array__(data, count, dyn_struct->item_size, kind, value);
+#else
+	return __count_scalar_dyn_array__(data, 0, count, kind, value);
+#endif
+}
+
+static inline uint8_t contains_dyn_array(const dyn_array* const dyn_struct, const void* const value)
+{
+	return find_dyn_array(dyn_struct, value) >= 0;
+}
+
+/*
+	Smallest and largest items, written to min_out / max_out (one item each; either may be NULL).
+	Results are unspecified if a float array holds NaNs.
+	Returns 0 on success, else 1 (empty array or unsupported type)
+*/
+static inline int min_max_dyn_array(const dyn_array* const dyn_struct, void* const min_out, void* const max_out)
+{
+	const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_SEARCH_NONE__ || dyn_struct->current_size == 0) return 1;
+
+	const uint8_t* const data = (const uint8_t*)dyn_struct->data;
+	const size_t count = dyn_struct->current_size;
+	_Alignas(8) uint8_t lo[8];
+	_Alignas(8) uint8_t hi[8];
+	memcpy(lo, data, dyn_struct->item_size);
+	memcpy(hi, data, dyn_struct->item_size);
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+	if (__has_avx2_dyn_array__()) __min_max_avx2_dyn_array__(data, count, kind, lo, hi);
+	else
+#endif
+	__min_max_scalar_dyn_array__(data, 1, count, kind, lo, hi);
+
+	if (min_out != NULL) memcpy(min_out, lo, dyn_struct->item_size);
+	if (max_out != NULL) memcpy(max_out, hi, dyn_struct->item_size);
+	return 0;
+}
+
+/*
+	Sum of the items, widened so it does not overflow the item type. result is written as:
+		int64_t for CHAR (when char is signed) and INT, wrapping on overflow
+		uint64_t for the unsigned types, wrapping on overflow
+		double for VECTOR_FLOAT (lanes are summed separately, so rounding can differ from a sequential loop)
+	Returns 0 on success, else 1 (unsupported type; result is left untouched)
+*/
+static inline int sum_dyn_array(const dyn_array* const dyn_struct, void* const result)
+{
+	const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_SEARCH_NONE__) return 1;
+
+	const uint8_t* const data = (const uint8_t*)dyn_struct->data;
+	const size_t count = dyn_struct->current_size;
+	uint64_t int_acc = 0;
+	double float_acc = 0;
+#if defined(DYN_ARRAY_SEARCH_AVX2)
+	if (__has_avx2_dyn_array__()) __sum_avx2_dyn_array__(data, count, kind, &int_acc, &float_acc);
+	else
+#endif
+	__sum_scalar_dyn_array__(data, 0, count, kind, &int_acc, &float_acc);
+
+	if (kind == __DYN_ARRAY_SEARCH_F32__ || kind == __DYN_ARRAY_SEARCH_F64__) memcpy(result, &float_acc, sizeof(float_acc));
+	else memcpy(result, &int_acc, sizeof(int_acc)); // same bits as the wrapped int64_t for signed types
+	return 0;
+}
+
+#endif
@@ -0,0 +1,559 @@
+#ifndef DYN_ARRAY_SORT_H
+#define DYN_ARRAY_SORT_H
+
+#include "dyn_array.h"
+#include "../Threading/threading.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DYN_ARRAY_SORT_PARALLEL_THRESHOLD 131072 // items; smaller arrays are sorted on the calling thread
+#define DYN_ARRAY_SORT_MIN_PER_THREAD 32768 // items; caps the thread count for mid-sized arrays
+#define DYN_ARRAY_SORT_INSERTION_RUN 16 // items; merge sort insertion-sorts runs of this length first
+#define DYN_ARRAY_SORT_RADIX_BUCKETS 256 // one byte per radix pass
+
+/*
+	Sorting for dyn_array.
+	Integer types (CHAR, INT, UINT, UINT_*) without a comparator use a stable LSD radix sort (one pass per key byte,
+	skipping bytes that are identical across the whole array; one read builds every byte's histogram). Everything else, or any type given a comparator,
+	uses a stable merge sort. Above DYN_ARRAY_SORT_PARALLEL_THRESHOLD items both run across threads:
+	radix passes split the histogram and scatter into per-thread chunks, and merge sort sorts per-thread chunks then
+	merges pairs of runs with each merge split evenly across threads (co-ranking).
+*/
+
+typedef int (*dyn_array_compare_func)(const void* first, const void* second); // qsort-style: <0, 0 or >0
+
+// Internal use only
+#define __DYN_ARRAY_SORT_COMPARE__(NAME, T) \
+static inline int NAME(const void* const first, const void* const second) \
+{ \
+	const T a = *(const T*)first; \
+	const T b = *(const T*)second; \
+	return (a > b) - (a < b); \
+}
+
+__DYN_ARRAY_SORT_COMPARE__(__compare_char_dyn_array__, char)
+__DYN_ARRAY_SORT_COMPARE__(__compare_int_dyn_array__, int)
+__DYN_ARRAY_SORT_COMPARE__(__compare_uint_dyn_array__, unsigned int)
+__DYN_ARRAY_SORT_COMPARE__(__compare_uint_8t_dyn_array__, uint8_t)
+__DYN_ARRAY_SORT_COMPARE__(__compare_uint_16t_dyn_array__, uint16_t)
+__DYN_ARRAY_SORT_COMPARE__(__compare_uint_32t_dyn_array__, uint32_t)
+__DYN_ARRAY_SORT_COMPARE__(__compare_uint_64t_dyn_array__, uint64_t)
+
+// Internal use only
+static inline int __compare_string_dyn_array__(const void* const first, const void* const second)
+{
+	return compareString((const String*)first, (const String*)second);
+}
+
+/*
+	Returns the natural ascending comparator for a dyn_array type, or NULL if it has none (vectors, matrices, custom)
+*/
+static inline dyn_array_compare_func get_default_compare_dyn_array(const enum dyn_array_type type)
+{
+	switch (type)
+	{
+		case DYN_ARRAY_CHAR_TYPE:
+			return __compare_char_dyn_array__;
+		case DYN_ARRAY_INT_TYPE:
+			return __compare_int_dyn_array__;
+		case DYN_ARRAY_UINT_TYPE:
+			return __compare_uint_dyn_array__;
+		case DYN_ARRAY_UINT_8T_TYPE:
+			return __compare_uint_8t_dyn_array__;
+		case DYN_ARRAY_UINT_16T_TYPE:
+			return __compare_uint_16t_dyn_array__;
+		case DYN_ARRAY_UINT_32T_TYPE:
+			return __compare_uint_32t_dyn_array__;
+		case DYN_ARRAY_UINT_64T_TYPE:
+			return __compare_uint_64t_dyn_array__;
+		case DYN_ARRAY_STRING_TYPE:
+			return __compare_string_dyn_array__;
+		default:
+			return NULL;
+	}
+}
+
+// Internal use only
+static inline unsigned int __sort_thread_count_dyn_array__(unsigned int thread_count, const size_t count)
+{
+	if (count < DYN_ARRAY_SORT_PARALLEL_THRESHOLD) return 1;
+	if (thread_count == 0) thread_count = get_hardware_thread_count();
+	if (thread_count > THREADING_MAX_THREADS) thread_count = THREADING_MAX_THREADS;
+	if (thread_count > count / DYN_ARRAY_SORT_MIN_PER_THREAD) thread_count = (unsigned int)(count / DYN_ARRAY_SORT_MIN_PER_THREAD);
+	return (thread_count < 1) ? 1 : thread_count;
+}
+
+/*
+	----- Radix sort -----
+*/
+
+struct __dyn_array_radix_args__
+{
+	const uint8_t* src;
+	uint8_t* dst;
+	size_t start;
+	size_t end;
+	size_t item_size; // 1, 2, 4 or 8
+	uint64_t flip; // sign bit of signed types, so negative keys order first
+	unsigned int pass;
+	size_t counts[8][DYN_ARRAY_SORT_RADIX_BUCKETS]; // per pass: this chunk's histogram, then its scatter offsets
+};
+
+// Internal use only
+#define __DYN_ARRAY_RADIX_HISTOGRAM__(T) \
+	for (size_t i = args->start; i < args->end; i++) \
+	{ \
+		const uint64_t key = (uint64_t)((const T*)args->src)[i] ^ args->flip; \
+		for (unsigned int p = 0; p < sizeof(T); p++) args->counts[p][(key >> (8 * p)) & 0xFF]++; \
+	}
+
+// Internal use only
+#define __DYN_ARRAY_RADIX_COUNT__(T) \
+	for (size_t i = args->start; i < args->end; i++) \
+	{ \
+		counts[((((uint64_t)((const T*)args->src)[i]) ^ args->flip) >> shift) & 0xFF]++; \
+	}
+
+// Internal use only
+#define __DYN_ARRAY_RADIX_SCATTER__(T) \
+	for (size_t i = args->start; i < args->end; i++) \
+	{ \
+		const T value = ((const T*)args->src)[i]; \
+		((T*)args->dst)[offsets[(((uint64_t)value ^ args->flip) >> shift) & 0xFF]++] = value; \
+	}
+
+// Internal use only; counts every key byte of the chunk in one read
+static inline void __radix_histogram_dyn_array__(void* const arg)
+{
+	struct __dyn_array_radix_args__* const args = (struct __dyn_array_radix_args__*)arg;
+	switch (args->item_size)
+	{
+		case 1: __DYN_ARRAY_RADIX_HISTOGRAM__(uint8_t) break;
+		case 2: __DYN_ARRAY_RADIX_HISTOGRAM__(uint16_t) break;
+		case 4: __DYN_ARRAY_RADIX_HISTOGRAM__(uint32_t) break;
+		default: __DYN_ARRAY_RADIX_HISTOGRAM__(uint64_t) break;
+	}
+}
+
+// Internal use only; recounts one key byte of the chunk (after a scatter, each chunk holds different items)
+static inline void __radix_count_dyn_array__(void* const arg)
+{
+	struct __dyn_array_radix_args__* const args = (struct __dyn_array_radix_args__*)arg;
+	size_t* const counts = args->counts[args->pass];
+	const unsigned int shift = 8 * args->pass;
+	memset(counts, 0, DYN_ARRAY_SORT_RADIX_BUCKETS * sizeof(size_t));
+	switch (args->item_size)
+	{
+		case 1: __DYN_ARRAY_RADIX_COUNT__(uint8_t) break;
+		case 2: __DYN_ARRAY_RADIX_COUNT__(uint16_t) break;
+		case 4: __DYN_ARRAY_RADIX_COUNT__(uint32_t) break;
+		default: __DYN_ARRAY_RADIX_COUNT__(uint64_t) break;
+	}
+}
+
+// Internal use only; moves the chunk's items to their slots for one key byte
+static inline void __radix_scatter_dyn_array__(void* const arg)
+{
+	struct __dyn_array_radix_args__* const args = (struct __dyn_array_radix_args__*)arg;
+	size_t* const offsets = args->counts[args->pass];
+	const unsigned int shift = 8 * args->pass;
+	switch (args->item_size)
+	{
+		case 1: __DYN_ARRAY_RADIX_SCATTER__(uint8_t) break;
+		case 2: __DYN_ARRAY_RADIX_SCATTER__(uint16_t) break;
+		case 4: __DYN_ARRAY_RADIX_SCATTER__(uint32_t) break;
+		default: __DYN_ARRAY_RADIX_SCATTER__(uint64_t) break;
+	}
+}
+
+/*
+	Stable LSD radix sort (ascending) for CHAR, INT, UINT and UINT_* arrays.
+	thread_count: 0 uses get_hardware_thread_count(); arrays below DYN_ARRAY_SORT_PARALLEL_THRESHOLD always use one thread.
+	Returns 0 on success, else 1 (unsupported type or item size; or allocation error, the array is left untouched)
+*/
+static inline int radix_sort_dyn_array(dyn_array* const dyn_struct, const unsigned int thread_count)
+{
+	uint64_t flip = 0;
+	switch (dyn_struct->type)
+	{
+		case DYN_ARRAY_CHAR_TYPE:
+			flip = (CHAR_MIN < 0) ? 0x80 : 0;
+			break;
+		case DYN_ARRAY_INT_TYPE:
+			flip = (uint64_t)1 << (8 * sizeof(int) - 1);
+			break;
+		case DYN_ARRAY_UINT_TYPE:
+		case DYN_ARRAY_UINT_8T_TYPE:
+		case DYN_ARRAY_UINT_16T_TYPE:
+		case DYN_ARRAY_UINT_32T_TYPE:
+		case DYN_ARRAY_UINT_64T_TYPE:
+			break;
+		default:
+			return 1;
+	}
+	const size_t item_size = dyn_struct->item_size;
+	if (item_size != 1 && item_size != 2 && item_size != 4 && item_size != 8) return 1;
+
+	const size_t n = dyn_struct->current_size;
+	if (n < 2) return 0;
+
+	const unsigned int threads = __sort_thread_count_dyn_array__(thread_count, n);
+	uint8_t* const tmp = (uint8_t*)malloc(n * item_size);
+	struct __dyn_array_radix_args__* const args = (struct __dyn_array_radix_args__*)calloc(threads, sizeof(struct __dyn_array_radix_args__));
+	if (tmp == NULL || args == NULL)
+	{
+		free(tmp); free(args);
+		return 1;
+	}
+
+	const size_t chunk = (n + threads - 1) / threads;
+	for (unsigned int t = 0; t < threads; t++)
+	{
+		args[t].src = (const uint8_t*)dyn_struct->data;
+		args[t].start = min((size_t)t * chunk, n);
+		args[t].end = min(args[t].start + chunk, n);
+		args[t].item_size = item_size;
+		args[t].flip = flip;
+	}
+	run_threads(threads, __radix_histogram_dyn_array__, args, sizeof(*args));
+
+	uint8_t* src = (uint8_t*)dyn_struct->data;
+	uint8_t* dst = tmp;
+	uint8_t scattered = 0; // the up-front per-chunk histograms only describe the original order
+	for (unsigned int pass = 0; pass < item_size; pass++)
+	{
+		// Every key shares this byte: the pass would not move anything (totals do not depend on the current order)
+		uint8_t trivial = 0;
+		for (size_t digit = 0; digit < DYN_ARRAY_SORT_RADIX_BUCKETS && !trivial; digit++)
+		{
+			size_t total = 0;
+			for (unsigned int t = 0; t < threads; t++) total += args[t].counts[pass][digit];
+			trivial = (total == n);
+		}
+		if (trivial) continue;
+
+		for (unsigned int t = 0; t < threads; t++)
+		{
+			args[t].src = src;
+			args[t].dst = dst;
+			args[t].pass = pass;
+		}
+		if (threads > 1 && scattered) run_threads(threads, __radix_count_dyn_array__, args, sizeof(*args));
+
+		// Exclusive prefix sum in digit-major, chunk-minor order keeps the sort stable
+		size_t running = 0;
+		for (size_t digit = 0; digit < DYN_ARRAY_SORT_RADIX_BUCKETS; digit++)
+		{
+			for (unsigned int t = 0; t < threads; t++)
+			{
+				const size_t count = args[t].counts[pass][digit];
+				args[t].counts[pass][digit] = running;
+				running += count;
+			}
+		}
+
+		run_threads(threads, __radix_scatter_dyn_array__, args, sizeof(*args));
+		scattered = 1;
+
+		uint8_t* const swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != (uint8_t*)dyn_struct->data) memcpy(dyn_struct->data, src, n * item_size);
+	free(tmp);
+	free(args);
+	return 0;
+}
+
+/*
+	----- Merge sort -----
+*/
+
+struct __dyn_array_sort_context__
+{
+	dyn_array_compare_func compare;
+	const uint8_t* base; // argsort: items are uint64_t indices into base; else NULL
+	size_t base_item_size;
+	size_t width; // bytes per sorted item
+};
+
+// Internal use only
+static inline int __compare_items_dyn_array__(const struct __dyn_array_sort_context__* const context, const uint8_t* const first, const uint8_t* const second)
+{
+	if (context->base == NULL) return context->compare(first, second);
+	return context->compare(context->base + *(const uint64_t*)first * context->base_item_size, context->base + *(const uint64_t*)second * context->base_item_size);
+}
+
+// Internal use only; fixed-size copies for common widths compile to plain moves instead of memcpy calls
+static inline void __copy_item_dyn_array__(uint8_t* const dst, const uint8_t* const src, const size_t width)
+{
+	switch (width)
+	{
+		case 4: memcpy(dst, src, 4); break;
+		case 8: memcpy(dst, src, 8); break;
+		case 16: memcpy(dst, src, 16); break;
+		default: memcpy(dst, src, width); break;
+	}
+}
+
+/*
+	Internal use only
+	Stable merge of left[0..left_count) and right[0..right_count) into out
+*/
+static inline void __merge_runs_dyn_array__(const struct __dyn_array_sort_context__* const context, const uint8_t* left, size_t left_count, const uint8_t* right, size_t right_count, uint8_t* out)
+{
+	const size_t width = context->width;
+	while (left_count != 0 && right_count != 0)
+	{
+		if (__compare_items_dyn_array__(context, right, left) < 0)
+		{
+			__copy_item_dyn_array__(out, right, width);
+			right += width;
+			right_count--;
+		}
+		else
+		{
+			__copy_item_dyn_array__(out, left, width);
+			left += width;
+			left_count--;
+		}
+		out += width;
+	}
+	memcpy(out, left, left_count * width);
+	memcpy(out + left_count * width, right, right_count * width);
+}
+
+/*
+	Internal use only
+	Number of items taken from left among the first `rank` items of the stable merge of left and right
+*/
+static inline size_t __co_rank_dyn_array__(const struct __dyn_array_sort_context__* const context, const uint8_t* const left, const size_t left_count, const uint8_t* const right, const size_t right_count, const size_t rank)
+{
+	const size_t width = context->width;
+	size_t low = (rank > right_count) ? rank - right_count : 0;
+	size_t high = min(rank, left_count);
+	while (low < high)
+	{
+		const size_t i = low + (high - low) / 2;
+		const size_t j = rank - i;
+		// left[i] would still be merged before right[j - 1] (ties go left), so more than i items come from left
+		if (j > 0 && __compare_items_dyn_array__(context, left + i * width, right + (j - 1) * width) <= 0) low = i + 1;
+		else high = i;
+	}
+	return low;
+}
+
+/*
+	Internal use only
+	Sorts data[0..count) with scratch of the same size; the result ends in data
+*/
+static inline void __merge_sort_serial_dyn_array__(const struct __dyn_array_sort_context__* const context, uint8_t* const data, uint8_t* const scratch, const size_t count)
+{
+	const size_t width = context->width;
+
+	// Insertion sort short runs (scratch is free to hold the item being placed)
+	for (size_t run = 0; run < count; run += DYN_ARRAY_SORT_INSERTION_RUN)
+	{
+		const size_t run_end = min(run + DYN_ARRAY_SORT_INSERTION_RUN, count);
+		for (size_t i = run + 1; i < run_end; i++)
+		{
+			size_t j = i;
+			while (j > run && __compare_items_dyn_array__(context, data + (j - 1) * width, data + i * width) > 0) j--;
+			if (j == i) continue;
+			memcpy(scratch, data + i * width, width);
+			memmove(data + (j + 1) * width, data + j * width, (i - j) * width);
+			memcpy(data + j * width, scratch, width);
+		}
+	}
+
+	uint8_t* src = data;
+	uint8_t* dst = scratch;
+	for (size_t run = DYN_ARRAY_SORT_INSERTION_RUN; run < count; run *= 2)
+	{
+		for (size_t left = 0; left < count; left += 2 * run)
+		{
+			const size_t mid = min(left + run, count);
+			const size_t right_end = min(left + 2 * run, count);
+			__merge_runs_dyn_array__(context, src + left * width, mid - left, src + mid * width, right_end - mid, dst + left * width);
+		}
+		uint8_t* const swap = src;
+		src = dst;
+		dst = swap;
+	}
+	if (src != data) memcpy(data, src, count * width);
+}
+
+struct __dyn_array_merge_args__
+{
+	const struct __dyn_array_sort_context__* context;
+	uint8_t* src;
+	uint8_t* dst;
+	size_t start; // first item of the run (pair)
+	size_t mid; // first item of the right run
+	size_t end;
+	size_t rank_start; // slice of the merged output this thread writes, relative to start
+	size_t rank_end;
+};
+
+// Internal use only
+static inline void __merge_sort_chunk_dyn_array__(void* const arg)
+{
+	const struct __dyn_array_merge_args__* const args = (const struct __dyn_array_merge_args__*)arg;
+	const size_t width = args->context->width;
+	__merge_sort_serial_dyn_array__(args->context, args->src + args->start * width, args->dst + args->start * width, args->end - args->start);
+}
+
+// Internal use only; writes one slice of the stable merge of src[start..mid) and src[mid..end) to dst
+static inline void __merge_slice_dyn_array__(void* const arg)
+{
+	const struct __dyn_array_merge_args__* const args = (const struct __dyn_array_merge_args__*)arg;
+	const struct __dyn_array_sort_context__* const context = args->context;
+	const size_t width = context->width;
+	const uint8_t* const left = args->src + args->start * width;
+	const uint8_t* const right = args->src + args->mid * width;
+	const size_t left_count = args->mid - args->start;
+	const size_t right_count = args->end - args->mid;
+
+	const size_t i0 = __co_rank_dyn_array__(context, left, left_count, right, right_count, args->rank_start);
+	const size_t i1 = __co_rank_dyn_array__(context, left, left_count, right, right_count, args->rank_end);
+	const size_t j0 = args->rank_start - i0;
+	const size_t j1 = args->rank_end - i1;
+	__merge_runs_dyn_array__(context, left + i0 * width, i1 - i0, right + j0 * width, j1 - j0, args->dst + (args->start + args->rank_start) * width);
+}
+
+/*
+	Internal use only
+	Sorts data[0..count) of context->width byte items.
+	Returns 0 on success, else 1 (allocation error; data is left untouched)
+*/
+static inline int __merge_sort_dyn_array__(const struct __dyn_array_sort_context__* const context, uint8_t* const data, const size_t count, const unsigned int thread_count)
+{
+	if (count < 2) return 0;
+
+	const unsigned int threads = __sort_thread_count_dyn_array__(thread_count, count);
+	uint8_t* const scratch = (uint8_t*)malloc(count * context->width);
+	struct __dyn_array_merge_args__* const args = (struct __dyn_array_merge_args__*)calloc(threads, sizeof(struct __dyn_array_merge_args__));
+	size_t* const bounds = (size_t*)malloc((threads + 1) * sizeof(size_t));
+	if (scratch == NULL || args == NULL || bounds == NULL)
+	{
+		free(scratch); free(args); free(bounds);
+		return 1;
+	}
+
+	// Sort one chunk per thread
+	const size_t chunk = (count + threads - 1) / threads;
+	for (unsigned int t = 0; t <= threads; t++) bounds[t] = min((size_t)t * chunk, count);
+	for (unsigned int t = 0; t < threads; t++)
+	{
+		args[t].context = context;
+		args[t].src = data;
+		args[t].dst = scratch;
+		args[t].start = bounds[t];
+		args[t].end = bounds[t + 1];
+	}
+	run_threads(threads, __merge_sort_chunk_dyn_array__, args, sizeof(*args));
+
+	// Merge pairs of runs until one remains; each pair's output is split evenly across its share of the threads
+	uint8_t* src = data;
+	uint8_t* dst = scratch;
+	for (unsigned int step = 1; step < threads; step *= 2)
+	{
+		const unsigned int runs = (threads + step - 1) / step;
+		const unsigned int pairs = runs / 2;
+		const unsigned int unpaired = runs % 2;
+		const unsigned int slices_per_pair = (pairs == 0) ? 1 : max(1u, (threads - unpaired) / pairs);
+
+		unsigned int task_count = 0;
+		for (unsigned int r = 0; r < runs; r += 2)
+		{
+			const size_t start = bounds[r * step];
+			const size_t mid = bounds[min((r + 1) * step, threads)];
+			const size_t end = bounds[min((r + 2) * step, threads)];
+			const unsigned int slices = (r + 1 < runs) ? slices_per_pair : 1; // an unpaired run is copied across as is
+			for (unsigned int s = 0; s < slices; s++)
+			{
+				struct __dyn_array_merge_args__* const task = &args[task_count++];
+				task->context = context;
+				task->src = src;
+				task->dst = dst;
+				task->start = start;
+				task->mid = mid;
+				task->end = end;
+				task->rank_start = (end - start) * s / slices;
+				task->rank_end = (end - start) * (s + 1) / slices;
+			}
+		}
+		run_threads(task_count, __merge_slice_dyn_array__, args, sizeof(*args));
+
+		uint8_t* const swap = src;
+		src = dst;
+		dst = swap;
+	}
+	if (src != data) memcpy(data, src, count * context->width);
+
+	free(scratch);
+	free(args);
+	free(bounds);
+	return 0;
+}
+
+/*
+	Stable merge sort with a qsort-style comparator (NULL uses get_default_compare_dyn_array).
+	thread_count: 0 uses get_hardware_thread_count(); arrays below DYN_ARRAY_SORT_PARALLEL_THRESHOLD always use one thread.
+	Returns 0 on success, else 1 (no comparator for the type; or allocation error, the array is left untouched)
+*/
+static inline int merge_sort_dyn_array(dyn_array* const dyn_struct, dyn_array_compare_func compare, const unsigned int thread_count)
+{
+	if (compare == NULL) compare = get_default_compare_dyn_array(dyn_struct->type);
+	if (compare == NULL) return 1;
+
+	const struct __dyn_array_sort_context__ context = { compare, NULL, 0, dyn_struct->item_size };
+	return __merge_sort_dyn_array__(&context, (uint8_t*)dyn_struct->data, dyn_struct->current_size, thread_count);
+}
+
+/*
+	Sorts ascending: radix sort for integer types when compare is NULL, else a stable merge sort with compare
+	(NULL uses get_default_compare_dyn_array, e.g. compareString order for DYN_ARRAY_STRING_TYPE).
+	thread_count: 0 uses get_hardware_thread_count(); arrays below DYN_ARRAY_SORT_PARALLEL_THRESHOLD always use one thread.
+	Returns 0 on success, else 1 (no comparator for the type; or allocation error, the array is left untouched)
+*/
+static inline int sort_dyn_array(dyn_array* const dyn_struct, const dyn_array_compare_func compare, const unsigned int thread_count)
+{
+	if (compare == NULL && radix_sort_dyn_array(dyn_struct, thread_count) == 0) return 0;
+	return merge_sort_dyn_array(dyn_struct, compare, thread_count);
+}
+
+/*
+	Returns a new DYN_ARRAY_UINT_64T_TYPE dyn_array of indices such that data[indices[0]], data[indices[1]], ... is sorted
+	(stable; equal items keep their original order). compare NULL uses get_default_compare_dyn_array.
+	Returns NULL if the type has no comparator or on allocation error
+*/
+static inline dyn_array* argsort_dyn_array(const dyn_array* const dyn_struct, dyn_array_compare_func compare, const unsigned int thread_count)
+{
+	if (compare == NULL) compare = get_default_compare_dyn_array(dyn_struct->type);
+	if (compare == NULL) return NULL;
+
+	dyn_array* const indices = new_dyn_array(DYN_ARRAY_UINT_64T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+	if (indices == NULL) return NULL;
+	if (reserve_dyn_array(indices, dyn_struct->current_size) != 0)
+	{
+		free_dyn_array(indices);
+		return NULL;
+	}
+	for (size_t i = 0; i < dyn_struct->current_size; i++) dyn_get_uint_64t(indices->data, i) = i;
+	indices->current_size = dyn_struct->current_size;
+
+	const struct __dyn_array_sort_context__ context = { compare, (const uint8_t*)dyn_struct->data, dyn_struct->item_size, sizeof(uint64_t) };
+	if (__merge_sort_dyn_array__(&context, (uint8_t*)indices->data, indices->current_size, thread_count) != 0)
+	{
+		free_dyn_array(indices);
+		return NULL;
+	}
+	return indices;
+}
+
+#endif
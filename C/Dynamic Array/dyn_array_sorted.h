@@ -0,0 +1,355 @@
+#ifndef DYN_ARRAY_SORTED_H
+#define DYN_ARRAY_SORTED_H
+
+#include "dyn_array.h"
+#include "dyn_array_sort.h"
+#include "dyn_array_search.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DYN_ARRAY_SORTED_BATCH 16 // needles searched in lockstep by the batch functions
+
+/*
+	Searching sorted (ascending) dyn_arrays.
+	lower_bound / upper_bound / equal_range use a branchless binary search: every search takes the same number of steps,
+	each step is a conditional move rather than a branch, and both possible next probes are prefetched. Numeric types
+	(see dyn_array_search.h) compare inline; a NULL compare on other types uses get_default_compare_dyn_array().
+	For read-mostly arrays, to_eytzinger_dyn_array() copies the items into Eytzinger (breadth-first) order, where the
+	first levels of the implicit tree share cache lines and the children of a node are adjacent, so a search touches
+	far fewer cache lines and can prefetch several levels ahead. The batch functions search many needles in lockstep,
+	so their memory accesses overlap instead of waiting on one another.
+*/
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define __DYN_ARRAY_PREFETCH__(ADDR) __builtin_prefetch((const void*)(ADDR))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <xmmintrin.h>
+	#define __DYN_ARRAY_PREFETCH__(ADDR) _mm_prefetch((const char*)(ADDR), _MM_HINT_T0)
+#else
+	#define __DYN_ARRAY_PREFETCH__(ADDR) ((void)0)
+#endif
+
+// Internal use only; x must be nonzero
+static inline uint32_t __ctz_64_dyn_array__(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (uint32_t)__builtin_ctzll(x);
+#else
+	uint32_t n = 0;
+	while ((x & 1) == 0)
+	{
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+// Internal use only; the side of a probe that holds the bound ("item goes left of the bound")
+#define __DYN_ARRAY_BELOW_LOWER__(ITEM, NEEDLE) ((ITEM) < (NEEDLE))
+#define __DYN_ARRAY_BELOW_UPPER__(ITEM, NEEDLE) ((ITEM) <= (NEEDLE))
+
+/*
+	----- sorted layout -----
+*/
+
+// Internal use only; the bound lies in [base, base + len] throughout
+#define __DYN_ARRAY_BOUND_LOOP__(T, BELOW) \
+	{ \
+		const T* const items = (const T*)data; \
+		T needle; \
+		memcpy(&needle, value, sizeof(T)); \
+		const T* base = items; \
+		size_t len = count; \
+		while (len > 1) \
+		{ \
+			const size_t half = len / 2; \
+			__DYN_ARRAY_PREFETCH__(base + half / 2); \
+			__DYN_ARRAY_PREFETCH__(base + half + half / 2); \
+			base = BELOW(base[half - 1], needle) ? base + half : base; \
+			len -= half; \
+		} \
+		return (size_t)(base - items) + BELOW(*base, needle); \
+	}
+
+#define __DYN_ARRAY_LOWER_BOUND_LOOP__(T) __DYN_ARRAY_BOUND_LOOP__(T, __DYN_ARRAY_BELOW_LOWER__)
+#define __DYN_ARRAY_UPPER_BOUND_LOOP__(T) __DYN_ARRAY_BOUND_LOOP__(T, __DYN_ARRAY_BELOW_UPPER__)
+
+// Internal use only; count must be nonzero
+static inline size_t __lower_bound_numeric_dyn_array__(const uint8_t* const data, const size_t count, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_LOWER_BOUND_LOOP__)
+	return count;
+}
+
+// Internal use only; count must be nonzero
+static inline size_t __upper_bound_numeric_dyn_array__(const uint8_t* const data, const size_t count, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_UPPER_BOUND_LOOP__)
+	return count;
+}
+
+// Internal use only; same steps as __DYN_ARRAY_BOUND_LOOP__ through a comparator. count must be nonzero
+static inline size_t __bound_compare_dyn_array__(const uint8_t* const data, const size_t count, const size_t item_size, const void* const value, const dyn_array_compare_func compare, const uint8_t upper)
+{
+	size_t base = 0;
+	size_t len = count;
+	while (len > 1)
+	{
+		const size_t half = len / 2;
+		__DYN_ARRAY_PREFETCH__(data + (base + half / 2) * item_size);
+		__DYN_ARRAY_PREFETCH__(data + (base + half + half / 2) * item_size);
+		const int order = compare(data + (base + half - 1) * item_size, value);
+		base += ((upper ? order <= 0 : order < 0) ? half : 0);
+		len -= half;
+	}
+	const int order = compare(data + base * item_size, value);
+	return base + (upper ? order <= 0 : order < 0);
+}
+
+// Internal use only
+static inline size_t __bound_dyn_array__(const dyn_array* const dyn_struct, const void* const value, dyn_array_compare_func compare, const uint8_t upper)
+{
+	const size_t count = dyn_struct->current_size;
+	if (count == 0) return 0;
+
+	const uint8_t* const data = (const uint8_t*)dyn_struct->data;
+	if (compare == NULL)
+	{
+		const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(dyn_struct);
+		if (kind != __DYN_ARRAY_SEARCH_NONE__)
+		{
+			return upper ? __upper_bound_numeric_dyn_array__(data, count, kind, value) : __lower_bound_numeric_dyn_array__(data, count, kind, value);
+		}
+		compare = get_default_compare_dyn_array(dyn_struct->type);
+		if (compare == NULL) return count;
+	}
+	return __bound_compare_dyn_array__(data, count, dyn_struct->item_size, value, compare, upper);
+}
+
+/*
+	Index of the first item not less than value (current_size if there is none).
+	compare: ordering the array is sorted by; NULL uses the type's natural order
+	(types without one, such as vectors, matrices and custom types, then always return current_size)
+*/
+static inline size_t lower_bound_dyn_array(const dyn_array* const dyn_struct, const void* const value, const dyn_array_compare_func compare)
+{
+	return __bound_dyn_array__(dyn_struct, value, compare, 0);
+}
+
+/*
+	Index of the first item greater than value (current_size if there is none); compare as for lower_bound_dyn_array
+*/
+static inline size_t upper_bound_dyn_array(const dyn_array* const dyn_struct, const void* const value, const dyn_array_compare_func compare)
+{
+	return __bound_dyn_array__(dyn_struct, value, compare, 1);
+}
+
+/*
+	Range [first, last) of the items equal to value (empty, with first == last, if there are none)
+*/
+static inline void equal_range_dyn_array(const dyn_array* const dyn_struct, const void* const value, const dyn_array_compare_func compare, size_t* const first, size_t* const last)
+{
+	*first = lower_bound_dyn_array(dyn_struct, value, compare);
+	*last = upper_bound_dyn_array(dyn_struct, value, compare);
+}
+
+/*
+	Inserts value (which must not point into this array) after any equal items, keeping the array sorted.
+	Returns the index it was inserted at, or -1 on allocation error
+*/
+static inline int64_t insert_sorted_dyn_array(dyn_array* const dyn_struct, const void* const value, const dyn_array_compare_func compare)
+{
+	const size_t index = upper_bound_dyn_array(dyn_struct, value, compare);
+	if (insert_range_dyn_array(dyn_struct, index, value, 1) != 0) return -1;
+	return (int64_t)index;
+}
+
+// Internal use only; every needle takes the same steps, so a group advances together
+#define __DYN_ARRAY_LOWER_BOUND_BATCH_LOOP__(T) \
+	{ \
+		const T* const items = (const T*)data; \
+		const T* const needles = (const T*)values; \
+		for (size_t g = 0; g < value_count; g += DYN_ARRAY_SORTED_BATCH) \
+		{ \
+			const size_t group = (value_count - g < DYN_ARRAY_SORTED_BATCH) ? value_count - g : DYN_ARRAY_SORTED_BATCH; \
+			const T* base[DYN_ARRAY_SORTED_BATCH]; \
+			for (size_t j = 0; j < group; j++) base[j] = items; \
+			size_t len = count; \
+			while (len > 1) \
+			{ \
+				const size_t half = len / 2; \
+				for (size_t j = 0; j < group; j++) \
+				{ \
+					__DYN_ARRAY_PREFETCH__(base[j] + half / 2); \
+					__DYN_ARRAY_PREFETCH__(base[j] + half + half / 2); \
+					base[j] = (base[j][half - 1] < needles[g + j]) ? base[j] + half : base[j]; \
+				} \
+				len -= half; \
+			} \
+			for (size_t j = 0; j < group; j++) out[g + j] = (size_t)(base[j] - items) + (*base[j] < needles[g + j]); \
+		} \
+	}
+
+/*
+	lower_bound_dyn_array for each of value_count needles in values (items of the array's type), written to out.
+	Numeric types only (see dyn_array_search.h).
+	Returns 0 on success, else 1 (unsupported type)
+*/
+static inline int lower_bound_batch_dyn_array(const dyn_array* const dyn_struct, const void* const values, const size_t value_count, size_t* const out)
+{
+	const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(dyn_struct);
+	if (kind == __DYN_ARRAY_SEARCH_NONE__) return 1;
+
+	const uint8_t* const data = (const uint8_t*)dyn_struct->data;
+	const size_t count = dyn_struct->current_size;
+	if (count == 0)
+	{
+		for (size_t j = 0; j < value_count; j++) out[j] = 0;
+		return 0;
+	}
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_LOWER_BOUND_BATCH_LOOP__)
+	return 0;
+}
+
+/*
+	----- Eytzinger layout -----
+	Node k (1-based) is stored at index k - 1; its children are nodes 2k and 2k + 1.
+*/
+
+// Internal use only; in-order walk of the implicit tree, filling node k onwards from sorted item next. Returns the next unused item
+static inline size_t __build_eytzinger_dyn_array__(const uint8_t* const sorted, uint8_t* const out, const size_t item_size, const size_t count, size_t next, const size_t k)
+{
+	if (k > count) return next;
+	next = __build_eytzinger_dyn_array__(sorted, out, item_size, count, next, 2 * k);
+	memcpy(out + (k - 1) * item_size, sorted + next * item_size, item_size);
+	return __build_eytzinger_dyn_array__(sorted, out, item_size, count, next + 1, 2 * k + 1);
+}
+
+/*
+	Returns a new dyn_array of the same type holding the items of sorted (ascending) in Eytzinger order, or NULL on allocation error.
+	Items are copied bytewise, so the result must not outlive a String array it was built from
+*/
+static inline dyn_array* to_eytzinger_dyn_array(const dyn_array* const sorted)
+{
+	dyn_array* const eytzinger = new_dyn_array(sorted->type, DYN_ARRAY_EXPANSION_DOUBLE);
+	if (eytzinger == NULL) return NULL;
+	eytzinger->item_size = sorted->item_size;
+	if (reserve_dyn_array(eytzinger, sorted->current_size) != 0)
+	{
+		free_dyn_array(eytzinger);
+		return NULL;
+	}
+	__build_eytzinger_dyn_array__((const uint8_t*)sorted->data, (uint8_t*)eytzinger->data, sorted->item_size, sorted->current_size, 0, 1);
+	eytzinger->current_size = sorted->current_size;
+	return eytzinger;
+}
+
+// Internal use only; the node the search ended on, with the trailing right turns (and the final left turn) undone
+static inline size_t __resolve_eytzinger_dyn_array__(const size_t k, const size_t count)
+{
+	const size_t node = k >> (__ctz_64_dyn_array__(~(uint64_t)k) + 1);
+	return (node == 0) ? count : node - 1;
+}
+
+// Internal use only; prefetches the first node DEPTH levels below node k (its 2^DEPTH descendants there share a cache line)
+#define __DYN_ARRAY_PREFETCH_EYTZINGER__(T, K) \
+	__DYN_ARRAY_PREFETCH__((uintptr_t)data + ((K) * (64 / sizeof(T)) - 1) * sizeof(T))
+
+// Internal use only
+#define __DYN_ARRAY_EYTZINGER_LOOP__(T) \
+	{ \
+		const T* const items = (const T*)data; \
+		T needle; \
+		memcpy(&needle, value, sizeof(T)); \
+		size_t k = 1; \
+		while (k <= count) \
+		{ \
+			__DYN_ARRAY_PREFETCH_EYTZINGER__(T, k); \
+			k = 2 * k + (items[k - 1] < needle); \
+		} \
+		return __resolve_eytzinger_dyn_array__(k, count); \
+	}
+
+// Internal use only
+static inline size_t __lower_bound_eytzinger_numeric_dyn_array__(const uint8_t* const data, const size_t count, const enum __dyn_array_search_kind__ kind, const void* const value)
+{
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_EYTZINGER_LOOP__)
+	return count;
+}
+
+/*
+	Index (in eytzinger) of the first item not less than value in sorted order, or current_size if there is none.
+	compare: as for lower_bound_dyn_array
+*/
+static inline size_t lower_bound_eytzinger_dyn_array(const dyn_array* const eytzinger, const void* const value, dyn_array_compare_func compare)
+{
+	const uint8_t* const data = (const uint8_t*)eytzinger->data;
+	const size_t count = eytzinger->current_size;
+
+	if (compare == NULL)
+	{
+		const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(eytzinger);
+		if (kind != __DYN_ARRAY_SEARCH_NONE__) return __lower_bound_eytzinger_numeric_dyn_array__(data, count, kind, value);
+		compare = get_default_compare_dyn_array(eytzinger->type);
+		if (compare == NULL) return count;
+	}
+
+	const size_t item_size = eytzinger->item_size;
+	size_t k = 1;
+	while (k <= count)
+	{
+		__DYN_ARRAY_PREFETCH__((uintptr_t)data + (k * 4 - 1) * item_size); // two levels ahead
+		k = 2 * k + (compare(data + (k - 1) * item_size, value) < 0);
+	}
+	return __resolve_eytzinger_dyn_array__(k, count);
+}
+
+// Internal use only; the first full_levels steps exist for every needle, so a group advances together through them
+#define __DYN_ARRAY_EYTZINGER_BATCH_LOOP__(T) \
+	{ \
+		const T* const items = (const T*)data; \
+		const T* const needles = (const T*)values; \
+		for (size_t g = 0; g < value_count; g += DYN_ARRAY_SORTED_BATCH) \
+		{ \
+			const size_t group = (value_count - g < DYN_ARRAY_SORTED_BATCH) ? value_count - g : DYN_ARRAY_SORTED_BATCH; \
+			size_t k[DYN_ARRAY_SORTED_BATCH]; \
+			for (size_t j = 0; j < group; j++) k[j] = 1; \
+			for (unsigned int level = 0; level < full_levels; level++) \
+			{ \
+				for (size_t j = 0; j < group; j++) \
+				{ \
+					__DYN_ARRAY_PREFETCH_EYTZINGER__(T, k[j]); \
+					k[j] = 2 * k[j] + (items[k[j] - 1] < needles[g + j]); \
+				} \
+			} \
+			for (size_t j = 0; j < group; j++) \
+			{ \
+				while (k[j] <= count) k[j] = 2 * k[j] + (items[k[j] - 1] < needles[g + j]); \
+				out[g + j] = __resolve_eytzinger_dyn_array__(k[j], count); \
+			} \
+		} \
+	}
+
+/*
+	lower_bound_eytzinger_dyn_array for each of value_count needles in values (items of the array's type), written to out.
+	Numeric types only (see dyn_array_search.h).
+	Returns 0 on success, else 1 (unsupported type)
+*/
+static inline int lower_bound_batch_eytzinger_dyn_array(const dyn_array* const eytzinger, const void* const values, const size_t value_count, size_t* const out)
+{
+	const enum __dyn_array_search_kind__ kind = __search_kind_dyn_array__(eytzinger);
+	if (kind == __DYN_ARRAY_SEARCH_NONE__) return 1;
+
+	const uint8_t* const data = (const uint8_t*)eytzinger->data;
+	const size_t count = eytzinger->current_size;
+	unsigned int full_levels = 0; // levels of the tree with no missing nodes
+	while (((size_t)2 << full_levels) - 1 <= count) full_levels++;
+
+	__DYN_ARRAY_SCALAR_SWITCH__(__DYN_ARRAY_EYTZINGER_BATCH_LOOP__)
+	return 0;
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef SEGMENTED_ARRAY_H
+#define SEGMENTED_ARRAY_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SEGMENTED_ARRAY_CHUNK_BYTES (64u * 1024u) // target chunk size when no chunk_shift is given
+#define SEGMENTED_ARRAY_MAX_CHUNK_SHIFT 30
+
+/*
+	Growable array built from a directory of fixed-size chunks of (1 << chunk_shift) items.
+	Items never move once added (until removed), so pointers into the array stay valid while it grows; adding an item
+	allocates at most one new chunk and never copies items. Indexing is one shift, one mask and one directory load.
+	The directory (one pointer per chunk) grows by doubling; that copies only the pointers, and
+	reserve_segmented_array() sizes it up front so that adding items never reallocates anything but new chunks.
+*/
+
+typedef struct segmented_array
+{
+	size_t item_size; // bytes
+	uint8_t chunk_shift; // log2(items per chunk)
+	size_t chunk_mask; // items per chunk - 1
+	size_t current_size; // items
+	size_t chunk_count; // allocated chunks
+	size_t directory_size; // capacity of chunks (pointers)
+	uint8_t** chunks;
+} segmented_array;
+
+// Unchecked; INDEX must be below current_size
+#define seg_get_void_ptr(SEGMENTED_ARRAY_PTR, INDEX) ((void*)((SEGMENTED_ARRAY_PTR)->chunks[(INDEX) >> (SEGMENTED_ARRAY_PTR)->chunk_shift] + ((INDEX) & (SEGMENTED_ARRAY_PTR)->chunk_mask) * (SEGMENTED_ARRAY_PTR)->item_size))
+
+/*
+	chunk_shift: log2 of the items per chunk; 0 picks the largest power of two keeping a chunk within SEGMENTED_ARRAY_CHUNK_BYTES
+*/
+static inline void set_segmented_array(segmented_array* const seg_array, const size_t item_size, uint8_t chunk_shift)
+{
+	if (chunk_shift == 0)
+	{
+		while (chunk_shift < SEGMENTED_ARRAY_MAX_CHUNK_SHIFT && (item_size << (chunk_shift + 1)) <= SEGMENTED_ARRAY_CHUNK_BYTES) chunk_shift++;
+	}
+	if (chunk_shift > SEGMENTED_ARRAY_MAX_CHUNK_SHIFT) chunk_shift = SEGMENTED_ARRAY_MAX_CHUNK_SHIFT;
+
+	seg_array->item_size = item_size;
+	seg_array->chunk_shift = chunk_shift;
+	seg_array->chunk_mask = ((size_t)1 << chunk_shift) - 1;
+	seg_array->current_size = 0;
+	seg_array->chunk_count = 0;
+	seg_array->directory_size = 0;
+	seg_array->chunks = NULL;
+}
+
+static inline segmented_array* new_segmented_array(const size_t item_size, const uint8_t chunk_shift)
+{
+	segmented_array* const seg_array = (segmented_array*)calloc(1, sizeof(segmented_array));
+	if (seg_array == NULL) return NULL;
+	set_segmented_array(seg_array, item_size, chunk_shift);
+	return seg_array;
+}
+
+/*
+	Returns NULL if index is out of range
+*/
+static inline void* get_segmented_array(const segmented_array* const seg_array, const size_t index)
+{
+	if (index >= seg_array->current_size) return NULL;
+	return seg_get_void_ptr(seg_array, index);
+}
+
+static inline void* get_last_segmented_array(const segmented_array* const seg_array)
+{
+	if (seg_array->current_size == 0) return NULL;
+	return seg_get_void_ptr(seg_array, seg_array->current_size - 1);
+}
+
+/*
+	Internal use only
+	Ensures chunks exist for at least chunk_count chunks.
+	Returns 0 on success, else 1 (allocation error; chunks allocated so far are kept)
+*/
+static inline int __reserve_chunks_segmented_array__(segmented_array* const seg_array, const size_t chunk_count)
+{
+	if (chunk_count > seg_array->directory_size)
+	{
+		size_t directory_size = (seg_array->directory_size == 0) ? 4 : seg_array->directory_size;
+		while (directory_size < chunk_count) directory_size *= 2;
+		uint8_t** const chunks = (uint8_t**)realloc(seg_array->chunks, directory_size * sizeof(uint8_t*));
+		if (chunks == NULL) return 1;
+		seg_array->chunks = chunks;
+		seg_array->directory_size = directory_size;
+	}
+
+	const size_t chunk_bytes = seg_array->item_size << seg_array->chunk_shift;
+	while (seg_array->chunk_count < chunk_count)
+	{
+		uint8_t* const chunk = (uint8_t*)malloc(chunk_bytes);
+		if (chunk == NULL) return 1;
+		seg_array->chunks[seg_array->chunk_count++] = chunk;
+	}
+	return 0;
+}
+
+/*
+	Preallocates chunks (and directory room) for at least capacity items.
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int reserve_segmented_array(segmented_array* const seg_array, const size_t capacity)
+{
+	return __reserve_chunks_segmented_array__(seg_array, (capacity + seg_array->chunk_mask) >> seg_array->chunk_shift);
+}
+
+/*
+	Returns the new (uninitialized) last slot, or NULL if a chunk could not be allocated.
+	Existing items keep their addresses
+*/
+static inline void* add_slot_segmented_array(segmented_array* const seg_array)
+{
+	const size_t index = seg_array->current_size;
+	if ((index >> seg_array->chunk_shift) >= seg_array->chunk_count)
+	{
+		if (__reserve_chunks_segmented_array__(seg_array, (index >> seg_array->chunk_shift) + 1) != 0) return NULL;
+	}
+	seg_array->current_size++;
+	return seg_get_void_ptr(seg_array, index);
+}
+
+/*
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int append_item_segmented_array(segmented_array* const seg_array, const void* const item)
+{
+	void* const slot = add_slot_segmented_array(seg_array);
+	if (slot == NULL) return 1;
+	memcpy(slot, item, seg_array->item_size);
+	return 0;
+}
+
+/*
+	Removes the last item, copying it to out if out is not NULL (its chunk stays allocated for reuse).
+	Returns 0 on success, else 1 (empty array)
+*/
+static inline int pop_last_segmented_array(segmented_array* const seg_array, void* const out)
+{
+	if (seg_array->current_size == 0) return 1;
+	seg_array->current_size--;
+	if (out != NULL) memcpy(out, seg_get_void_ptr(seg_array, seg_array->current_size), seg_array->item_size);
+	return 0;
+}
+
+/*
+	Removes the item at index in O(1) by moving the last item into its slot
+	(so only the last item's address changes).
+	Returns 0 on success, else 1 (index out of range)
+*/
+static inline int swap_remove_segmented_array(segmented_array* const seg_array, const size_t index)
+{
+	if (index >= seg_array->current_size) return 1;
+	const size_t last = seg_array->current_size - 1;
+	if (index != last) memcpy(seg_get_void_ptr(seg_array, index), seg_get_void_ptr(seg_array, last), seg_array->item_size);
+	seg_array->current_size--;
+	return 0;
+}
+
+/*
+	Frees chunks past the one holding the last item (the directory keeps its size)
+*/
+static inline void shrink_to_fit_segmented_array(segmented_array* const seg_array)
+{
+	const size_t needed = (seg_array->current_size + seg_array->chunk_mask) >> seg_array->chunk_shift;
+	while (seg_array->chunk_count > needed) free(seg_array->chunks[--seg_array->chunk_count]);
+}
+
+static inline void clean_segmented_array(segmented_array* const seg_array)
+{
+	for (size_t i = 0; i < seg_array->chunk_count; i++) free(seg_array->chunks[i]);
+	free(seg_array->chunks);
+	seg_array->chunks = NULL;
+	seg_array->chunk_count = 0;
+	seg_array->directory_size = 0;
+	seg_array->current_size = 0;
+}
+
+static inline void free_segmented_array(segmented_array* const seg_array)
+{
+	clean_segmented_array(seg_array);
+	free(seg_array);
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef TYPED_DYN_ARRAY_H
+#define TYPED_DYN_ARRAY_H
+
+#include "dyn_array.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+	Compile-time typed counterpart to dyn_array.
+
+	DEFINE_DYN_ARRAY(int_array, int) declares `typedef struct int_array {...} int_array;` holding an `int* data`,
+	plus the functions set_int_array, new_int_array, get_int_array, get_last_int_array, add_slot_int_array,
+	reserve_int_array, append_item_int_array, pop_slot_int_array, strip_int_array, clean_int_array and free_int_array.
+	Element access is a direct typed index (no type switch, no item_size arithmetic), so loops over `data` can be vectorized.
+
+	Accessors are unchecked by default; define DYN_ARRAY_BOUNDS_CHECK before including this header to make
+	get_*() return NULL for out of range indices, like get_dyn_array().
+
+	Growth follows the same dyn_array_expansion_type policies, but buffers are always realloc-backed (no mremap).
+
+	Use dyn_array when the element type is only known at runtime.
+*/
+
+#ifdef DYN_ARRAY_BOUNDS_CHECK
+	#define __TYPED_DYN_ARRAY_CHECK_INDEX__(ARR, INDEX) if ((INDEX) >= (ARR)->current_size) return NULL;
+#else
+	#define __TYPED_DYN_ARRAY_CHECK_INDEX__(ARR, INDEX)
+#endif
+
+#define DEFINE_DYN_ARRAY(NAME, T) \
+typedef struct NAME { \
+	enum dyn_array_expansion_type expansion_type; \
+	size_t current_size; \
+	size_t max_size; \
+	T* data; \
+} NAME; \
+\
+static inline void set_##NAME(NAME* const arr, const enum dyn_array_expansion_type expansion_type) \
+{ \
+	arr->expansion_type = expansion_type; \
+	arr->current_size = 0; \
+	arr->max_size = 0; \
+	arr->data = NULL; \
+} \
+\
+static inline NAME* new_##NAME(const enum dyn_array_expansion_type expansion_type) \
+{ \
+	NAME* const arr = (NAME*)calloc(1, sizeof(NAME)); \
+	if (arr != NULL) set_##NAME(arr, expansion_type); \
+	return arr; \
+} \
+\
+static inline T* get_##NAME(const NAME* const arr, const size_t index) \
+{ \
+	__TYPED_DYN_ARRAY_CHECK_INDEX__(arr, index) \
+	return &arr->data[index]; \
+} \
+\
+static inline T* get_last_##NAME(const NAME* const arr) \
+{ \
+	if (arr->current_size == 0) return NULL; \
+	return &arr->data[arr->current_size - 1]; \
+} \
+\
+/* Returns the new (uninitialized) last slot, or NULL if growing failed */ \
+static inline T* add_slot_##NAME(NAME* const arr) \
+{ \
+	if (arr->current_size == arr->max_size) \
+	{ \
+		const size_t max_size = __next_capacity_dyn_array__(arr->expansion_type, arr->max_size, sizeof(T), arr->current_size + 1); \
+		T* const data = (T*)realloc(arr->data, max_size * sizeof(T)); \
+		if (data == NULL) return NULL; \
+		arr->data = data; \
+		arr->max_size = max_size; \
+	} \
+	return &arr->data[arr->current_size++]; \
+} \
+\
+/* Ensures room for at least capacity items. Returns 0 on success, else 1 (allocation error) */ \
+static inline int reserve_##NAME(NAME* const arr, const size_t capacity) \
+{ \
+	if (capacity <= arr->max_size) return 0; \
+	const size_t max_size = __round_capacity_dyn_array__(arr->expansion_type, sizeof(T), capacity); \
+	T* const data = (T*)realloc(arr->data, max_size * sizeof(T)); \
+	if (data == NULL) return 1; \
+	arr->data = data; \
+	arr->max_size = max_size; \
+	return 0; \
+} \
+\
+/* Returns 0 on success, else 1 (allocation error) */ \
+static inline int append_item_##NAME(NAME* const arr, const T item) \
+{ \
+	T* const slot = add_slot_##NAME(arr); \
+	if (slot == NULL) return 1; \
+	*slot = item; \
+	return 0; \
+} \
+\
+/* Removes the item at index, shifting later items down; copies it to `out` if non-NULL. Returns 0 on success, else 1 (out of range) */ \
+static inline int pop_slot_##NAME(NAME* const arr, const size_t index, T* const out) \
+{ \
+	if (index >= arr->current_size) return 1; \
+	if (out != NULL) *out = arr->data[index]; \
+	memmove(&arr->data[index], &arr->data[index + 1], (arr->current_size - index - 1) * sizeof(T)); \
+	arr->current_size--; \
+	return 0; \
+} \
+\
+static inline int64_t strip_##NAME(NAME* const arr) \
+{ \
+	if (arr->current_size == 0) return -1; \
+	if (arr->current_size < arr->max_size) \
+	{ \
+		T* const data = (T*)realloc(arr->data, arr->current_size * sizeof(T)); \
+		if (data != NULL) \
+		{ \
+			arr->data = data; \
+			arr->max_size = arr->current_size; \
+		} \
+	} \
+	return (int64_t)arr->max_size; \
+} \
+\
+static inline void clean_##NAME(NAME* const arr) \
+{ \
+	free(arr->data); \
+	arr->data = NULL; \
+	arr->current_size = 0; \
+	arr->max_size = 0; \
+} \
+\
+static inline void free_##NAME(NAME* const arr) \
+{ \
+	clean_##NAME(arr); \
+	free(arr); \
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include "..\Strings\String.h"
+#include "..\Memory\allocator.h"
 #include "File_Handling_Standards.h"
 
 enum WriteType {
@@ -15,6 +16,7 @@ struct SaveStateQueue {
 	struct SaveStateQueue* next;
 	enum SaveFileAttributeTypes type;
 	void* data;
+	const allocator* allocator; // every node of the queue comes from the head's allocator; NULL uses malloc / free
 };
 
 struct LoadStateIdList {
@@ -129,7 +131,7 @@ static inline String* getSaveFormatPointerAttribute(String* const buffer, const
 
 static inline int extractObjectId(const String* const buffer)
 {
-	int i = 0;
+	size_t i = 0;
 	int search = 1;
 	while (search)
 	{
@@ -156,7 +158,7 @@ static inline int extractObjectId(const String* const buffer)
 
 static inline void copySplitAttribute(const String* const buffer, String* attribute_name_buffer, String* attribute_value_buffer)
 {
-	int i = 0;
+	size_t i = 0;
 	int search = 1;
 	while (search)
 	{
@@ -177,7 +179,7 @@ static inline void copySplitAttribute(const String* const buffer, String* attrib
 
 static inline void extractAttributeNameCopy(const String* const buffer, String* attribute_name_buffer)
 {
-	int i = 0;
+	size_t i = 0;
 	int search = 1;
 	while (search)
 	{
@@ -198,7 +200,7 @@ static inline void extractAttributeNameCopy(const String* const buffer, String*
 
 static inline void extractAttributeValueCopy(const String* const buffer, String* attribute_value_buffer)
 {
-	int i = 0;
+	size_t i = 0;
 	int search = 1;
 	while (search)
 	{
@@ -258,17 +260,23 @@ static inline int getNextDataPoint(FILE* const fptr, String* buffer)
 //
 //#################################################################################
 
-static inline struct SaveStateQueue* createQueue(const enum SaveFileAttributeTypes type, void* const base_item)
+static inline struct SaveStateQueue* createQueueWithAllocator(const enum SaveFileAttributeTypes type, void* const base_item, const allocator* const alloc)
 {
-	struct SaveStateQueue* item = (struct SaveStateQueue*) calloc(1, sizeof(struct SaveStateQueue));
+	struct SaveStateQueue* item = (struct SaveStateQueue*) mem_calloc(alloc, 1, sizeof(struct SaveStateQueue));
 	
 	item->type = type;
 	item->data = base_item;
 	item->next = NULL;
+	item->allocator = alloc;
 	
 	return item;
 }
 
+static inline struct SaveStateQueue* createQueue(const enum SaveFileAttributeTypes type, void* const base_item)
+{
+	return createQueueWithAllocator(type, base_item, NULL);
+}
+
 static inline void appendToQueue(struct SaveStateQueue* const head_of_queue, const enum SaveFileAttributeTypes type, void* const data)
 {
 	struct SaveStateQueue* base_item = head_of_queue;
@@ -276,24 +284,26 @@ static inline void appendToQueue(struct SaveStateQueue* const head_of_queue, con
 	{
 		base_item = base_item->next;
 	}
-	base_item->next = (struct SaveStateQueue*) calloc(1, sizeof(struct SaveStateQueue));
+	base_item->next = (struct SaveStateQueue*) mem_calloc(head_of_queue->allocator, 1, sizeof(struct SaveStateQueue));
 	
 	base_item = base_item->next;
 	base_item->type = type;
 	base_item->data = data;
 	base_item->next = NULL;
+	base_item->allocator = head_of_queue->allocator;
 }
 
 static inline void cleanUpQueue(struct SaveStateQueue* head_of_queue)
 {
+	const allocator* const alloc = head_of_queue->allocator;
 	struct SaveStateQueue* current_item = head_of_queue;
 	while (current_item->next != NULL)
 	{
 		current_item = current_item->next;
-		free(head_of_queue);
+		mem_free(alloc, head_of_queue, sizeof(struct SaveStateQueue));
 		head_of_queue = current_item;
 	}
-	free(head_of_queue);
+	mem_free(alloc, head_of_queue, sizeof(struct SaveStateQueue));
 }
 //---------------------------------------------------------------------------------
 
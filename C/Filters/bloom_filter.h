@@ -0,0 +1,557 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include "filter_base.h"
+#include "../Bitset/bitset.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+// On x86 with GCC or Clang the blocked probe is compiled for AVX2 regardless of the compiler flags and picked at runtime
+// from the CPU's features; otherwise AVX2 is used only when the compiler targets it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define BLOOM_FILTER_AVX2
+    #if defined(__AVX2__)
+        #define __BLOOM_FILTER_AVX2_TARGET__
+    #else
+        #define BLOOM_FILTER_RUNTIME_DISPATCH
+        #define __BLOOM_FILTER_AVX2_TARGET__ __attribute__((target("avx2")))
+    #endif
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define BLOOM_FILTER_AVX2
+    #define __BLOOM_FILTER_AVX2_TARGET__
+#endif
+
+#define BLOOM_FILTER_SERIAL_MAGIC 0x4D4C4642U // "BFLM"
+#define BLOCKED_BLOOM_FILTER_SERIAL_MAGIC 0x4D4C4242U // "BBLM"
+#define BLOOM_FILTER_SERIAL_VERSION 1U
+#define BLOOM_FILTER_MAX_HASH_COUNT 32
+#define BLOOM_FILTER_BATCH_CHUNK 64 // keys hashed (and prefetched) ahead of testing in batch calls
+#define BLOOM_FILTER_LN2 0.69314718055994530942
+
+/*
+    bloom_filter is the classic layout: k bit positions spread over one m-bit array (enhanced double hashing of one XXH3 digest).
+    blocked_bloom_filter confines every key to one 256-bit block (8 x 32-bit words, one bit set per word) inside a single cache line,
+    so a query costs one cache miss and the 8 bit tests run as one SIMD test when AVX2 is available.
+    For the same memory the blocked variant has a somewhat higher false-positive rate than the classic one.
+*/
+
+typedef struct bloom_filter
+{
+    uint64_t bit_count;  // m
+    uint32_t hash_count; // k
+    uint64_t seed;
+    uint64_t item_count; // inserts performed (duplicates included)
+    bitset bits; // bit_count bits
+} bloom_filter;
+
+typedef struct blocked_bloom_block
+{
+    uint32_t words[8];
+} blocked_bloom_block;
+
+typedef struct blocked_bloom_filter
+{
+    uint64_t block_count;
+    uint64_t seed;
+    uint64_t item_count; // inserts performed (duplicates included)
+    blocked_bloom_block* blocks; // cache line aligned
+} blocked_bloom_filter;
+
+// Internal use only; odd multipliers choosing the bit set in each word of a block
+static const uint32_t __blocked_bloom_salt__[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/**
+ * @brief Returns the optimal bit count for @p expected_items at @p false_positive_rate (m = -n ln p / ln(2)^2), at least 64.
+ */
+static inline uint64_t get_optimal_bit_count_bloom_filter(const uint64_t expected_items, const double false_positive_rate)
+{
+    const double n = (expected_items == 0) ? 1.0 : (double)expected_items;
+    const double p = (false_positive_rate <= 0.0 || false_positive_rate >= 1.0) ? 0.01 : false_positive_rate;
+    const double m = ceil(-n * log(p) / (BLOOM_FILTER_LN2 * BLOOM_FILTER_LN2));
+    return (m < 64.0) ? 64 : (uint64_t)m;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Classic Bloom filter
+// ---------------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes an empty Bloom filter with explicit parameters.
+ * @param bit_count Number of bits (m), rounded up to a multiple of 64.
+ * @param hash_count Number of bit positions per key (k), clamped to [1, BLOOM_FILTER_MAX_HASH_COUNT].
+ * @warning filter->bits.words is NULL if the allocation failed.
+ */
+static inline void set_bloom_filter_explicit(bloom_filter* const filter, uint64_t bit_count, uint32_t hash_count, const uint64_t seed)
+{
+    if (bit_count < 64) bit_count = 64;
+    if (hash_count < 1) hash_count = 1;
+    if (hash_count > BLOOM_FILTER_MAX_HASH_COUNT) hash_count = BLOOM_FILTER_MAX_HASH_COUNT;
+
+    filter->bit_count = (bit_count + 63) & ~(uint64_t)63;
+    filter->hash_count = hash_count;
+    filter->seed = seed;
+    filter->item_count = 0;
+    set_bitset(&filter->bits, filter->bit_count);
+}
+
+/**
+ * @brief Initializes an empty Bloom filter sized for @p expected_items at @p false_positive_rate.
+ */
+static inline void set_bloom_filter(bloom_filter* const filter, const uint64_t expected_items, const double false_positive_rate, const uint64_t seed)
+{
+    const uint64_t bit_count = get_optimal_bit_count_bloom_filter(expected_items, false_positive_rate);
+    const double n = (expected_items == 0) ? 1.0 : (double)expected_items;
+    const uint32_t hash_count = (uint32_t)lround((double)bit_count / n * BLOOM_FILTER_LN2);
+    set_bloom_filter_explicit(filter, bit_count, hash_count, seed);
+}
+
+static inline bloom_filter* new_bloom_filter(const uint64_t expected_items, const double false_positive_rate, const uint64_t seed)
+{
+    bloom_filter* const filter = (bloom_filter*)calloc(1, sizeof(bloom_filter));
+    if (filter == NULL) return NULL;
+    set_bloom_filter(filter, expected_items, false_positive_rate, seed);
+    if (filter->bits.words == NULL) { free(filter); return NULL; }
+    return filter;
+}
+
+// Internal use only
+static inline void __insert_hash_bloom_filter__(bloom_filter* const filter, const uint64_t hash)
+{
+    uint64_t a = hash;
+    uint64_t b = (hash >> 32) | (hash << 32);
+    for (uint32_t i = 0; i < filter->hash_count; i++)
+    {
+        const uint64_t bit = a % filter->bit_count;
+        set_bit_bitset(&filter->bits, bit);
+        a += b;
+        b += i;
+    }
+    filter->item_count++;
+}
+
+// Internal use only
+static inline uint8_t __query_hash_bloom_filter__(const bloom_filter* const filter, const uint64_t hash)
+{
+    uint64_t a = hash;
+    uint64_t b = (hash >> 32) | (hash << 32);
+    for (uint32_t i = 0; i < filter->hash_count; i++)
+    {
+        const uint64_t bit = a % filter->bit_count;
+        if (!test_bit_bitset(&filter->bits, bit)) return 0;
+        a += b;
+        b += i;
+    }
+    return 1;
+}
+
+static inline void insert_bloom_filter(bloom_filter* const filter, const void* const key, const size_t key_size)
+{
+    __insert_hash_bloom_filter__(filter, __filter_hash__(key, key_size, filter->seed));
+}
+
+/**
+ * @return 0 if the key is definitely absent, 1 if it is possibly present.
+ */
+static inline uint8_t query_bloom_filter(const bloom_filter* const filter, const void* const key, const size_t key_size)
+{
+    return __query_hash_bloom_filter__(filter, __filter_hash__(key, key_size, filter->seed));
+}
+
+/**
+ * @brief Inserts @p count keys stored contiguously, @p key_size bytes each.
+ */
+static inline void insert_batch_bloom_filter(bloom_filter* const filter, const void* const keys, const size_t key_size, const uint64_t count)
+{
+    for (uint64_t i = 0; i < count; i++)
+    {
+        insert_bloom_filter(filter, (const uint8_t*)keys + i * key_size, key_size);
+    }
+}
+
+/**
+ * @brief Queries @p count keys stored contiguously, @p key_size bytes each.
+ * Hashes are computed a chunk at a time and the first probed word of each key is prefetched ahead of its test.
+ * @param results Receives 0 (absent) or 1 (possibly present) per key.
+ * @return The number of keys reported as possibly present.
+ */
+static inline uint64_t query_batch_bloom_filter(const bloom_filter* const filter, const void* const keys, const size_t key_size, const uint64_t count, uint8_t* const results)
+{
+    uint64_t hashes[BLOOM_FILTER_BATCH_CHUNK];
+    uint64_t positives = 0;
+
+    for (uint64_t start = 0; start < count; start += BLOOM_FILTER_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < BLOOM_FILTER_BATCH_CHUNK) ? count - start : BLOOM_FILTER_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            hashes[i] = __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, filter->seed);
+            __filter_prefetch__(&filter->bits.words[(hashes[i] % filter->bit_count) >> 6]);
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            results[start + i] = __query_hash_bloom_filter__(filter, hashes[i]);
+            positives += results[start + i];
+        }
+    }
+    return positives;
+}
+
+/**
+ * @brief Estimated false-positive rate at the current fill: (1 - e^(-kn/m))^k.
+ */
+static inline double get_false_positive_rate_bloom_filter(const bloom_filter* const filter)
+{
+    const double k = (double)filter->hash_count;
+    return pow(1.0 - exp(-k * (double)filter->item_count / (double)filter->bit_count), k);
+}
+
+/**
+ * @brief Fraction of bits set (a SIMD popcount over the filter); the false-positive rate is about this to the power k.
+ */
+static inline double get_fill_ratio_bloom_filter(const bloom_filter* const filter)
+{
+    return (double)popcount_bitset(&filter->bits) / (double)filter->bit_count;
+}
+
+static inline void clear_bloom_filter(bloom_filter* const filter)
+{
+    clear_all_bitset(&filter->bits);
+    filter->item_count = 0;
+}
+
+static inline uint64_t get_serialized_size_bloom_filter(const bloom_filter* const filter)
+{
+    return 4 + 4 + 8 + 4 + 8 + 8 + filter->bit_count / 8;
+}
+
+/**
+ * @brief Writes the filter to @p buffer, which must hold get_serialized_size_bloom_filter() bytes.
+ * @return The number of bytes written.
+ */
+static inline uint64_t serialize_bloom_filter(const bloom_filter* const filter, uint8_t* const buffer)
+{
+    uint8_t* ptr = buffer;
+    ptr = __filter_write_u32__(ptr, BLOOM_FILTER_SERIAL_MAGIC);
+    ptr = __filter_write_u32__(ptr, BLOOM_FILTER_SERIAL_VERSION);
+    ptr = __filter_write_u64__(ptr, filter->bit_count);
+    ptr = __filter_write_u32__(ptr, filter->hash_count);
+    ptr = __filter_write_u64__(ptr, filter->seed);
+    ptr = __filter_write_u64__(ptr, filter->item_count);
+    for (uint64_t i = 0; i < filter->bit_count / 64; i++)
+    {
+        ptr = __filter_write_u64__(ptr, filter->bits.words[i]);
+    }
+    return (uint64_t)(ptr - buffer);
+}
+
+/**
+ * @brief Rebuilds a filter written by serialize_bloom_filter().
+ * @return The new filter, or NULL if the buffer is malformed or allocation failed.
+ */
+static inline bloom_filter* deserialize_bloom_filter(const uint8_t* const buffer, const uint64_t size)
+{
+    if (size < 36) return NULL;
+
+    const uint8_t* ptr = buffer;
+    uint32_t magic, version, hash_count;
+    uint64_t bit_count, seed, item_count;
+    ptr = __filter_read_u32__(ptr, &magic);
+    ptr = __filter_read_u32__(ptr, &version);
+    ptr = __filter_read_u64__(ptr, &bit_count);
+    ptr = __filter_read_u32__(ptr, &hash_count);
+    ptr = __filter_read_u64__(ptr, &seed);
+    ptr = __filter_read_u64__(ptr, &item_count);
+
+    if (magic != BLOOM_FILTER_SERIAL_MAGIC || version != BLOOM_FILTER_SERIAL_VERSION) return NULL;
+    if (bit_count == 0 || (bit_count & 63) != 0 || hash_count == 0 || hash_count > BLOOM_FILTER_MAX_HASH_COUNT) return NULL;
+    if ((size - 36) / 8 < bit_count / 64) return NULL;
+
+    bloom_filter* const filter = (bloom_filter*)calloc(1, sizeof(bloom_filter));
+    if (filter == NULL) return NULL;
+    set_bloom_filter_explicit(filter, bit_count, hash_count, seed);
+    if (filter->bits.words == NULL) { free(filter); return NULL; }
+
+    filter->item_count = item_count;
+    for (uint64_t i = 0; i < bit_count / 64; i++)
+    {
+        ptr = __filter_read_u64__(ptr, &filter->bits.words[i]);
+    }
+    return filter;
+}
+
+static inline void clean_bloom_filter(bloom_filter* const filter)
+{
+    clean_bitset(&filter->bits);
+    filter->bit_count = 0;
+    filter->item_count = 0;
+}
+
+static inline void free_bloom_filter(bloom_filter* const filter)
+{
+    clean_bloom_filter(filter);
+    free(filter);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Blocked Bloom filter
+// ---------------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes an empty blocked Bloom filter with @p block_count 256-bit blocks.
+ * @warning filter->blocks is NULL if the allocation failed.
+ */
+static inline void set_blocked_bloom_filter_explicit(blocked_bloom_filter* const filter, uint64_t block_count, const uint64_t seed)
+{
+    if (block_count < 1) block_count = 1;
+    if (block_count > UINT32_MAX) block_count = UINT32_MAX;
+
+    filter->block_count = block_count;
+    filter->seed = seed;
+    filter->item_count = 0;
+    filter->blocks = (blocked_bloom_block*)__filter_aligned_calloc__(block_count * sizeof(blocked_bloom_block));
+}
+
+/**
+ * @brief Initializes an empty blocked Bloom filter with the classic optimal bit count for @p expected_items at @p false_positive_rate.
+ */
+static inline void set_blocked_bloom_filter(blocked_bloom_filter* const filter, const uint64_t expected_items, const double false_positive_rate, const uint64_t seed)
+{
+    const uint64_t bit_count = get_optimal_bit_count_bloom_filter(expected_items, false_positive_rate);
+    set_blocked_bloom_filter_explicit(filter, (bit_count + 255) / 256, seed);
+}
+
+static inline blocked_bloom_filter* new_blocked_bloom_filter(const uint64_t expected_items, const double false_positive_rate, const uint64_t seed)
+{
+    blocked_bloom_filter* const filter = (blocked_bloom_filter*)calloc(1, sizeof(blocked_bloom_filter));
+    if (filter == NULL) return NULL;
+    set_blocked_bloom_filter(filter, expected_items, false_positive_rate, seed);
+    if (filter->blocks == NULL) { free(filter); return NULL; }
+    return filter;
+}
+
+// Internal use only; top 32 bits pick the block (multiply-shift range reduction), bottom 32 bits pick the bits within it
+static inline blocked_bloom_block* __get_block_blocked_bloom_filter__(const blocked_bloom_filter* const filter, const uint64_t hash)
+{
+    return &filter->blocks[((hash >> 32) * filter->block_count) >> 32];
+}
+
+// Internal use only
+static inline uint8_t __has_avx2_bloom_filter__(void)
+{
+#if defined(BLOOM_FILTER_RUNTIME_DISPATCH)
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+#elif defined(BLOOM_FILTER_AVX2)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+#if defined(BLOOM_FILTER_AVX2)
+
+// Internal use only; the 8 single-bit word masks of key
+__BLOOM_FILTER_AVX2_TARGET__ static inline __m256i __mask_avx2_blocked_bloom_filter__(const uint32_t key)
+{
+    const __m256i salt = _mm256_loadu_si256((const __m256i*)__blocked_bloom_salt__);
+    const __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), salt), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+}
+
+// Internal use only
+__BLOOM_FILTER_AVX2_TARGET__ static inline void __insert_avx2_blocked_bloom_filter__(blocked_bloom_block* const block, const uint32_t key)
+{
+    _mm256_store_si256((__m256i*)block->words, _mm256_or_si256(_mm256_load_si256((const __m256i*)block->words), __mask_avx2_blocked_bloom_filter__(key)));
+}
+
+// Internal use only
+__BLOOM_FILTER_AVX2_TARGET__ static inline uint8_t __query_avx2_blocked_bloom_filter__(const blocked_bloom_block* const block, const uint32_t key)
+{
+    return (uint8_t)_mm256_testc_si256(_mm256_load_si256((const __m256i*)block->words), __mask_avx2_blocked_bloom_filter__(key));
+}
+
+#endif
+
+// Internal use only
+static inline void __insert_hash_blocked_bloom_filter__(blocked_bloom_filter* const filter, const uint64_t hash)
+{
+    blocked_bloom_block* const block = __get_block_blocked_bloom_filter__(filter, hash);
+    const uint32_t key = (uint32_t)hash;
+    filter->item_count++;
+#if defined(BLOOM_FILTER_AVX2)
+    if (__has_avx2_bloom_filter__())
+    {
+        __insert_avx2_blocked_bloom_filter__(block, key);
+        return;
+    }
+#endif
+    for (int i = 0; i < 8; i++)
+    {
+        block->words[i] |= 1U << ((key * __blocked_bloom_salt__[i]) >> 27);
+    }
+}
+
+// Internal use only
+static inline uint8_t __query_hash_blocked_bloom_filter__(const blocked_bloom_filter* const filter, const uint64_t hash)
+{
+    const blocked_bloom_block* const block = __get_block_blocked_bloom_filter__(filter, hash);
+    const uint32_t key = (uint32_t)hash;
+#if defined(BLOOM_FILTER_AVX2)
+    if (__has_avx2_bloom_filter__()) return __query_avx2_blocked_bloom_filter__(block, key);
+#endif
+    uint32_t missing = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        missing |= ~block->words[i] & (1U << ((key * __blocked_bloom_salt__[i]) >> 27));
+    }
+    return missing == 0;
+}
+
+static inline void insert_blocked_bloom_filter(blocked_bloom_filter* const filter, const void* const key, const size_t key_size)
+{
+    __insert_hash_blocked_bloom_filter__(filter, __filter_hash__(key, key_size, filter->seed));
+}
+
+/**
+ * @return 0 if the key is definitely absent, 1 if it is possibly present.
+ */
+static inline uint8_t query_blocked_bloom_filter(const blocked_bloom_filter* const filter, const void* const key, const size_t key_size)
+{
+    return __query_hash_blocked_bloom_filter__(filter, __filter_hash__(key, key_size, filter->seed));
+}
+
+/**
+ * @brief Inserts @p count keys stored contiguously, @p key_size bytes each.
+ */
+static inline void insert_batch_blocked_bloom_filter(blocked_bloom_filter* const filter, const void* const keys, const size_t key_size, const uint64_t count)
+{
+    uint64_t hashes[BLOOM_FILTER_BATCH_CHUNK];
+
+    for (uint64_t start = 0; start < count; start += BLOOM_FILTER_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < BLOOM_FILTER_BATCH_CHUNK) ? count - start : BLOOM_FILTER_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            hashes[i] = __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, filter->seed);
+            __filter_prefetch__(__get_block_blocked_bloom_filter__(filter, hashes[i]));
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            __insert_hash_blocked_bloom_filter__(filter, hashes[i]);
+        }
+    }
+}
+
+/**
+ * @brief Queries @p count keys stored contiguously, @p key_size bytes each.
+ * Hashes are computed a chunk at a time and every target block is prefetched before the tests run.
+ * @param results Receives 0 (absent) or 1 (possibly present) per key.
+ * @return The number of keys reported as possibly present.
+ */
+static inline uint64_t query_batch_blocked_bloom_filter(const blocked_bloom_filter* const filter, const void* const keys, const size_t key_size, const uint64_t count, uint8_t* const results)
+{
+    uint64_t hashes[BLOOM_FILTER_BATCH_CHUNK];
+    uint64_t positives = 0;
+
+    for (uint64_t start = 0; start < count; start += BLOOM_FILTER_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < BLOOM_FILTER_BATCH_CHUNK) ? count - start : BLOOM_FILTER_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            hashes[i] = __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, filter->seed);
+            __filter_prefetch__(__get_block_blocked_bloom_filter__(filter, hashes[i]));
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            results[start + i] = __query_hash_blocked_bloom_filter__(filter, hashes[i]);
+            positives += results[start + i];
+        }
+    }
+    return positives;
+}
+
+static inline void clear_blocked_bloom_filter(blocked_bloom_filter* const filter)
+{
+    memset(filter->blocks, 0, filter->block_count * sizeof(blocked_bloom_block));
+    filter->item_count = 0;
+}
+
+static inline uint64_t get_serialized_size_blocked_bloom_filter(const blocked_bloom_filter* const filter)
+{
+    return 4 + 4 + 8 + 8 + 8 + filter->block_count * sizeof(blocked_bloom_block);
+}
+
+/**
+ * @brief Writes the filter to @p buffer, which must hold get_serialized_size_blocked_bloom_filter() bytes.
+ * @return The number of bytes written.
+ */
+static inline uint64_t serialize_blocked_bloom_filter(const blocked_bloom_filter* const filter, uint8_t* const buffer)
+{
+    uint8_t* ptr = buffer;
+    ptr = __filter_write_u32__(ptr, BLOCKED_BLOOM_FILTER_SERIAL_MAGIC);
+    ptr = __filter_write_u32__(ptr, BLOOM_FILTER_SERIAL_VERSION);
+    ptr = __filter_write_u64__(ptr, filter->block_count);
+    ptr = __filter_write_u64__(ptr, filter->seed);
+    ptr = __filter_write_u64__(ptr, filter->item_count);
+    for (uint64_t i = 0; i < filter->block_count; i++)
+    {
+        for (int j = 0; j < 8; j++) ptr = __filter_write_u32__(ptr, filter->blocks[i].words[j]);
+    }
+    return (uint64_t)(ptr - buffer);
+}
+
+/**
+ * @brief Rebuilds a filter written by serialize_blocked_bloom_filter().
+ * @return The new filter, or NULL if the buffer is malformed or allocation failed.
+ */
+static inline blocked_bloom_filter* deserialize_blocked_bloom_filter(const uint8_t* const buffer, const uint64_t size)
+{
+    if (size < 32) return NULL;
+
+    const uint8_t* ptr = buffer;
+    uint32_t magic, version;
+    uint64_t block_count, seed, item_count;
+    ptr = __filter_read_u32__(ptr, &magic);
+    ptr = __filter_read_u32__(ptr, &version);
+    ptr = __filter_read_u64__(ptr, &block_count);
+    ptr = __filter_read_u64__(ptr, &seed);
+    ptr = __filter_read_u64__(ptr, &item_count);
+
+    if (magic != BLOCKED_BLOOM_FILTER_SERIAL_MAGIC || version != BLOOM_FILTER_SERIAL_VERSION) return NULL;
+    if (block_count == 0 || block_count > UINT32_MAX) return NULL;
+    if ((size - 32) / sizeof(blocked_bloom_block) < block_count) return NULL;
+
+    blocked_bloom_filter* const filter = (blocked_bloom_filter*)calloc(1, sizeof(blocked_bloom_filter));
+    if (filter == NULL) return NULL;
+    set_blocked_bloom_filter_explicit(filter, block_count, seed);
+    if (filter->blocks == NULL) { free(filter); return NULL; }
+
+    filter->item_count = item_count;
+    for (uint64_t i = 0; i < block_count; i++)
+    {
+        for (int j = 0; j < 8; j++) ptr = __filter_read_u32__(ptr, &filter->blocks[i].words[j]);
+    }
+    return filter;
+}
+
+static inline void clean_blocked_bloom_filter(blocked_bloom_filter* const filter)
+{
+    __aligned_free_memory__(filter->blocks);
+    filter->blocks = NULL;
+    filter->block_count = 0;
+    filter->item_count = 0;
+}
+
+static inline void free_blocked_bloom_filter(blocked_bloom_filter* const filter)
+{
+    clean_blocked_bloom_filter(filter);
+    free(filter);
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include "filter_base.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CUCKOO_FILTER_BUCKET_SIZE 4
+#define CUCKOO_FILTER_MAX_KICKS 500
+#define CUCKOO_FILTER_TARGET_LOAD 0.95 // buckets are sized so the expected items fill at most this fraction of the slots
+#define CUCKOO_FILTER_SERIAL_MAGIC 0x544C4643U // "CFLT"
+#define CUCKOO_FILTER_SERIAL_VERSION 1U
+#define CUCKOO_FILTER_BATCH_CHUNK 64 // keys hashed (and prefetched) ahead of testing in batch calls
+
+/*
+    A cuckoo filter stores a 16-bit fingerprint of each key in one of two 4-slot buckets (partial-key cuckoo hashing),
+    giving a false-positive rate of about 8 / 2^16 while, unlike a Bloom filter, supporting deletes.
+    A bucket is 8 bytes, so all four slots are compared at once with word-level (SWAR) arithmetic.
+    If an insert can not find room after CUCKOO_FILTER_MAX_KICKS evictions the last evicted fingerprint is kept aside
+    and the filter reports itself full; nothing that was inserted is ever lost.
+*/
+
+typedef struct cuckoo_filter
+{
+    uint64_t bucket_count; // power of 2
+    uint64_t seed;
+    uint64_t item_count;
+    uint16_t* slots; // bucket_count * CUCKOO_FILTER_BUCKET_SIZE fingerprints; 0 marks an empty slot
+    uint8_t has_victim;
+    uint16_t victim_fingerprint;
+    uint64_t victim_bucket;
+} cuckoo_filter;
+
+/**
+ * @brief Initializes an empty cuckoo filter with @p bucket_count buckets (rounded up to a power of 2).
+ * @warning filter->slots is NULL if the allocation failed.
+ */
+static inline void set_cuckoo_filter_explicit(cuckoo_filter* const filter, const uint64_t bucket_count, const uint64_t seed)
+{
+    uint64_t buckets = 1;
+    while (buckets < bucket_count) buckets <<= 1;
+
+    filter->bucket_count = buckets;
+    filter->seed = seed;
+    filter->item_count = 0;
+    filter->has_victim = 0;
+    filter->victim_fingerprint = 0;
+    filter->victim_bucket = 0;
+    filter->slots = (uint16_t*)__filter_aligned_calloc__(buckets * CUCKOO_FILTER_BUCKET_SIZE * sizeof(uint16_t));
+}
+
+/**
+ * @brief Initializes an empty cuckoo filter with room for @p expected_items.
+ */
+static inline void set_cuckoo_filter(cuckoo_filter* const filter, const uint64_t expected_items, const uint64_t seed)
+{
+    const uint64_t slots_needed = (uint64_t)((double)expected_items / CUCKOO_FILTER_TARGET_LOAD) + 1;
+    set_cuckoo_filter_explicit(filter, (slots_needed + CUCKOO_FILTER_BUCKET_SIZE - 1) / CUCKOO_FILTER_BUCKET_SIZE, seed);
+}
+
+static inline cuckoo_filter* new_cuckoo_filter(const uint64_t expected_items, const uint64_t seed)
+{
+    cuckoo_filter* const filter = (cuckoo_filter*)calloc(1, sizeof(cuckoo_filter));
+    if (filter == NULL) return NULL;
+    set_cuckoo_filter(filter, expected_items, seed);
+    if (filter->slots == NULL) { free(filter); return NULL; }
+    return filter;
+}
+
+// Internal use only
+static inline uint16_t __fingerprint_cuckoo_filter__(const uint64_t hash)
+{
+    const uint16_t fingerprint = (uint16_t)(hash >> 48);
+    return (fingerprint == 0) ? 1 : fingerprint;
+}
+
+// Internal use only
+static inline uint64_t __alt_bucket_cuckoo_filter__(const cuckoo_filter* const filter, const uint64_t bucket, const uint16_t fingerprint)
+{
+    return (bucket ^ ((uint64_t)fingerprint * 0x5bd1e995U)) & (filter->bucket_count - 1);
+}
+
+// Internal use only
+static inline uint16_t* __get_bucket_cuckoo_filter__(const cuckoo_filter* const filter, const uint64_t bucket)
+{
+    return filter->slots + bucket * CUCKOO_FILTER_BUCKET_SIZE;
+}
+
+// Internal use only; returns a mask with bit 15 of each 16-bit lane set where the lane equals `fingerprint`
+static inline uint64_t __match_bucket_cuckoo_filter__(const uint16_t* const bucket, const uint16_t fingerprint)
+{
+    uint64_t lanes;
+    memcpy(&lanes, bucket, sizeof(lanes));
+    const uint64_t diff = lanes ^ ((uint64_t)fingerprint * 0x0001000100010001ULL);
+    return (diff - 0x0001000100010001ULL) & ~diff & 0x8000800080008000ULL;
+}
+
+// Internal use only
+static inline uint8_t __bucket_contains_cuckoo_filter__(const uint16_t* const bucket, const uint16_t fingerprint)
+{
+    // The borrow trick only flags a lane spuriously when a lower lane really matched, so any set bit means a match
+    return __match_bucket_cuckoo_filter__(bucket, fingerprint) != 0;
+}
+
+// Internal use only
+static inline uint8_t __bucket_insert_cuckoo_filter__(uint16_t* const bucket, const uint16_t fingerprint)
+{
+    for (int i = 0; i < CUCKOO_FILTER_BUCKET_SIZE; i++)
+    {
+        if (bucket[i] == 0)
+        {
+            bucket[i] = fingerprint;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Internal use only
+static inline uint8_t __bucket_delete_cuckoo_filter__(uint16_t* const bucket, const uint16_t fingerprint)
+{
+    for (int i = 0; i < CUCKOO_FILTER_BUCKET_SIZE; i++)
+    {
+        if (bucket[i] == fingerprint)
+        {
+            bucket[i] = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Internal use only
+static inline uint8_t __query_hash_cuckoo_filter__(const cuckoo_filter* const filter, const uint64_t hash)
+{
+    const uint16_t fingerprint = __fingerprint_cuckoo_filter__(hash);
+    const uint64_t first = hash & (filter->bucket_count - 1);
+    const uint64_t second = __alt_bucket_cuckoo_filter__(filter, first, fingerprint);
+
+    if (__bucket_contains_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, first), fingerprint)) return 1;
+    if (__bucket_contains_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, second), fingerprint)) return 1;
+    return filter->has_victim && filter->victim_fingerprint == fingerprint && (filter->victim_bucket == first || filter->victim_bucket == second);
+}
+
+/**
+ * Inserts a key; inserting the same key twice stores it twice (and it must then be deleted twice).
+ * @return Returns 0 on success, else 1 if the filter is full (the key was not inserted)
+ */
+static inline uint8_t insert_cuckoo_filter(cuckoo_filter* const filter, const void* const key, const size_t key_size)
+{
+    if (filter->has_victim) return 1;
+
+    const uint64_t hash = __filter_hash__(key, key_size, filter->seed);
+    uint16_t fingerprint = __fingerprint_cuckoo_filter__(hash);
+    uint64_t bucket = hash & (filter->bucket_count - 1);
+
+    if (__bucket_insert_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, bucket), fingerprint)
+        || __bucket_insert_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, __alt_bucket_cuckoo_filter__(filter, bucket, fingerprint)), fingerprint))
+    {
+        filter->item_count++;
+        return 0;
+    }
+
+    // Both buckets full: evict fingerprints along a random walk until one lands in a free slot
+    uint64_t walk = hash | 1;
+    if ((walk >> 40) & 1) bucket = __alt_bucket_cuckoo_filter__(filter, bucket, fingerprint);
+    for (int kick = 0; kick < CUCKOO_FILTER_MAX_KICKS; kick++)
+    {
+        walk ^= walk << 13;
+        walk ^= walk >> 7;
+        walk ^= walk << 17;
+
+        uint16_t* const slots = __get_bucket_cuckoo_filter__(filter, bucket);
+        const int slot = (int)(walk % CUCKOO_FILTER_BUCKET_SIZE);
+        const uint16_t evicted = slots[slot];
+        slots[slot] = fingerprint;
+        fingerprint = evicted;
+        bucket = __alt_bucket_cuckoo_filter__(filter, bucket, fingerprint);
+
+        if (__bucket_insert_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, bucket), fingerprint))
+        {
+            filter->item_count++;
+            return 0;
+        }
+    }
+
+    filter->has_victim = 1;
+    filter->victim_fingerprint = fingerprint;
+    filter->victim_bucket = bucket;
+    filter->item_count++;
+    return 0;
+}
+
+/**
+ * @return 0 if the key is definitely absent, 1 if it is possibly present.
+ */
+static inline uint8_t query_cuckoo_filter(const cuckoo_filter* const filter, const void* const key, const size_t key_size)
+{
+    return __query_hash_cuckoo_filter__(filter, __filter_hash__(key, key_size, filter->seed));
+}
+
+/**
+ * Deletes one copy of a key.
+ * @warning Only delete keys that were inserted; deleting a false positive removes another key's fingerprint.
+ * @return Returns 0 on success, else 1 if the key was not found
+ */
+static inline uint8_t delete_cuckoo_filter(cuckoo_filter* const filter, const void* const key, const size_t key_size)
+{
+    const uint64_t hash = __filter_hash__(key, key_size, filter->seed);
+    const uint16_t fingerprint = __fingerprint_cuckoo_filter__(hash);
+    const uint64_t first = hash & (filter->bucket_count - 1);
+    const uint64_t second = __alt_bucket_cuckoo_filter__(filter, first, fingerprint);
+
+    if (filter->has_victim && filter->victim_fingerprint == fingerprint && (filter->victim_bucket == first || filter->victim_bucket == second))
+    {
+        filter->has_victim = 0;
+        filter->item_count--;
+        return 0;
+    }
+
+    if (!__bucket_delete_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, first), fingerprint)
+        && !__bucket_delete_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, second), fingerprint))
+    {
+        return 1;
+    }
+    filter->item_count--;
+
+    // A slot just opened up, so the set-aside fingerprint may fit again
+    if (filter->has_victim)
+    {
+        const uint64_t victim_alt = __alt_bucket_cuckoo_filter__(filter, filter->victim_bucket, filter->victim_fingerprint);
+        if (__bucket_insert_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, filter->victim_bucket), filter->victim_fingerprint)
+            || __bucket_insert_cuckoo_filter__(__get_bucket_cuckoo_filter__(filter, victim_alt), filter->victim_fingerprint))
+        {
+            filter->has_victim = 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Inserts @p count keys stored contiguously, @p key_size bytes each.
+ * @return The number of keys inserted before the filter became full.
+ */
+static inline uint64_t insert_batch_cuckoo_filter(cuckoo_filter* const filter, const void* const keys, const size_t key_size, const uint64_t count)
+{
+    for (uint64_t i = 0; i < count; i++)
+    {
+        if (insert_cuckoo_filter(filter, (const uint8_t*)keys + i * key_size, key_size) != 0) return i;
+    }
+    return count;
+}
+
+/**
+ * @brief Queries @p count keys stored contiguously, @p key_size bytes each.
+ * Hashes are computed a chunk at a time and both candidate buckets of every key are prefetched before the tests run.
+ * @param results Receives 0 (absent) or 1 (possibly present) per key.
+ * @return The number of keys reported as possibly present.
+ */
+static inline uint64_t query_batch_cuckoo_filter(const cuckoo_filter* const filter, const void* const keys, const size_t key_size, const uint64_t count, uint8_t* const results)
+{
+    uint64_t hashes[CUCKOO_FILTER_BATCH_CHUNK];
+    uint64_t positives = 0;
+
+    for (uint64_t start = 0; start < count; start += CUCKOO_FILTER_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < CUCKOO_FILTER_BATCH_CHUNK) ? count - start : CUCKOO_FILTER_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            hashes[i] = __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, filter->seed);
+            const uint64_t first = hashes[i] & (filter->bucket_count - 1);
+            __filter_prefetch__(__get_bucket_cuckoo_filter__(filter, first));
+            __filter_prefetch__(__get_bucket_cuckoo_filter__(filter, __alt_bucket_cuckoo_filter__(filter, first, __fingerprint_cuckoo_filter__(hashes[i]))));
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            results[start + i] = __query_hash_cuckoo_filter__(filter, hashes[i]);
+            positives += results[start + i];
+        }
+    }
+    return positives;
+}
+
+static inline void clear_cuckoo_filter(cuckoo_filter* const filter)
+{
+    memset(filter->slots, 0, filter->bucket_count * CUCKOO_FILTER_BUCKET_SIZE * sizeof(uint16_t));
+    filter->item_count = 0;
+    filter->has_victim = 0;
+}
+
+static inline uint64_t get_serialized_size_cuckoo_filter(const cuckoo_filter* const filter)
+{
+    return 4 + 4 + 8 + 8 + 8 + 4 + 8 + filter->bucket_count * CUCKOO_FILTER_BUCKET_SIZE * sizeof(uint16_t);
+}
+
+/**
+ * @brief Writes the filter to @p buffer, which must hold get_serialized_size_cuckoo_filter() bytes.
+ * @return The number of bytes written.
+ */
+static inline uint64_t serialize_cuckoo_filter(const cuckoo_filter* const filter, uint8_t* const buffer)
+{
+    uint8_t* ptr = buffer;
+    ptr = __filter_write_u32__(ptr, CUCKOO_FILTER_SERIAL_MAGIC);
+    ptr = __filter_write_u32__(ptr, CUCKOO_FILTER_SERIAL_VERSION);
+    ptr = __filter_write_u64__(ptr, filter->bucket_count);
+    ptr = __filter_write_u64__(ptr, filter->seed);
+    ptr = __filter_write_u64__(ptr, filter->item_count);
+    ptr = __filter_write_u32__(ptr, filter->has_victim ? (0x10000U | filter->victim_fingerprint) : 0);
+    ptr = __filter_write_u64__(ptr, filter->victim_bucket);
+    for (uint64_t i = 0; i < filter->bucket_count * CUCKOO_FILTER_BUCKET_SIZE; i++)
+    {
+        ptr = __filter_write_u16__(ptr, filter->slots[i]);
+    }
+    return (uint64_t)(ptr - buffer);
+}
+
+/**
+ * @brief Rebuilds a filter written by serialize_cuckoo_filter().
+ * @return The new filter, or NULL if the buffer is malformed or allocation failed.
+ */
+static inline cuckoo_filter* deserialize_cuckoo_filter(const uint8_t* const buffer, const uint64_t size)
+{
+    if (size < 44) return NULL;
+
+    const uint8_t* ptr = buffer;
+    uint32_t magic, version, victim;
+    uint64_t bucket_count, seed, item_count, victim_bucket;
+    ptr = __filter_read_u32__(ptr, &magic);
+    ptr = __filter_read_u32__(ptr, &version);
+    ptr = __filter_read_u64__(ptr, &bucket_count);
+    ptr = __filter_read_u64__(ptr, &seed);
+    ptr = __filter_read_u64__(ptr, &item_count);
+    ptr = __filter_read_u32__(ptr, &victim);
+    ptr = __filter_read_u64__(ptr, &victim_bucket);
+
+    if (magic != CUCKOO_FILTER_SERIAL_MAGIC || version != CUCKOO_FILTER_SERIAL_VERSION) return NULL;
+    if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0 || victim_bucket >= bucket_count) return NULL;
+    if ((size - 44) / (CUCKOO_FILTER_BUCKET_SIZE * sizeof(uint16_t)) < bucket_count) return NULL;
+
+    cuckoo_filter* const filter = (cuckoo_filter*)calloc(1, sizeof(cuckoo_filter));
+    if (filter == NULL) return NULL;
+    set_cuckoo_filter_explicit(filter, bucket_count, seed);
+    if (filter->slots == NULL) { free(filter); return NULL; }
+
+    filter->item_count = item_count;
+    filter->has_victim = (victim >> 16) & 1;
+    filter->victim_fingerprint = (uint16_t)victim;
+    filter->victim_bucket = victim_bucket;
+    for (uint64_t i = 0; i < bucket_count * CUCKOO_FILTER_BUCKET_SIZE; i++)
+    {
+        ptr = __filter_read_u16__(ptr, &filter->slots[i]);
+    }
+    return filter;
+}
+
+static inline void clean_cuckoo_filter(cuckoo_filter* const filter)
+{
+    __aligned_free_memory__(filter->slots);
+    filter->slots = NULL;
+    filter->bucket_count = 0;
+    filter->item_count = 0;
+    filter->has_victim = 0;
+}
+
+static inline void free_cuckoo_filter(cuckoo_filter* const filter)
+{
+    clean_cuckoo_filter(filter);
+    free(filter);
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FILTER_BASE_H
+#define FILTER_BASE_H
+
+#include "../Dynamic Array/dyn_array.h"
+#include "../Hashing/xxHash-3-64.h"
+#include "../Memory/allocator.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FILTER_CACHE_LINE_SIZE 64
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define __filter_prefetch__(ADDRESS) __builtin_prefetch((ADDRESS), 0, 1)
+#else
+    #define __filter_prefetch__(ADDRESS) ((void)(ADDRESS))
+#endif
+
+/*
+    Shared helpers for the membership filters.
+    Keys are hashed as raw bytes; batch APIs take `count` keys laid out contiguously, each `key_size` bytes long.
+    Serialized forms are little-endian byte buffers that start with a 4 byte magic and a 4 byte version.
+*/
+
+// Internal use only; hashes raw key bytes through a borrowed dyn_array view (no allocation)
+static inline uint64_t __filter_hash__(const void* const key, const size_t key_size, const uint64_t seed)
+{
+    dyn_array key_view;
+    set_dyn_array(&key_view, DYN_ARRAY_UINT_8T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+    key_view.data = (void*)key;
+    key_view.current_size = key_size;
+    key_view.max_size = key_size;
+    return digest_XXH3_64_with_seed(&key_view, seed);
+}
+
+// Internal use only; zeroed, cache-line aligned and rounded up to whole lines. Release with __aligned_free_memory__
+static inline void* __filter_aligned_calloc__(const size_t size)
+{
+    const size_t rounded = (size + FILTER_CACHE_LINE_SIZE - 1) & ~(size_t)(FILTER_CACHE_LINE_SIZE - 1);
+    void* const ptr = __aligned_malloc_memory__(rounded, FILTER_CACHE_LINE_SIZE);
+    if (ptr != NULL) memset(ptr, 0, rounded);
+    return ptr;
+}
+
+// Internal use only
+static inline uint8_t* __filter_write_u64__(uint8_t* buffer, const uint64_t value)
+{
+    for (int i = 0; i < 8; i++) *buffer++ = (uint8_t)(value >> (8 * i));
+    return buffer;
+}
+
+// Internal use only
+static inline const uint8_t* __filter_read_u64__(const uint8_t* buffer, uint64_t* const value)
+{
+    uint64_t result = 0;
+    for (int i = 0; i < 8; i++) result |= (uint64_t)(*buffer++) << (8 * i);
+    *value = result;
+    return buffer;
+}
+
+// Internal use only
+static inline uint8_t* __filter_write_u16__(uint8_t* buffer, const uint16_t value)
+{
+    *buffer++ = (uint8_t)value;
+    *buffer++ = (uint8_t)(value >> 8);
+    return buffer;
+}
+
+// Internal use only
+static inline const uint8_t* __filter_read_u16__(const uint8_t* buffer, uint16_t* const value)
+{
+    *value = (uint16_t)(buffer[0] | (buffer[1] << 8));
+    return buffer + 2;
+}
+
+// Internal use only
+static inline uint8_t* __filter_write_u32__(uint8_t* buffer, const uint32_t value)
+{
+    for (int i = 0; i < 4; i++) *buffer++ = (uint8_t)(value >> (8 * i));
+    return buffer;
+}
+
+// Internal use only
+static inline const uint8_t* __filter_read_u32__(const uint8_t* buffer, uint32_t* const value)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) result |= (uint32_t)(*buffer++) << (8 * i);
+    *value = result;
+    return buffer;
+}
+
+#endif
@@ -18,13 +18,13 @@ static inline void pad_message_set_min_length(dyn_array* const message, const ui
     const uint64_t total_bytes_to_add = (total_bits_to_add + 7) / 8; // round up to nearest byte
     const uint64_t total_slots_to_add = total_bytes_to_add * message->item_size;
 
-    for (unsigned int i = 0; i < total_slots_to_add; i++)
+    for (uint64_t i = 0; i < total_slots_to_add; i++)
     {
         const unsigned char pad_byte = (i==0) ? 0x80 : 0x00; // first byte is 10000000, rest are 00000000
         void* slot = add_slot_dyn_array(message);
 
         *((unsigned char*)slot) = pad_byte;
-        for (int j = 1; j < message->item_size; j++) *((unsigned char*)slot+j) = 0x00;
+        for (size_t j = 1; j < message->item_size; j++) *((unsigned char*)slot+j) = 0x00;
     }
 }
 
@@ -48,7 +48,7 @@ static inline void append_message_length(dyn_array* const message, const unsigne
         void* slot = add_slot_dyn_array(message);
 
         *((unsigned char*)slot) = byte;
-        for (int j = 1; j < message->item_size; j++) *((unsigned char*)slot+j) = 0x00;
+        for (size_t j = 1; j < message->item_size; j++) *((unsigned char*)slot+j) = 0x00;
     }
 }
 
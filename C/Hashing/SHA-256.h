@@ -39,7 +39,7 @@ static inline dyn_array* hexdigest_sha256(dyn_array* const message)
         && message->type != DYN_ARRAY_UINT_64T_TYPE
     ) { return NULL; }
 
-    const uint32_t original_bit_length = message->current_size * message->item_size * 8;
+    const uint64_t original_bit_length = message->current_size * message->item_size * 8;
     pad_message_digest_length(message, SHA_256_BLOCK_BIT_LENGTH, SHA_256_LENGTH_FIELD_BIT_SIZE); 
     append_message_length(message, SHA_256_LENGTH_FIELD_BIT_SIZE, original_bit_length);
 
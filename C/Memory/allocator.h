@@ -0,0 +1,130 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef _WIN64  // windows platform
+	#include <malloc.h>
+#endif
+
+/*
+	Pluggable memory allocator for the library's containers (dyn_array, String, Dictionary, stack / queue bodies and
+	SaveStateQueue). Objects keep a `const allocator*`; NULL, which is also what a zeroed struct holds, means
+	malloc / realloc / free. Callers hand the block size back on realloc and free, so allocators need no per-block headers.
+	An allocator must outlive every block it handed out. Implementations: arena.h (bump arena, reset frees everything),
+	pool_allocator.h (size-class free lists) and thread_cache.h (per-thread free lists in front of malloc).
+*/
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+	typedef max_align_t __max_align_allocator__;
+	#define ALLOCATOR_DEFAULT_ALIGNMENT _Alignof(max_align_t)
+#else // C99: no max_align_t / _Alignof, so take the strictest alignment of the widest scalar types
+	typedef union __max_align_allocator__
+	{
+		long long ll;
+		long double ld;
+		void* ptr;
+		void (*func)(void);
+	} __max_align_allocator__;
+	struct __max_align_probe_allocator__ { char c; __max_align_allocator__ value; };
+	#define ALLOCATOR_DEFAULT_ALIGNMENT offsetof(struct __max_align_probe_allocator__, value)
+
+	#ifndef _WIN64
+		int posix_memalign(void** memptr, size_t alignment, size_t size); // not declared by <stdlib.h> in strict C99 mode
+	#endif
+#endif
+
+typedef struct allocator
+{
+	void* (*alloc)(void* context, size_t size, size_t alignment); // alignment is a power of two, at least ALLOCATOR_DEFAULT_ALIGNMENT; NULL on failure
+	void* (*realloc)(void* context, void* ptr, size_t old_size, size_t new_size); // default alignment only; NULL on failure (ptr stays valid)
+	void (*free)(void* context, void* ptr, size_t size);
+	void* context;
+} allocator;
+
+// Internal use only; system allocation at the given alignment, always released with __aligned_free_memory__
+static inline void* __aligned_malloc_memory__(const size_t size, const size_t alignment)
+{
+#ifdef _WIN64
+	return _aligned_malloc(size, alignment);
+#else
+	if (alignment <= ALLOCATOR_DEFAULT_ALIGNMENT) return malloc(size);
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+	return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1)); // aligned_alloc needs a multiple of the alignment
+#else
+	void* ptr;
+	return (posix_memalign(&ptr, alignment, size) == 0) ? ptr : NULL;
+#endif
+#endif
+}
+
+// Internal use only
+static inline void __aligned_free_memory__(void* const ptr)
+{
+#ifdef _WIN64
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+static inline void* mem_alloc(const allocator* const alloc, const size_t size)
+{
+	if (alloc == NULL) return malloc(size);
+	return alloc->alloc(alloc->context, size, ALLOCATOR_DEFAULT_ALIGNMENT);
+}
+
+/*
+	Zeroed count * size bytes; NULL on overflow or allocation error
+*/
+static inline void* mem_calloc(const allocator* const alloc, const size_t count, const size_t size)
+{
+	if (alloc == NULL) return calloc(count, size);
+	if (size != 0 && count > SIZE_MAX / size) return NULL;
+	void* const ptr = alloc->alloc(alloc->context, count * size, ALLOCATOR_DEFAULT_ALIGNMENT);
+	if (ptr != NULL) memset(ptr, 0, count * size);
+	return ptr;
+}
+
+/*
+	Resizes a block from mem_alloc / mem_calloc / mem_realloc of old_size bytes (ptr may be NULL).
+	Returns the moved block, or NULL on allocation error (ptr is then still valid)
+*/
+static inline void* mem_realloc(const allocator* const alloc, void* const ptr, const size_t old_size, const size_t new_size)
+{
+	if (alloc == NULL) return realloc(ptr, new_size);
+	if (ptr == NULL) return alloc->alloc(alloc->context, new_size, ALLOCATOR_DEFAULT_ALIGNMENT);
+	return alloc->realloc(alloc->context, ptr, old_size, new_size);
+}
+
+/*
+	Releases a block of size bytes from mem_alloc / mem_calloc / mem_realloc (NULL is ignored)
+*/
+static inline void mem_free(const allocator* const alloc, void* const ptr, const size_t size)
+{
+	if (ptr == NULL) return;
+	if (alloc == NULL) free(ptr);
+	else alloc->free(alloc->context, ptr, size);
+}
+
+/*
+	size bytes aligned to alignment (a power of two); release with mem_free_aligned
+*/
+static inline void* mem_alloc_aligned(const allocator* const alloc, const size_t size, size_t alignment)
+{
+	if (alignment < ALLOCATOR_DEFAULT_ALIGNMENT) alignment = ALLOCATOR_DEFAULT_ALIGNMENT;
+	if (alloc == NULL) return __aligned_malloc_memory__(size, alignment);
+	return alloc->alloc(alloc->context, size, alignment);
+}
+
+static inline void mem_free_aligned(const allocator* const alloc, void* const ptr, const size_t size)
+{
+	if (ptr == NULL) return;
+	if (alloc == NULL) __aligned_free_memory__(ptr);
+	else alloc->free(alloc->context, ptr, size);
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "allocator.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64u * 1024u) // bytes
+
+/*
+	Bump allocator: allocations are carved in order from large blocks, and reset_arena() releases all of them at once
+	(keeping the blocks for reuse), so request-scoped work needs one reset instead of one free per object.
+	Freeing or resizing the most recent allocation happens in place; freeing anything else is a no-op until the reset.
+	Pass &arena->allocator to the containers. Not thread safe.
+*/
+
+// Internal use only
+struct __arena_block__
+{
+	struct __arena_block__* next;
+	size_t capacity; // bytes in data
+	__max_align_allocator__ data[];
+};
+
+typedef struct arena
+{
+	allocator allocator;
+	size_t block_size; // minimum bytes per block
+	struct __arena_block__* first;
+	struct __arena_block__* current; // blocks after it are free for reuse
+	size_t offset; // bytes used in current
+	uint8_t* last; // most recent allocation, for in-place realloc / free
+	size_t bytes_used; // statistics: bytes handed out since the last reset (including alignment padding)
+} arena;
+
+// Internal use only
+static inline uint8_t* __block_data_arena__(struct __arena_block__* const block)
+{
+	return (uint8_t*)block->data;
+}
+
+// Internal use only
+static inline void* __alloc_arena__(void* const context, const size_t size, const size_t alignment)
+{
+	arena* const a = (arena*)context;
+	struct __arena_block__* block = a->current;
+	size_t offset = a->offset;
+
+	for (;;)
+	{
+		if (block != NULL)
+		{
+			const uintptr_t base = (uintptr_t)__block_data_arena__(block);
+			const size_t start = (size_t)(((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+			if (start <= block->capacity && size <= block->capacity - start)
+			{
+				a->current = block;
+				a->offset = start + size;
+				a->bytes_used += start + size - offset;
+				a->last = __block_data_arena__(block) + start;
+				return a->last;
+			}
+			if (block->next != NULL) // reuse blocks kept by a reset
+			{
+				block = block->next;
+				offset = 0;
+				continue;
+			}
+		}
+
+		// New block after the last one
+		size_t capacity = a->block_size;
+		if (capacity < size + alignment) capacity = size + alignment;
+		struct __arena_block__* const fresh = (struct __arena_block__*)malloc(sizeof(struct __arena_block__) + capacity);
+		if (fresh == NULL) return NULL;
+		fresh->next = NULL;
+		fresh->capacity = capacity;
+		if (block == NULL) a->first = fresh;
+		else block->next = fresh;
+		block = fresh;
+		offset = 0;
+	}
+}
+
+// Internal use only
+static inline void* __realloc_arena__(void* const context, void* const ptr, const size_t old_size, const size_t new_size)
+{
+	arena* const a = (arena*)context;
+	if ((uint8_t*)ptr == a->last)
+	{
+		const size_t start = (size_t)(a->last - __block_data_arena__(a->current));
+		if (new_size <= a->current->capacity - start)
+		{
+			a->bytes_used = a->bytes_used - (a->offset - start) + new_size;
+			a->offset = start + new_size;
+			return ptr;
+		}
+	}
+	else if (new_size <= old_size) return ptr;
+
+	void* const moved = __alloc_arena__(context, new_size, ALLOCATOR_DEFAULT_ALIGNMENT);
+	if (moved == NULL) return NULL;
+	memcpy(moved, ptr, (old_size < new_size) ? old_size : new_size);
+	return moved;
+}
+
+// Internal use only
+static inline void __free_arena__(void* const context, void* const ptr, const size_t size)
+{
+	arena* const a = (arena*)context;
+	(void)size;
+	if ((uint8_t*)ptr != a->last) return;
+
+	const size_t start = (size_t)(a->last - __block_data_arena__(a->current));
+	a->bytes_used -= a->offset - start;
+	a->offset = start;
+	a->last = NULL;
+}
+
+/*
+	block_size: minimum bytes per block (0 uses ARENA_DEFAULT_BLOCK_SIZE); larger allocations get a block of their own size
+*/
+static inline void set_arena(arena* const a, const size_t block_size)
+{
+	a->allocator.alloc = __alloc_arena__;
+	a->allocator.realloc = __realloc_arena__;
+	a->allocator.free = __free_arena__;
+	a->allocator.context = a;
+	a->block_size = (block_size == 0) ? ARENA_DEFAULT_BLOCK_SIZE : block_size;
+	a->first = NULL;
+	a->current = NULL;
+	a->offset = 0;
+	a->last = NULL;
+	a->bytes_used = 0;
+}
+
+static inline arena* new_arena(const size_t block_size)
+{
+	arena* const a = (arena*)calloc(1, sizeof(arena));
+	if (a == NULL) return NULL;
+	set_arena(a, block_size);
+	return a;
+}
+
+static inline void* alloc_arena(arena* const a, const size_t size)
+{
+	return __alloc_arena__(a, size, ALLOCATOR_DEFAULT_ALIGNMENT);
+}
+
+/*
+	Releases every allocation at once; the blocks are kept and reused by later allocations
+*/
+static inline void reset_arena(arena* const a)
+{
+	a->current = a->first;
+	a->offset = 0;
+	a->last = NULL;
+	a->bytes_used = 0;
+}
+
+static inline void clean_arena(arena* const a)
+{
+	struct __arena_block__* block = a->first;
+	while (block != NULL)
+	{
+		struct __arena_block__* const next = block->next;
+		free(block);
+		block = next;
+	}
+	a->first = NULL;
+	reset_arena(a);
+}
+
+static inline void free_arena(arena* const a)
+{
+	clean_arena(a);
+	free(a);
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include "allocator.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define POOL_ALLOCATOR_MIN_CLASS_SHIFT 4 // smallest class: 16 bytes
+#define POOL_ALLOCATOR_CLASS_COUNT 9 // classes 16, 32, ... 4096 bytes
+#define POOL_ALLOCATOR_SLAB_BYTES (64u * 1024u) // carved into blocks of one class at a time
+
+/*
+	Size-class pool: requests up to 4096 bytes are rounded up to a power-of-two class and served from that class's free
+	list, refilled a slab at a time, so allocating and freeing small objects never reaches malloc in steady state.
+	Blocks are aligned to their class size (alignments above 4096 bytes are only served for requests larger than that).
+	Each slab is aligned to its own size and spends its first block on a header naming its class, so a freed block
+	returns to the class it was taken from whatever alignment it was requested with.
+	Larger requests go straight to the system allocator.
+	Memory is returned to the system only by clean_pool_allocator. Pass &pool->allocator to the containers. Not thread safe.
+*/
+
+#define POOL_ALLOCATOR_MAX_CLASS_BYTES ((size_t)1 << (POOL_ALLOCATOR_MIN_CLASS_SHIFT + POOL_ALLOCATOR_CLASS_COUNT - 1))
+
+typedef struct pool_allocator
+{
+	allocator allocator;
+	void* free_lists[POOL_ALLOCATOR_CLASS_COUNT]; // each free block stores the next one in its first bytes
+	void** slabs;
+	size_t slab_count;
+	size_t slab_capacity;
+} pool_allocator;
+
+// Internal use only; class index for a request, or POOL_ALLOCATOR_CLASS_COUNT if it is served by the system
+static inline unsigned int __class_pool_allocator__(size_t size, const size_t alignment)
+{
+	if (size < alignment) size = alignment;
+	if (size > POOL_ALLOCATOR_MAX_CLASS_BYTES) return POOL_ALLOCATOR_CLASS_COUNT;
+
+	unsigned int index = 0;
+	while (((size_t)1 << (POOL_ALLOCATOR_MIN_CLASS_SHIFT + index)) < size) index++;
+	return index;
+}
+
+// Internal use only; sits in the first block of every slab
+struct __slab_header_pool_allocator__
+{
+	unsigned int class_index;
+};
+
+// Internal use only; class index of a block handed out for size bytes, or POOL_ALLOCATOR_CLASS_COUNT if it came from the system
+static inline unsigned int __block_class_pool_allocator__(const void* const ptr, const size_t size)
+{
+	if (size > POOL_ALLOCATOR_MAX_CLASS_BYTES) return POOL_ALLOCATOR_CLASS_COUNT; // small requests never reach the system
+	const uintptr_t slab = (uintptr_t)ptr & ~(uintptr_t)(POOL_ALLOCATOR_SLAB_BYTES - 1);
+	return ((const struct __slab_header_pool_allocator__*)slab)->class_index;
+}
+
+// Internal use only; carves a new slab into the free list of class index. Returns 0 on success, else 1
+static inline int __refill_pool_allocator__(pool_allocator* const pool, const unsigned int index)
+{
+	if (pool->slab_count == pool->slab_capacity)
+	{
+		const size_t capacity = pool->slab_capacity * 2 + 8;
+		void** const slabs = (void**)realloc(pool->slabs, capacity * sizeof(void*));
+		if (slabs == NULL) return 1;
+		pool->slabs = slabs;
+		pool->slab_capacity = capacity;
+	}
+
+	uint8_t* const slab = (uint8_t*)__aligned_malloc_memory__(POOL_ALLOCATOR_SLAB_BYTES, POOL_ALLOCATOR_SLAB_BYTES);
+	if (slab == NULL) return 1;
+	pool->slabs[pool->slab_count++] = slab;
+	((struct __slab_header_pool_allocator__*)slab)->class_index = index;
+
+	const size_t block = (size_t)1 << (POOL_ALLOCATOR_MIN_CLASS_SHIFT + index);
+	void* head = pool->free_lists[index];
+	for (size_t offset = POOL_ALLOCATOR_SLAB_BYTES; offset >= 2 * block; offset -= block) // lowest addresses are handed out first; the first block holds the header
+	{
+		void* const item = slab + offset - block;
+		memcpy(item, &head, sizeof(void*));
+		head = item;
+	}
+	pool->free_lists[index] = head;
+	return 0;
+}
+
+// Internal use only
+static inline void* __alloc_pool_allocator__(void* const context, const size_t size, const size_t alignment)
+{
+	pool_allocator* const pool = (pool_allocator*)context;
+	const unsigned int index = __class_pool_allocator__(size, alignment);
+	if (index == POOL_ALLOCATOR_CLASS_COUNT)
+	{
+		if (size <= POOL_ALLOCATOR_MAX_CLASS_BYTES) return NULL; // a small block freed later would be taken for a class block
+		return __aligned_malloc_memory__(size, alignment);
+	}
+
+	if (pool->free_lists[index] == NULL && __refill_pool_allocator__(pool, index) != 0) return NULL;
+	void* const item = pool->free_lists[index];
+	memcpy(&pool->free_lists[index], item, sizeof(void*));
+	return item;
+}
+
+// Internal use only
+static inline void __free_pool_allocator__(void* const context, void* const ptr, const size_t size)
+{
+	pool_allocator* const pool = (pool_allocator*)context;
+	const unsigned int index = __block_class_pool_allocator__(ptr, size);
+	if (index == POOL_ALLOCATOR_CLASS_COUNT)
+	{
+		__aligned_free_memory__(ptr);
+		return;
+	}
+	memcpy(ptr, &pool->free_lists[index], sizeof(void*));
+	pool->free_lists[index] = ptr;
+}
+
+// Internal use only
+static inline void* __realloc_pool_allocator__(void* const context, void* const ptr, const size_t old_size, const size_t new_size)
+{
+	const unsigned int old_index = __block_class_pool_allocator__(ptr, old_size);
+	if (old_index != POOL_ALLOCATOR_CLASS_COUNT && old_index == __class_pool_allocator__(new_size, ALLOCATOR_DEFAULT_ALIGNMENT)) return ptr;
+
+	void* const moved = __alloc_pool_allocator__(context, new_size, ALLOCATOR_DEFAULT_ALIGNMENT);
+	if (moved == NULL) return NULL;
+	memcpy(moved, ptr, (old_size < new_size) ? old_size : new_size);
+	__free_pool_allocator__(context, ptr, old_size);
+	return moved;
+}
+
+static inline void set_pool_allocator(pool_allocator* const pool)
+{
+	pool->allocator.alloc = __alloc_pool_allocator__;
+	pool->allocator.realloc = __realloc_pool_allocator__;
+	pool->allocator.free = __free_pool_allocator__;
+	pool->allocator.context = pool;
+	for (unsigned int i = 0; i < POOL_ALLOCATOR_CLASS_COUNT; i++) pool->free_lists[i] = NULL;
+	pool->slabs = NULL;
+	pool->slab_count = 0;
+	pool->slab_capacity = 0;
+}
+
+static inline pool_allocator* new_pool_allocator(void)
+{
+	pool_allocator* const pool = (pool_allocator*)calloc(1, sizeof(pool_allocator));
+	if (pool == NULL) return NULL;
+	set_pool_allocator(pool);
+	return pool;
+}
+
+/*
+	Returns every slab to the system; blocks still in use become invalid (large blocks are not tracked and must be freed first)
+*/
+static inline void clean_pool_allocator(pool_allocator* const pool)
+{
+	for (size_t i = 0; i < pool->slab_count; i++) __aligned_free_memory__(pool->slabs[i]);
+	free(pool->slabs);
+	set_pool_allocator(pool);
+}
+
+static inline void free_pool_allocator(pool_allocator* const pool)
+{
+	clean_pool_allocator(pool);
+	free(pool);
+}
+
+#endif
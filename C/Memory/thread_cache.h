@@ -0,0 +1,119 @@
+#ifndef THREAD_CACHE_H
+#define THREAD_CACHE_H
+
+#include "allocator.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define THREAD_CACHE_MIN_CLASS_SHIFT 4 // smallest class: 16 bytes
+#define THREAD_CACHE_CLASS_COUNT 9 // classes 16, 32, ... 4096 bytes
+#define THREAD_CACHE_MAX_BLOCKS 64 // blocks kept per class and thread; more are returned to the system
+
+/*
+	Per-thread free lists in front of the system allocator: freed blocks up to 4096 bytes are kept (rounded to a
+	power-of-two class) by the freeing thread and handed back by its next allocation of that class, with no locking.
+	Blocks are ordinary system allocations, so any thread may free any block. Pass &thread_cache_allocator to the containers.
+	A thread should call flush_thread_cache() before it exits, or its cached blocks are leaked.
+*/
+
+#define THREAD_CACHE_MAX_CLASS_BYTES ((size_t)1 << (THREAD_CACHE_MIN_CLASS_SHIFT + THREAD_CACHE_CLASS_COUNT - 1))
+
+#if defined(_MSC_VER)
+	#define __THREAD_CACHE_LOCAL__ __declspec(thread)
+#else
+	#define __THREAD_CACHE_LOCAL__ _Thread_local
+#endif
+
+// Internal use only
+struct __thread_cache__
+{
+	void* free_lists[THREAD_CACHE_CLASS_COUNT]; // each free block stores the next one in its first bytes
+	uint32_t counts[THREAD_CACHE_CLASS_COUNT];
+};
+
+// Internal use only
+static __THREAD_CACHE_LOCAL__ struct __thread_cache__ __thread_cache_state__;
+
+// Internal use only; class index for a size, or THREAD_CACHE_CLASS_COUNT if it is not cached
+static inline unsigned int __class_thread_cache__(const size_t size)
+{
+	if (size > THREAD_CACHE_MAX_CLASS_BYTES) return THREAD_CACHE_CLASS_COUNT;
+	unsigned int index = 0;
+	while (((size_t)1 << (THREAD_CACHE_MIN_CLASS_SHIFT + index)) < size) index++;
+	return index;
+}
+
+// Internal use only
+static inline void* __alloc_thread_cache__(void* const context, const size_t size, const size_t alignment)
+{
+	(void)context;
+	const unsigned int index = __class_thread_cache__(size);
+	if (index == THREAD_CACHE_CLASS_COUNT) return __aligned_malloc_memory__(size, alignment);
+
+	struct __thread_cache__* const cache = &__thread_cache_state__;
+	void* const item = cache->free_lists[index];
+	if (item != NULL && alignment <= ALLOCATOR_DEFAULT_ALIGNMENT) // cached blocks only carry the default alignment
+	{
+		memcpy(&cache->free_lists[index], item, sizeof(void*));
+		cache->counts[index]--;
+		return item;
+	}
+	return __aligned_malloc_memory__((size_t)1 << (THREAD_CACHE_MIN_CLASS_SHIFT + index), alignment); // whole class, so it can be reused
+}
+
+// Internal use only
+static inline void __free_thread_cache__(void* const context, void* const ptr, const size_t size)
+{
+	(void)context;
+	const unsigned int index = __class_thread_cache__(size);
+	struct __thread_cache__* const cache = &__thread_cache_state__;
+	if (index == THREAD_CACHE_CLASS_COUNT || cache->counts[index] >= THREAD_CACHE_MAX_BLOCKS)
+	{
+		__aligned_free_memory__(ptr);
+		return;
+	}
+	memcpy(ptr, &cache->free_lists[index], sizeof(void*));
+	cache->free_lists[index] = ptr;
+	cache->counts[index]++;
+}
+
+// Internal use only
+static inline void* __realloc_thread_cache__(void* const context, void* const ptr, const size_t old_size, const size_t new_size)
+{
+	const unsigned int old_index = __class_thread_cache__(old_size);
+	if (old_index != THREAD_CACHE_CLASS_COUNT && old_index == __class_thread_cache__(new_size)) return ptr;
+
+	void* const moved = __alloc_thread_cache__(context, new_size, ALLOCATOR_DEFAULT_ALIGNMENT);
+	if (moved == NULL) return NULL;
+	memcpy(moved, ptr, (old_size < new_size) ? old_size : new_size);
+	__free_thread_cache__(context, ptr, old_size);
+	return moved;
+}
+
+static const allocator thread_cache_allocator = { __alloc_thread_cache__, __realloc_thread_cache__, __free_thread_cache__, NULL };
+
+/*
+	Returns the calling thread's cached blocks to the system
+*/
+static inline void flush_thread_cache(void)
+{
+	struct __thread_cache__* const cache = &__thread_cache_state__;
+	for (unsigned int i = 0; i < THREAD_CACHE_CLASS_COUNT; i++)
+	{
+		void* item = cache->free_lists[i];
+		while (item != NULL)
+		{
+			void* next;
+			memcpy(&next, item, sizeof(void*));
+			__aligned_free_memory__(item);
+			item = next;
+		}
+		cache->free_lists[i] = NULL;
+		cache->counts[i] = 0;
+	}
+}
+
+#endif
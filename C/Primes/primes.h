@@ -4,6 +4,9 @@
 #include "../Dynamic Array/dyn_array.h"
 #include "../Stack & Queue/stack.h"
 #include "../Stack & Queue/queue.h"
+#include "../Bitset/bitset.h"
+
+#include <math.h>
 
 // Returns 1 if prime, 0 if not prime
 static inline int is_prime(const unsigned int number)
@@ -34,45 +37,68 @@ static inline unsigned int next_prime(unsigned int start)
     return start;
 }
 
-/** Fills a dynamic array with prime numbers up to \p count primes
+/** Fills a dynamic array with every prime number less than or equal to \p limit
+ * Sieve of Eratosthenes over the odd numbers, one bit each (a bitset), so the sieve needs limit / 16 bytes.
  * @param primes_array Pointer to a dynamic array of int (not int*); will be initialized within the function
- * @param count Number of prime numbers to generate
+ * @param limit Largest number to test
  * @return int 0 on success, 1 on failure
  * @warning All contents in \p primes_array will be cleared and the caller is responsible for cleaning up the dynamic array using clean_dyn_array() when done
  * */
-static inline int generate_primes(dyn_array* const primes_array, const unsigned int count)
+static inline int sieve_primes(dyn_array* const primes_array, const unsigned int limit)
 {
-    if (count == 0) return 1;
     if (primes_array == NULL) return 1;
-    
+
     clean_dyn_array(primes_array);
     set_dyn_array(primes_array, DYN_ARRAY_INT_TYPE, DYN_ARRAY_EXPANSION_FIXED);
+    if (limit < 2) return 0;
 
+    bitset composite; // bit i stands for 2i + 1
+    if (set_bitset(&composite, (size_t)(limit - 1) / 2 + 1) != 0) return 1;
+    set_bit_bitset(&composite, 0); // 1 is not prime
+
+    for (uint64_t i = 1; (2 * i + 1) * (2 * i + 1) <= limit; i++)
+    {
+        if (test_bit_bitset(&composite, i)) continue;
+        const uint64_t prime = 2 * i + 1;
+        for (uint64_t j = prime * prime / 2; j < composite.bit_count; j += prime) set_bit_bitset(&composite, j); // odd multiples from prime^2
+    }
+
+    if (reserve_dyn_array(primes_array, 1 + composite.bit_count - popcount_bitset(&composite)) != 0)
+    {
+        clean_bitset(&composite);
+        return 1;
+    }
     add_slot_dyn_array(primes_array);
     dyn_get_int(primes_array->data, 0) = 2;
-    unsigned int num_found = 1;
-    unsigned int candidate = 3;
-
-    while (num_found < count)
+    for (size_t i = 1; i < composite.bit_count; i++)
     {
-        int is_prime_b = 1;
-        for (int i = 0; i < primes_array->current_size; i++)
-        {
-            const unsigned int prime = dyn_get_int(primes_array->data, i);
-            if (candidate % prime == 0) 
-            {
-                is_prime_b = 0;
-                break;
-            }
-        }
-        if (is_prime_b)
-        {
-            add_slot_dyn_array(primes_array);
-            dyn_get_last_int(primes_array) = candidate;
-            num_found++;
-        }
-        candidate += 2; // check only odd numbers
+        if (test_bit_bitset(&composite, i)) continue;
+        add_slot_dyn_array(primes_array);
+        dyn_get_last_int(primes_array) = (int)(2 * i + 1);
     }
+
+    clean_bitset(&composite);
+    return 0;
+}
+
+/** Fills a dynamic array with prime numbers up to \p count primes
+ * Sieves up to the bound n (ln n + ln ln n) on the n-th prime, then keeps the first \p count.
+ * @param primes_array Pointer to a dynamic array of int (not int*); will be initialized within the function
+ * @param count Number of prime numbers to generate
+ * @return int 0 on success, 1 on failure
+ * @warning All contents in \p primes_array will be cleared and the caller is responsible for cleaning up the dynamic array using clean_dyn_array() when done
+ * */
+static inline int generate_primes(dyn_array* const primes_array, const unsigned int count)
+{
+    if (count == 0) return 1;
+    if (primes_array == NULL) return 1;
+
+    const double n = (double)count;
+    const double bound = (count < 6) ? 13.0 : ceil(n * (log(n) + log(log(n))));
+    if (bound > (double)UINT32_MAX) return 1;
+
+    if (sieve_primes(primes_array, (unsigned int)bound) != 0) return 1;
+    primes_array->current_size = count;
     return 0;
 }
 
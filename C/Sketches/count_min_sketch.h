@@ -0,0 +1,222 @@
+#ifndef COUNT_MIN_SKETCH_H
+#define COUNT_MIN_SKETCH_H
+
+#include "../Filters/filter_base.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#define COUNT_MIN_SKETCH_MAX_DEPTH 32
+#define COUNT_MIN_SKETCH_BATCH_CHUNK 64 // keys hashed (and prefetched) ahead of updating in batch calls
+
+/*
+    Count-Min sketch: `depth` rows of `width` saturating 32-bit counters; a key's frequency estimate is the minimum of its counters.
+    Estimates never undercount, and with width = e / epsilon and depth = ln(1 / delta) they overcount by at most epsilon * total
+    with probability 1 - delta. Updates are conservative (only counters below the new estimate are raised), which tightens
+    the overcount considerably on skewed streams. Sketches with the same shape and seed merge by adding counters.
+*/
+
+typedef struct count_min_sketch
+{
+    uint32_t width; // power of 2
+    uint32_t depth;
+    uint64_t seed;
+    uint64_t total;     // sum of all update amounts
+    uint32_t* counters; // depth rows of width counters, cache line aligned
+} count_min_sketch;
+
+/**
+ * @brief Initializes an empty sketch with explicit dimensions.
+ * @param width Counters per row, rounded up to a power of 2.
+ * @param depth Number of rows, clamped to [1, COUNT_MIN_SKETCH_MAX_DEPTH].
+ * @warning sketch->counters is NULL if the allocation failed.
+ */
+static inline void set_count_min_sketch_explicit(count_min_sketch* const sketch, const uint32_t width, uint32_t depth, const uint64_t seed)
+{
+    uint32_t columns = 16;
+    while (columns < width && columns < (1U << 31)) columns <<= 1;
+    if (depth < 1) depth = 1;
+    if (depth > COUNT_MIN_SKETCH_MAX_DEPTH) depth = COUNT_MIN_SKETCH_MAX_DEPTH;
+
+    sketch->width = columns;
+    sketch->depth = depth;
+    sketch->seed = seed;
+    sketch->total = 0;
+    sketch->counters = (uint32_t*)__filter_aligned_calloc__((size_t)columns * depth * sizeof(uint32_t));
+}
+
+/**
+ * @brief Initializes an empty sketch whose estimates exceed the true count by at most @p epsilon * total with probability 1 - @p delta.
+ */
+static inline void set_count_min_sketch(count_min_sketch* const sketch, const double epsilon, const double delta, const uint64_t seed)
+{
+    const double e = (epsilon <= 0.0 || epsilon >= 1.0) ? 0.001 : epsilon;
+    const double d = (delta <= 0.0 || delta >= 1.0) ? 0.01 : delta;
+    set_count_min_sketch_explicit(sketch, (uint32_t)ceil(2.718281828459045 / e), (uint32_t)ceil(log(1.0 / d)), seed);
+}
+
+static inline count_min_sketch* new_count_min_sketch(const double epsilon, const double delta, const uint64_t seed)
+{
+    count_min_sketch* const sketch = (count_min_sketch*)calloc(1, sizeof(count_min_sketch));
+    if (sketch == NULL) return NULL;
+    set_count_min_sketch(sketch, epsilon, delta, seed);
+    if (sketch->counters == NULL) { free(sketch); return NULL; }
+    return sketch;
+}
+
+// Internal use only; column of `row` from one 64-bit hash (double hashing)
+static inline uint32_t* __get_counter_count_min_sketch__(const count_min_sketch* const sketch, const uint64_t hash, const uint32_t row)
+{
+    const uint32_t column = ((uint32_t)hash + row * ((uint32_t)(hash >> 32) | 1)) & (sketch->width - 1);
+    return &sketch->counters[(size_t)row * sketch->width + column];
+}
+
+// Internal use only
+static inline uint32_t __estimate_hash_count_min_sketch__(const count_min_sketch* const sketch, const uint64_t hash)
+{
+    uint32_t estimate = UINT32_MAX;
+    for (uint32_t row = 0; row < sketch->depth; row++)
+    {
+        const uint32_t counter = *__get_counter_count_min_sketch__(sketch, hash, row);
+        if (counter < estimate) estimate = counter;
+    }
+    return estimate;
+}
+
+// Internal use only
+static inline void __add_hash_count_min_sketch__(count_min_sketch* const sketch, const uint64_t hash, const uint32_t amount)
+{
+    const uint32_t estimate = __estimate_hash_count_min_sketch__(sketch, hash);
+    const uint32_t target = (estimate > UINT32_MAX - amount) ? UINT32_MAX : estimate + amount;
+    for (uint32_t row = 0; row < sketch->depth; row++)
+    {
+        uint32_t* const counter = __get_counter_count_min_sketch__(sketch, hash, row);
+        if (*counter < target) *counter = target;
+    }
+    sketch->total += amount;
+}
+
+/**
+ * @brief Adds @p amount occurrences of a key (conservative update).
+ */
+static inline void add_count_min_sketch(count_min_sketch* const sketch, const void* const key, const size_t key_size, const uint32_t amount)
+{
+    __add_hash_count_min_sketch__(sketch, __filter_hash__(key, key_size, sketch->seed), amount);
+}
+
+/**
+ * @brief Adds @p count keys stored contiguously, @p key_size bytes each.
+ * @param amounts Per-key amounts, or NULL to add 1 for each key.
+ */
+static inline void add_batch_count_min_sketch(count_min_sketch* const sketch, const void* const keys, const size_t key_size, const uint32_t* const amounts, const uint64_t count)
+{
+    uint64_t hashes[COUNT_MIN_SKETCH_BATCH_CHUNK];
+
+    for (uint64_t start = 0; start < count; start += COUNT_MIN_SKETCH_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < COUNT_MIN_SKETCH_BATCH_CHUNK) ? count - start : COUNT_MIN_SKETCH_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            hashes[i] = __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, sketch->seed);
+            for (uint32_t row = 0; row < sketch->depth; row++)
+            {
+                __filter_prefetch__(__get_counter_count_min_sketch__(sketch, hashes[i], row));
+            }
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            __add_hash_count_min_sketch__(sketch, hashes[i], (amounts == NULL) ? 1 : amounts[start + i]);
+        }
+    }
+}
+
+/**
+ * @brief Estimated number of occurrences of a key; never less than the true count.
+ */
+static inline uint32_t estimate_count_min_sketch(const count_min_sketch* const sketch, const void* const key, const size_t key_size)
+{
+    return __estimate_hash_count_min_sketch__(sketch, __filter_hash__(key, key_size, sketch->seed));
+}
+
+/**
+ * @brief Estimates @p count keys stored contiguously, @p key_size bytes each, into @p estimates.
+ */
+static inline void estimate_batch_count_min_sketch(const count_min_sketch* const sketch, const void* const keys, const size_t key_size, const uint64_t count, uint32_t* const estimates)
+{
+    uint64_t hashes[COUNT_MIN_SKETCH_BATCH_CHUNK];
+
+    for (uint64_t start = 0; start < count; start += COUNT_MIN_SKETCH_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < COUNT_MIN_SKETCH_BATCH_CHUNK) ? count - start : COUNT_MIN_SKETCH_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            hashes[i] = __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, sketch->seed);
+            for (uint32_t row = 0; row < sketch->depth; row++)
+            {
+                __filter_prefetch__(__get_counter_count_min_sketch__(sketch, hashes[i], row));
+            }
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            estimates[start + i] = __estimate_hash_count_min_sketch__(sketch, hashes[i]);
+        }
+    }
+}
+
+/**
+ * @brief Merges @p src into @p dst by adding counters (saturating at UINT32_MAX).
+ * @return Returns 0 on success, else 1 if the sketches differ in width, depth or seed
+ */
+static inline uint8_t merge_count_min_sketch(count_min_sketch* const dst, const count_min_sketch* const src)
+{
+    if (dst->width != src->width || dst->depth != src->depth || dst->seed != src->seed) return 1;
+
+    const size_t n = (size_t)dst->width * dst->depth;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i sign = _mm256_set1_epi32((int)0x80000000U);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i a = _mm256_load_si256((const __m256i*)(dst->counters + i));
+        const __m256i b = _mm256_load_si256((const __m256i*)(src->counters + i));
+        const __m256i sum = _mm256_add_epi32(a, b);
+        // Unsigned overflow iff sum < a; compare as signed after flipping the sign bits
+        const __m256i overflow = _mm256_cmpgt_epi32(_mm256_xor_si256(a, sign), _mm256_xor_si256(sum, sign));
+        _mm256_store_si256((__m256i*)(dst->counters + i), _mm256_or_si256(sum, overflow));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        const uint32_t sum = dst->counters[i] + src->counters[i];
+        dst->counters[i] = (sum < dst->counters[i]) ? UINT32_MAX : sum;
+    }
+    dst->total += src->total;
+    return 0;
+}
+
+static inline void clear_count_min_sketch(count_min_sketch* const sketch)
+{
+    memset(sketch->counters, 0, (size_t)sketch->width * sketch->depth * sizeof(uint32_t));
+    sketch->total = 0;
+}
+
+static inline void clean_count_min_sketch(count_min_sketch* const sketch)
+{
+    __aligned_free_memory__(sketch->counters);
+    sketch->counters = NULL;
+    sketch->total = 0;
+}
+
+static inline void free_count_min_sketch(count_min_sketch* const sketch)
+{
+    clean_count_min_sketch(sketch);
+    free(sketch);
+}
+
+#endif
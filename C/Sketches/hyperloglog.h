@@ -0,0 +1,300 @@
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include "../Dynamic Array/dyn_array.h"
+#include "../Filters/filter_base.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+#define HYPERLOGLOG_MIN_PRECISION 4
+#define HYPERLOGLOG_MAX_PRECISION 18
+#define HYPERLOGLOG_SPARSE_BUFFER_SIZE 256 // pending sparse entries collected before they are sorted into the sparse list
+#define HYPERLOGLOG_BATCH_CHUNK 64 // keys hashed (and prefetched) ahead of updating in batch calls
+
+/*
+    HyperLogLog distinct-count sketch with 2^precision 6-bit registers (stored one per byte) and a relative error of about 1.04 / sqrt(2^precision).
+    A new sketch starts sparse: only touched registers are kept, as (index << 6 | rank) entries in a sorted dyn_array,
+    with new entries appended to an unsorted buffer and sorted in HYPERLOGLOG_SPARSE_BUFFER_SIZE at a time.
+    Once the sparse list would take more memory than the dense register array it is converted, which is one way only.
+    Sketches with the same precision and seed can be merged (register-wise max), so per-thread sketches can be combined.
+*/
+
+typedef struct hyperloglog
+{
+    uint8_t precision;
+    uint8_t is_sparse;
+    uint64_t seed;
+    uint8_t* registers;      // dense mode: 2^precision registers, cache line aligned (NULL while sparse)
+    dyn_array sparse;        // DYN_ARRAY_UINT_32T_TYPE, sorted, one entry per register index
+    dyn_array sparse_buffer; // DYN_ARRAY_UINT_32T_TYPE, unsorted pending entries
+} hyperloglog;
+
+/**
+ * @brief Initializes an empty (sparse) HyperLogLog.
+ * @param precision Register index bits, clamped to [HYPERLOGLOG_MIN_PRECISION, HYPERLOGLOG_MAX_PRECISION].
+ */
+static inline void set_hyperloglog(hyperloglog* const hll, uint8_t precision, const uint64_t seed)
+{
+    if (precision < HYPERLOGLOG_MIN_PRECISION) precision = HYPERLOGLOG_MIN_PRECISION;
+    if (precision > HYPERLOGLOG_MAX_PRECISION) precision = HYPERLOGLOG_MAX_PRECISION;
+
+    hll->precision = precision;
+    hll->is_sparse = 1;
+    hll->seed = seed;
+    hll->registers = NULL;
+    set_dyn_array(&hll->sparse, DYN_ARRAY_UINT_32T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+    set_dyn_array(&hll->sparse_buffer, DYN_ARRAY_UINT_32T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+}
+
+static inline hyperloglog* new_hyperloglog(const uint8_t precision, const uint64_t seed)
+{
+    hyperloglog* const hll = (hyperloglog*)calloc(1, sizeof(hyperloglog));
+    if (hll == NULL) return NULL;
+    set_hyperloglog(hll, precision, seed);
+    return hll;
+}
+
+static inline uint64_t get_register_count_hyperloglog(const hyperloglog* const hll)
+{
+    return (uint64_t)1 << hll->precision;
+}
+
+// Internal use only; top `precision` bits select the register, the rank is the position of the first set bit in the rest
+static inline uint32_t __encode_hash_hyperloglog__(const hyperloglog* const hll, const uint64_t hash)
+{
+    const uint32_t index = (uint32_t)(hash >> (64 - hll->precision));
+    const uint64_t rest = (hash << hll->precision) | ((uint64_t)1 << (hll->precision - 1)); // guard bit caps the rank
+#if defined(__GNUC__) || defined(__clang__)
+    const uint32_t rank = (uint32_t)__builtin_clzll(rest) + 1;
+#else
+    uint32_t rank = 1;
+    while ((rest & ((uint64_t)1 << (64 - rank))) == 0) rank++;
+#endif
+    return (index << 6) | rank;
+}
+
+// Internal use only
+static int __compare_sparse_entry_hyperloglog__(const void* a, const void* b)
+{
+    const uint32_t x = *(const uint32_t*)a;
+    const uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Internal use only; sorts the pending buffer into the sparse list, keeping the highest rank per register
+static inline void __flush_sparse_hyperloglog__(hyperloglog* const hll)
+{
+    if (hll->sparse_buffer.current_size == 0) return;
+
+    for (size_t i = 0; i < hll->sparse_buffer.current_size; i++)
+    {
+        append_item_dyn_array(&hll->sparse, &dyn_get_uint_32t(hll->sparse_buffer.data, i));
+    }
+    hll->sparse_buffer.current_size = 0;
+
+    uint32_t* const entries = (uint32_t*)hll->sparse.data;
+    qsort(entries, hll->sparse.current_size, sizeof(uint32_t), __compare_sparse_entry_hyperloglog__);
+
+    // Sorted by (index, rank): the last entry of each index run holds the max rank
+    size_t unique = 0;
+    for (size_t i = 0; i < hll->sparse.current_size; i++)
+    {
+        if (i + 1 < hll->sparse.current_size && (entries[i + 1] >> 6) == (entries[i] >> 6)) continue;
+        entries[unique++] = entries[i];
+    }
+    hll->sparse.current_size = unique;
+}
+
+// Internal use only
+static inline uint8_t __to_dense_hyperloglog__(hyperloglog* const hll)
+{
+    if (!hll->is_sparse) return 0;
+
+    __flush_sparse_hyperloglog__(hll);
+    hll->registers = (uint8_t*)__filter_aligned_calloc__(get_register_count_hyperloglog(hll));
+    if (hll->registers == NULL) return 1;
+
+    for (size_t i = 0; i < hll->sparse.current_size; i++)
+    {
+        const uint32_t entry = dyn_get_uint_32t(hll->sparse.data, i);
+        const uint8_t rank = (uint8_t)(entry & 63);
+        if (hll->registers[entry >> 6] < rank) hll->registers[entry >> 6] = rank;
+    }
+    clean_dyn_array(&hll->sparse);
+    clean_dyn_array(&hll->sparse_buffer);
+    hll->is_sparse = 0;
+    return 0;
+}
+
+// Internal use only
+static inline void __add_encoded_hyperloglog__(hyperloglog* const hll, const uint32_t entry)
+{
+    if (!hll->is_sparse)
+    {
+        const uint8_t rank = (uint8_t)(entry & 63);
+        if (hll->registers[entry >> 6] < rank) hll->registers[entry >> 6] = rank;
+        return;
+    }
+
+    append_item_dyn_array(&hll->sparse_buffer, &entry);
+    if (hll->sparse_buffer.current_size < HYPERLOGLOG_SPARSE_BUFFER_SIZE) return;
+
+    __flush_sparse_hyperloglog__(hll);
+    // 4 bytes per sparse entry vs 1 byte per dense register
+    if ((uint64_t)hll->sparse.current_size * sizeof(uint32_t) > get_register_count_hyperloglog(hll))
+    {
+        __to_dense_hyperloglog__(hll);
+    }
+}
+
+static inline void add_hyperloglog(hyperloglog* const hll, const void* const key, const size_t key_size)
+{
+    __add_encoded_hyperloglog__(hll, __encode_hash_hyperloglog__(hll, __filter_hash__(key, key_size, hll->seed)));
+}
+
+/**
+ * @brief Adds @p count keys stored contiguously, @p key_size bytes each.
+ */
+static inline void add_batch_hyperloglog(hyperloglog* const hll, const void* const keys, const size_t key_size, const uint64_t count)
+{
+    uint32_t entries[HYPERLOGLOG_BATCH_CHUNK];
+
+    for (uint64_t start = 0; start < count; start += HYPERLOGLOG_BATCH_CHUNK)
+    {
+        const uint64_t chunk = (count - start < HYPERLOGLOG_BATCH_CHUNK) ? count - start : HYPERLOGLOG_BATCH_CHUNK;
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            entries[i] = __encode_hash_hyperloglog__(hll, __filter_hash__((const uint8_t*)keys + (start + i) * key_size, key_size, hll->seed));
+            if (!hll->is_sparse) __filter_prefetch__(&hll->registers[entries[i] >> 6]);
+        }
+        for (uint64_t i = 0; i < chunk; i++)
+        {
+            __add_encoded_hyperloglog__(hll, entries[i]);
+        }
+    }
+}
+
+/**
+ * @brief Estimates the number of distinct keys added (linear counting while many registers are still empty).
+ */
+static inline double estimate_hyperloglog(hyperloglog* const hll)
+{
+    const uint64_t m = get_register_count_hyperloglog(hll);
+    double sum = 0.0;
+    uint64_t zeros = 0;
+
+    if (hll->is_sparse)
+    {
+        __flush_sparse_hyperloglog__(hll);
+        zeros = m - hll->sparse.current_size;
+        sum = (double)zeros;
+        for (size_t i = 0; i < hll->sparse.current_size; i++)
+        {
+            sum += ldexp(1.0, -(int)(dyn_get_uint_32t(hll->sparse.data, i) & 63));
+        }
+    }
+    else
+    {
+        for (uint64_t i = 0; i < m; i++)
+        {
+            sum += ldexp(1.0, -(int)hll->registers[i]);
+            zeros += (hll->registers[i] == 0);
+        }
+    }
+
+    double alpha;
+    switch (m)
+    {
+        case 16: alpha = 0.673; break;
+        case 32: alpha = 0.697; break;
+        case 64: alpha = 0.709; break;
+        default: alpha = 0.7213 / (1.0 + 1.079 / (double)m); break;
+    }
+
+    const double estimate = alpha * (double)m * (double)m / sum;
+    if (estimate <= 2.5 * (double)m && zeros != 0)
+    {
+        return (double)m * log((double)m / (double)zeros);
+    }
+    return estimate;
+}
+
+/**
+ * @brief Merges @p src into @p dst (register-wise max); @p dst becomes dense if either sketch is dense.
+ * @return Returns 0 on success, else error (1 precision or seed mismatch; 2 allocation error)
+ */
+static inline uint8_t merge_hyperloglog(hyperloglog* const dst, hyperloglog* const src)
+{
+    if (dst->precision != src->precision || dst->seed != src->seed) return 1;
+
+    if (src->is_sparse)
+    {
+        __flush_sparse_hyperloglog__(src);
+        for (size_t i = 0; i < src->sparse.current_size; i++)
+        {
+            __add_encoded_hyperloglog__(dst, dyn_get_uint_32t(src->sparse.data, i));
+        }
+        return 0;
+    }
+
+    if (__to_dense_hyperloglog__(dst) != 0) return 2;
+
+    const uint64_t m = get_register_count_hyperloglog(dst);
+    uint64_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= m; i += 32)
+    {
+        const __m256i a = _mm256_load_si256((const __m256i*)(dst->registers + i));
+        const __m256i b = _mm256_load_si256((const __m256i*)(src->registers + i));
+        _mm256_store_si256((__m256i*)(dst->registers + i), _mm256_max_epu8(a, b));
+    }
+#elif defined(__SSE2__)
+    for (; i + 16 <= m; i += 16)
+    {
+        const __m128i a = _mm_load_si128((const __m128i*)(dst->registers + i));
+        const __m128i b = _mm_load_si128((const __m128i*)(src->registers + i));
+        _mm_store_si128((__m128i*)(dst->registers + i), _mm_max_epu8(a, b));
+    }
+#endif
+    for (; i < m; i++)
+    {
+        if (dst->registers[i] < src->registers[i]) dst->registers[i] = src->registers[i];
+    }
+    return 0;
+}
+
+/**
+ * @brief Empties the sketch and returns it to sparse mode.
+ */
+static inline void clear_hyperloglog(hyperloglog* const hll)
+{
+    __aligned_free_memory__(hll->registers);
+    hll->registers = NULL;
+    hll->is_sparse = 1;
+    hll->sparse.current_size = 0;
+    hll->sparse_buffer.current_size = 0;
+}
+
+static inline void clean_hyperloglog(hyperloglog* const hll)
+{
+    __aligned_free_memory__(hll->registers);
+    hll->registers = NULL;
+    hll->is_sparse = 1;
+    clean_dyn_array(&hll->sparse);
+    clean_dyn_array(&hll->sparse_buffer);
+}
+
+static inline void free_hyperloglog(hyperloglog* const hll)
+{
+    clean_hyperloglog(hll);
+    free(hll);
+}
+
+#endif
@@ -0,0 +1,660 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "../Dynamic Array/dyn_array.h"
+#include "../Vectors/vector_standards.h"
+#include "../Vectors/vector2.h"
+#include "../Vectors/vector3.h"
+#include "../Hashing/xxHash-3-64.h"
+#include "../Threading/threading.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define SPATIAL_HASH_INITIAL_TABLE_SIZE 64 // per shard; must be a power of 2
+#define SPATIAL_HASH_MIN_BATCH_PER_THREAD 4096 // below this, batch inserts stay on the calling thread
+
+/*
+    Points are bucketed into cubic cells of side `cell_size`. Each occupied cell keeps its points (and their ids)
+    in contiguous dyn_arrays, and cells are found through open-addressed tables keyed on the quantized cell coordinates.
+    The tables are split into shards by the top bits of the cell hash so batch inserts can build shards on separate threads.
+*/
+
+typedef struct spatial_hash_cell
+{
+    int32_t coords[3];
+    dyn_array points; // DYN_ARRAY_VECTOR_3_TYPE
+    dyn_array ids;    // DYN_ARRAY_UINT_32T_TYPE
+} spatial_hash_cell;
+
+typedef struct spatial_hash_shard
+{
+    uint64_t cell_count;
+    uint64_t table_size; // power of 2
+    uint64_t* hashes;
+    spatial_hash_cell** cells; // NULL for empty slots
+} spatial_hash_shard;
+
+typedef struct spatial_hash
+{
+    VECTOR_FLT cell_size;
+    VECTOR_FLT inverse_cell_size;
+    uint8_t dimensions; // 2 or 3; 2D grids keep every point on z = 0
+    uint8_t shard_bits;
+    uint16_t shard_count;
+    uint64_t point_count;
+    spatial_hash_shard* shards;
+} spatial_hash;
+
+/**
+ * @brief Initialize a pre-allocated spatial_hash structure.
+ * @param grid Pointer to the spatial_hash to initialize.
+ * @param cell_size Side length of each cell; queries are fastest when it is close to the typical query radius.
+ * @param dimensions 2 for vector2 points or 3 for vector3 points. Any other value is treated as 3.
+ * @param shard_bits log2 of the number of shards (at most 12). More shards allow more threads during batch inserts.
+ */
+static inline void set_spatial_hash(spatial_hash* const grid, const VECTOR_FLT cell_size, const uint8_t dimensions, uint8_t shard_bits)
+{
+    if (shard_bits > 12) shard_bits = 12;
+
+    grid->cell_size = cell_size;
+    grid->inverse_cell_size = 1 / cell_size;
+    grid->dimensions = (dimensions == 2) ? 2 : 3;
+    grid->shard_bits = shard_bits;
+    grid->shard_count = (uint16_t)(1u << shard_bits);
+    grid->point_count = 0;
+    grid->shards = (spatial_hash_shard*)calloc(grid->shard_count, sizeof(spatial_hash_shard));
+
+    for (int i = 0; i < grid->shard_count; i++)
+    {
+        grid->shards[i].table_size = SPATIAL_HASH_INITIAL_TABLE_SIZE;
+        grid->shards[i].hashes = (uint64_t*)calloc(SPATIAL_HASH_INITIAL_TABLE_SIZE, sizeof(uint64_t));
+        grid->shards[i].cells = (spatial_hash_cell**)calloc(SPATIAL_HASH_INITIAL_TABLE_SIZE, sizeof(spatial_hash_cell*));
+    }
+}
+
+static inline spatial_hash* new_spatial_hash(const VECTOR_FLT cell_size, const uint8_t dimensions, const uint8_t shard_bits)
+{
+    spatial_hash* const grid = (spatial_hash*)calloc(1, sizeof(spatial_hash));
+    set_spatial_hash(grid, cell_size, dimensions, shard_bits);
+    return grid;
+}
+
+// Internal use only
+static inline int32_t __quantize_spatial_hash__(const spatial_hash* const grid, const VECTOR_FLT value)
+{
+    return (int32_t)floorf(value * grid->inverse_cell_size);
+}
+
+// Internal use only
+static inline void __cell_coords_spatial_hash__(const spatial_hash* const grid, const vector3* const point, int32_t coords[3])
+{
+    coords[0] = __quantize_spatial_hash__(grid, point->arr[0]);
+    coords[1] = __quantize_spatial_hash__(grid, point->arr[1]);
+    coords[2] = (grid->dimensions == 2) ? 0 : __quantize_spatial_hash__(grid, point->arr[2]);
+}
+
+// Internal use only
+static inline uint64_t __cell_hash_spatial_hash__(const int32_t coords[3])
+{
+    dyn_array coords_view;
+    set_dyn_array(&coords_view, DYN_ARRAY_UINT_32T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+    coords_view.data = (void*)coords;
+    coords_view.current_size = 3;
+    coords_view.max_size = 3;
+    return digest_XXH3_64(&coords_view);
+}
+
+// Internal use only
+static inline uint16_t __shard_index_spatial_hash__(const spatial_hash* const grid, const uint64_t hash)
+{
+    return (grid->shard_bits == 0) ? 0 : (uint16_t)(hash >> (64 - grid->shard_bits));
+}
+
+// Internal use only
+static inline spatial_hash_cell* __find_cell_spatial_hash__(const spatial_hash_shard* const shard, const int32_t coords[3], const uint64_t hash)
+{
+    const uint64_t mask = shard->table_size - 1;
+    for (uint64_t slot = hash & mask; ; slot = (slot + 1) & mask)
+    {
+        spatial_hash_cell* const cell = shard->cells[slot];
+        if (cell == NULL) return NULL;
+        if (shard->hashes[slot] == hash
+            && cell->coords[0] == coords[0] && cell->coords[1] == coords[1] && cell->coords[2] == coords[2]
+        ) return cell;
+    }
+}
+
+// Internal use only
+static inline void __grow_shard_spatial_hash__(spatial_hash_shard* const shard)
+{
+    const uint64_t old_size = shard->table_size;
+    uint64_t* const old_hashes = shard->hashes;
+    spatial_hash_cell** const old_cells = shard->cells;
+
+    shard->table_size = old_size * 2;
+    shard->hashes = (uint64_t*)calloc(shard->table_size, sizeof(uint64_t));
+    shard->cells = (spatial_hash_cell**)calloc(shard->table_size, sizeof(spatial_hash_cell*));
+
+    const uint64_t mask = shard->table_size - 1;
+    for (uint64_t i = 0; i < old_size; i++)
+    {
+        if (old_cells[i] == NULL) continue;
+
+        uint64_t slot = old_hashes[i] & mask;
+        while (shard->cells[slot] != NULL) slot = (slot + 1) & mask;
+        shard->hashes[slot] = old_hashes[i];
+        shard->cells[slot] = old_cells[i];
+    }
+
+    free(old_hashes);
+    free(old_cells);
+}
+
+// Internal use only
+static inline spatial_hash_cell* __find_or_add_cell_spatial_hash__(spatial_hash_shard* const shard, const int32_t coords[3], const uint64_t hash)
+{
+    if (2 * (shard->cell_count + 1) > shard->table_size) __grow_shard_spatial_hash__(shard);
+
+    const uint64_t mask = shard->table_size - 1;
+    uint64_t slot = hash & mask;
+    for (; shard->cells[slot] != NULL; slot = (slot + 1) & mask)
+    {
+        spatial_hash_cell* const cell = shard->cells[slot];
+        if (shard->hashes[slot] == hash
+            && cell->coords[0] == coords[0] && cell->coords[1] == coords[1] && cell->coords[2] == coords[2]
+        ) return cell;
+    }
+
+    spatial_hash_cell* const cell = (spatial_hash_cell*)calloc(1, sizeof(spatial_hash_cell));
+    cell->coords[0] = coords[0];
+    cell->coords[1] = coords[1];
+    cell->coords[2] = coords[2];
+    set_dyn_array(&cell->points, DYN_ARRAY_VECTOR_3_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+    set_dyn_array(&cell->ids, DYN_ARRAY_UINT_32T_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+
+    shard->hashes[slot] = hash;
+    shard->cells[slot] = cell;
+    shard->cell_count++;
+    return cell;
+}
+
+// Internal use only
+static inline void __add_point_spatial_hash__(spatial_hash_shard* const shard, const int32_t coords[3], const uint64_t hash, const vector3* const point, const uint32_t id)
+{
+    spatial_hash_cell* const cell = __find_or_add_cell_spatial_hash__(shard, coords, hash);
+    append_item_dyn_array(&cell->points, point);
+    append_item_dyn_array(&cell->ids, &id);
+}
+
+/**
+ * @brief Inserts a single point into the grid.
+ * @param grid Pointer to the spatial_hash.
+ * @param point The point to insert (z is ignored for 2D grids).
+ * @param id The id reported back by queries for this point.
+ */
+static inline void insert_spatial_hash(spatial_hash* const grid, const vector3* const point, const uint32_t id)
+{
+    vector3 stored = *point;
+    if (grid->dimensions == 2) stored.arr[2] = 0;
+
+    int32_t coords[3];
+    __cell_coords_spatial_hash__(grid, &stored, coords);
+    const uint64_t hash = __cell_hash_spatial_hash__(coords);
+
+    __add_point_spatial_hash__(&grid->shards[__shard_index_spatial_hash__(grid, hash)], coords, hash, &stored, id);
+    grid->point_count++;
+}
+
+static inline void insert_vec2_spatial_hash(spatial_hash* const grid, const vector2* const point, const uint32_t id)
+{
+    vector3 point_3d;
+    set_vec3(&point_3d, point->arr[0], point->arr[1], 0);
+    insert_spatial_hash(grid, &point_3d, id);
+}
+
+// Internal use only
+struct __spatial_hash_batch_context__
+{
+    spatial_hash* grid;
+    const vector3* points;
+    const uint32_t* ids;
+    uint32_t first_id;
+    uint64_t* hashes; // per point
+};
+
+// Internal use only
+static inline uint32_t __batch_route_spatial_hash__(void* const context_ptr, const uint64_t i)
+{
+    struct __spatial_hash_batch_context__* const context = (struct __spatial_hash_batch_context__*)context_ptr;
+
+    int32_t coords[3];
+    __cell_coords_spatial_hash__(context->grid, &context->points[i], coords);
+    context->hashes[i] = __cell_hash_spatial_hash__(coords);
+    return __shard_index_spatial_hash__(context->grid, context->hashes[i]);
+}
+
+// Internal use only
+static inline void __batch_build_spatial_hash__(void* const context_ptr, const uint32_t shard, const uint64_t* const items, const uint64_t item_count)
+{
+    struct __spatial_hash_batch_context__* const context = (struct __spatial_hash_batch_context__*)context_ptr;
+    spatial_hash* const grid = context->grid;
+
+    for (uint64_t o = 0; o < item_count; o++)
+    {
+        const uint64_t i = items[o];
+
+        vector3 stored = context->points[i];
+        if (grid->dimensions == 2) stored.arr[2] = 0;
+
+        int32_t coords[3];
+        __cell_coords_spatial_hash__(grid, &stored, coords);
+        const uint32_t id = (context->ids != NULL) ? context->ids[i] : context->first_id + (uint32_t)i;
+        __add_point_spatial_hash__(&grid->shards[shard], coords, context->hashes[i], &stored, id);
+    }
+}
+
+/**
+ * @brief Inserts many points at once, hashing and building the shards across threads without locking.
+ * Points are hashed and grouped by shard in parallel (see run_sharded_partition), then each thread fills its own subset of shards.
+ * @param grid Pointer to the spatial_hash.
+ * @param points Array of @p count points.
+ * @param ids Array of @p count ids, or NULL to use the running point count (i.e. ids follow insertion order).
+ * @param count Number of points.
+ * @param thread_count Number of threads to use; 0 uses get_hardware_thread_count(). Capped by the shard count.
+ * @return 0 on success; 1 on allocation failure (nothing is inserted).
+ */
+static inline uint8_t insert_batch_spatial_hash(spatial_hash* const grid, const vector3* const points, const uint32_t* const ids, const uint64_t count, unsigned int thread_count)
+{
+    if (count == 0) return 0;
+
+    if (thread_count == 0) thread_count = get_hardware_thread_count();
+    if (thread_count > grid->shard_count) thread_count = grid->shard_count;
+    if (thread_count > count / SPATIAL_HASH_MIN_BATCH_PER_THREAD) thread_count = (unsigned int)(count / SPATIAL_HASH_MIN_BATCH_PER_THREAD);
+    if (thread_count < 1) thread_count = 1;
+
+    const uint32_t first_id = (uint32_t)grid->point_count;
+    if (thread_count == 1)
+    {
+        for (uint64_t i = 0; i < count; i++)
+            insert_spatial_hash(grid, &points[i], (ids != NULL) ? ids[i] : first_id + (uint32_t)i);
+        return 0;
+    }
+
+    struct __spatial_hash_batch_context__ context;
+    context.grid = grid;
+    context.points = points;
+    context.ids = ids;
+    context.first_id = first_id;
+    context.hashes = (uint64_t*)malloc(count * sizeof(uint64_t));
+    if (context.hashes == NULL) return 1;
+
+    if (run_sharded_partition(thread_count, count, grid->shard_count, __batch_route_spatial_hash__, __batch_build_spatial_hash__, &context) != 0)
+    {
+        free(context.hashes);
+        return 1;
+    }
+    grid->point_count += count;
+
+    free(context.hashes);
+    return 0;
+}
+
+static inline uint8_t insert_batch_vec2_spatial_hash(spatial_hash* const grid, const vector2* const points, const uint32_t* const ids, const uint64_t count, const unsigned int thread_count)
+{
+    vector3* const points_3d = (vector3*)malloc(count * sizeof(vector3));
+    if (points_3d == NULL) return 1;
+
+    for (uint64_t i = 0; i < count; i++) set_vec3(&points_3d[i], points[i].arr[0], points[i].arr[1], 0);
+    const uint8_t return_code = insert_batch_spatial_hash(grid, points_3d, ids, count, thread_count);
+
+    free(points_3d);
+    return return_code;
+}
+
+/**
+ * @brief Returns the cell containing @p point, or NULL if no points have been inserted in it.
+ */
+static inline const spatial_hash_cell* get_cell_spatial_hash(const spatial_hash* const grid, const vector3* const point)
+{
+    int32_t coords[3];
+    __cell_coords_spatial_hash__(grid, point, coords);
+    const uint64_t hash = __cell_hash_spatial_hash__(coords);
+    return __find_cell_spatial_hash__(&grid->shards[__shard_index_spatial_hash__(grid, hash)], coords, hash);
+}
+
+// Internal use only
+static inline const spatial_hash_cell* __get_cell_at_spatial_hash__(const spatial_hash* const grid, const int32_t coords[3])
+{
+    const uint64_t hash = __cell_hash_spatial_hash__(coords);
+    return __find_cell_spatial_hash__(&grid->shards[__shard_index_spatial_hash__(grid, hash)], coords, hash);
+}
+
+/**
+ * @brief Appends the ids of every point within the axis-aligned box [@p min_corner, @p max_corner] (inclusive) to @p out_ids.
+ * @param out_ids A dyn_array of DYN_ARRAY_UINT_32T_TYPE; existing items are kept.
+ * @return The number of ids appended.
+ */
+static inline uint64_t query_aabb_spatial_hash(const spatial_hash* const grid, const vector3* const min_corner, const vector3* const max_corner, dyn_array* const out_ids)
+{
+    int32_t low[3], high[3];
+    __cell_coords_spatial_hash__(grid, min_corner, low);
+    __cell_coords_spatial_hash__(grid, max_corner, high);
+
+    const VECTOR_FLT min_z = (grid->dimensions == 2) ? 0 : min_corner->arr[2];
+    const VECTOR_FLT max_z = (grid->dimensions == 2) ? 0 : max_corner->arr[2];
+
+    uint64_t found = 0;
+    int32_t coords[3];
+    for (coords[2] = low[2]; coords[2] <= high[2]; coords[2]++)
+    for (coords[1] = low[1]; coords[1] <= high[1]; coords[1]++)
+    for (coords[0] = low[0]; coords[0] <= high[0]; coords[0]++)
+    {
+        const spatial_hash_cell* const cell = __get_cell_at_spatial_hash__(grid, coords);
+        if (cell == NULL) continue;
+
+        const vector3* const cell_points = (const vector3*)cell->points.data;
+        const uint32_t* const cell_ids = (const uint32_t*)cell->ids.data;
+        for (uint64_t i = 0; i < cell->points.current_size; i++)
+        {
+            const vector3* const p = &cell_points[i];
+            if (p->arr[0] < min_corner->arr[0] || p->arr[0] > max_corner->arr[0]) continue;
+            if (p->arr[1] < min_corner->arr[1] || p->arr[1] > max_corner->arr[1]) continue;
+            if (p->arr[2] < min_z || p->arr[2] > max_z) continue;
+
+            append_item_dyn_array(out_ids, &cell_ids[i]);
+            found++;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Appends the ids of every point within @p radius (inclusive) of @p center to @p out_ids.
+ * @param out_ids A dyn_array of DYN_ARRAY_UINT_32T_TYPE; existing items are kept.
+ * @return The number of ids appended.
+ */
+static inline uint64_t query_radius_spatial_hash(const spatial_hash* const grid, const vector3* const center, const VECTOR_FLT radius, dyn_array* const out_ids)
+{
+    vector3 low, high;
+    set_vec3(&low, center->arr[0] - radius, center->arr[1] - radius, center->arr[2] - radius);
+    set_vec3(&high, center->arr[0] + radius, center->arr[1] + radius, center->arr[2] + radius);
+
+    int32_t low_cell[3], high_cell[3];
+    __cell_coords_spatial_hash__(grid, &low, low_cell);
+    __cell_coords_spatial_hash__(grid, &high, high_cell);
+
+    const VECTOR_FLT center_z = (grid->dimensions == 2) ? 0 : center->arr[2];
+    const VECTOR_FLT radius_sq = radius * radius;
+
+    uint64_t found = 0;
+    int32_t coords[3];
+    for (coords[2] = low_cell[2]; coords[2] <= high_cell[2]; coords[2]++)
+    for (coords[1] = low_cell[1]; coords[1] <= high_cell[1]; coords[1]++)
+    for (coords[0] = low_cell[0]; coords[0] <= high_cell[0]; coords[0]++)
+    {
+        const spatial_hash_cell* const cell = __get_cell_at_spatial_hash__(grid, coords);
+        if (cell == NULL) continue;
+
+        const vector3* const cell_points = (const vector3*)cell->points.data;
+        const uint32_t* const cell_ids = (const uint32_t*)cell->ids.data;
+        for (uint64_t i = 0; i < cell->points.current_size; i++)
+        {
+            const VECTOR_FLT dx = cell_points[i].arr[0] - center->arr[0];
+            const VECTOR_FLT dy = cell_points[i].arr[1] - center->arr[1];
+            const VECTOR_FLT dz = cell_points[i].arr[2] - center_z;
+            if (dx*dx + dy*dy + dz*dz > radius_sq) continue;
+
+            append_item_dyn_array(out_ids, &cell_ids[i]);
+            found++;
+        }
+    }
+    return found;
+}
+
+// Internal use only; max-heap on distance so the current worst neighbour is at the top
+static inline void __knn_sift_down_spatial_hash__(VECTOR_FLT* const dists, uint32_t* const ids, const uint64_t size, uint64_t i)
+{
+    while (1)
+    {
+        const uint64_t left = 2*i + 1;
+        const uint64_t right = left + 1;
+        uint64_t largest = i;
+        if (left < size && dists[left] > dists[largest]) largest = left;
+        if (right < size && dists[right] > dists[largest]) largest = right;
+        if (largest == i) return;
+
+        const VECTOR_FLT tmp_dist = dists[i]; dists[i] = dists[largest]; dists[largest] = tmp_dist;
+        const uint32_t tmp_id = ids[i]; ids[i] = ids[largest]; ids[largest] = tmp_id;
+        i = largest;
+    }
+}
+
+// Internal use only
+static inline void __knn_push_spatial_hash__(VECTOR_FLT* const dists, uint32_t* const ids, uint64_t* const size, const uint64_t k, const VECTOR_FLT dist, const uint32_t id)
+{
+    if (*size < k)
+    {
+        uint64_t i = (*size)++;
+        dists[i] = dist;
+        ids[i] = id;
+        while (i > 0)
+        {
+            const uint64_t parent = (i - 1) / 2;
+            if (dists[parent] >= dists[i]) break;
+            const VECTOR_FLT tmp_dist = dists[i]; dists[i] = dists[parent]; dists[parent] = tmp_dist;
+            const uint32_t tmp_id = ids[i]; ids[i] = ids[parent]; ids[parent] = tmp_id;
+            i = parent;
+        }
+    }
+    else if (dist < dists[0])
+    {
+        dists[0] = dist;
+        ids[0] = id;
+        __knn_sift_down_spatial_hash__(dists, ids, *size, 0);
+    }
+}
+
+// Offers every point of `cell` (may be NULL) to the k-nearest heap; returns the number of points in the cell
+// Internal use only
+static inline uint64_t __knn_visit_cell_spatial_hash__(const spatial_hash_cell* const cell, const vector3* const query, const uint8_t limited, const VECTOR_FLT max_radius_sq, VECTOR_FLT* const dists, uint32_t* const ids, uint64_t* const heap_size, const uint64_t k)
+{
+    if (cell == NULL) return 0;
+
+    const vector3* const cell_points = (const vector3*)cell->points.data;
+    const uint32_t* const cell_ids = (const uint32_t*)cell->ids.data;
+    for (uint64_t i = 0; i < cell->points.current_size; i++)
+    {
+        const VECTOR_FLT ddx = cell_points[i].arr[0] - query->arr[0];
+        const VECTOR_FLT ddy = cell_points[i].arr[1] - query->arr[1];
+        const VECTOR_FLT ddz = cell_points[i].arr[2] - query->arr[2];
+        const VECTOR_FLT dist_sq = ddx*ddx + ddy*ddy + ddz*ddz;
+        if (limited && dist_sq > max_radius_sq) continue;
+        __knn_push_spatial_hash__(dists, ids, heap_size, k, dist_sq, cell_ids[i]);
+    }
+    return cell->points.current_size;
+}
+
+/**
+ * @brief Appends the ids of the @p k points nearest to @p center to @p out_ids, nearest first.
+ * Searches outwards one ring of cells at a time and stops once no unvisited cell can hold a closer point;
+ * once a ring would cover more cells than are occupied, the occupied cells are scanned instead.
+ * @param out_ids A dyn_array of DYN_ARRAY_UINT_32T_TYPE; existing items are kept.
+ * @param max_radius Points further than this are ignored; pass a negative value for no limit.
+ * @return The number of ids appended (less than @p k if the grid holds fewer points in range).
+ */
+static inline uint64_t query_k_nearest_spatial_hash(const spatial_hash* const grid, const vector3* const center, const uint64_t k, const VECTOR_FLT max_radius, dyn_array* const out_ids)
+{
+    if (k == 0 || grid->point_count == 0) return 0;
+
+    VECTOR_FLT* const dists = (VECTOR_FLT*)malloc(k * sizeof(VECTOR_FLT)); // squared distances
+    uint32_t* const ids = (uint32_t*)malloc(k * sizeof(uint32_t));
+    if (dists == NULL || ids == NULL) { free(dists); free(ids); return 0; }
+
+    vector3 query = *center;
+    if (grid->dimensions == 2) query.arr[2] = 0;
+
+    int32_t origin[3];
+    __cell_coords_spatial_hash__(grid, &query, origin);
+
+    const uint8_t limited = (max_radius >= 0);
+    const VECTOR_FLT max_radius_sq = max_radius * max_radius;
+    const int64_t max_ring = limited ? (int64_t)ceilf(max_radius * grid->inverse_cell_size) + 1 : INT32_MAX;
+
+    uint64_t cell_count = 0;
+    for (int i = 0; i < grid->shard_count; i++) cell_count += grid->shards[i].cell_count;
+
+    uint64_t heap_size = 0;
+    uint64_t points_seen = 0;
+    for (int64_t ring = 0; ring <= max_ring; ring++)
+    {
+        // Once the ring holds more cells than are occupied, scanning the occupied cells is cheaper
+        uint64_t volume = 1;
+        for (int d = 0; d < grid->dimensions && volume <= cell_count; d++) volume *= (uint64_t)(2 * ring + 1);
+        if (volume > cell_count)
+        {
+            for (int i = 0; i < grid->shard_count; i++)
+            {
+                const spatial_hash_shard* const shard = &grid->shards[i];
+                for (uint64_t slot = 0; slot < shard->table_size; slot++)
+                {
+                    const spatial_hash_cell* const cell = shard->cells[slot];
+                    if (cell == NULL) continue;
+
+                    // Skip the cells earlier rings visited
+                    const int64_t ring_x = llabs((int64_t)cell->coords[0] - origin[0]);
+                    const int64_t ring_y = llabs((int64_t)cell->coords[1] - origin[1]);
+                    const int64_t ring_z = llabs((int64_t)cell->coords[2] - origin[2]);
+                    if (ring_x < ring && ring_y < ring && ring_z < ring) continue;
+
+                    __knn_visit_cell_spatial_hash__(cell, &query, limited, max_radius_sq, dists, ids, &heap_size, k);
+                }
+            }
+            break;
+        }
+
+        // Walk only the shell of the ring: the z = +-ring slabs, then the y = +-ring rows, then the x = +-ring cells
+        const int64_t shell_step = (ring == 0) ? 1 : 2 * ring;
+        const int64_t z_inner = (grid->dimensions == 2) ? 0 : ring - 1;
+        int32_t coords[3];
+        if (grid->dimensions != 2)
+        {
+            for (int64_t dz = -ring; dz <= ring; dz += shell_step)
+            for (int64_t dy = -ring; dy <= ring; dy++)
+            for (int64_t dx = -ring; dx <= ring; dx++)
+            {
+                coords[0] = (int32_t)(origin[0] + dx);
+                coords[1] = (int32_t)(origin[1] + dy);
+                coords[2] = (int32_t)(origin[2] + dz);
+                points_seen += __knn_visit_cell_spatial_hash__(__get_cell_at_spatial_hash__(grid, coords), &query, limited, max_radius_sq, dists, ids, &heap_size, k);
+            }
+        }
+        for (int64_t dz = -z_inner; dz <= z_inner; dz++)
+        {
+            for (int64_t dy = -ring; dy <= ring; dy += shell_step)
+            for (int64_t dx = -ring; dx <= ring; dx++)
+            {
+                coords[0] = (int32_t)(origin[0] + dx);
+                coords[1] = (int32_t)(origin[1] + dy);
+                coords[2] = (int32_t)(origin[2] + dz);
+                points_seen += __knn_visit_cell_spatial_hash__(__get_cell_at_spatial_hash__(grid, coords), &query, limited, max_radius_sq, dists, ids, &heap_size, k);
+            }
+            for (int64_t dy = -ring + 1; dy <= ring - 1; dy++)
+            for (int64_t dx = -ring; dx <= ring; dx += shell_step)
+            {
+                coords[0] = (int32_t)(origin[0] + dx);
+                coords[1] = (int32_t)(origin[1] + dy);
+                coords[2] = (int32_t)(origin[2] + dz);
+                points_seen += __knn_visit_cell_spatial_hash__(__get_cell_at_spatial_hash__(grid, coords), &query, limited, max_radius_sq, dists, ids, &heap_size, k);
+            }
+        }
+
+        // Every unvisited point is at least `ring` cells away
+        const VECTOR_FLT reach = (VECTOR_FLT)ring * grid->cell_size;
+        if (heap_size == k && dists[0] <= reach * reach) break;
+        if (points_seen >= grid->point_count) break;
+    }
+
+    // Pop the heap from worst to best, then append nearest first
+    const uint64_t found = heap_size;
+    while (heap_size > 1)
+    {
+        heap_size--;
+        const VECTOR_FLT tmp_dist = dists[0]; dists[0] = dists[heap_size]; dists[heap_size] = tmp_dist;
+        const uint32_t tmp_id = ids[0]; ids[0] = ids[heap_size]; ids[heap_size] = tmp_id;
+        __knn_sift_down_spatial_hash__(dists, ids, heap_size, 0);
+    }
+    for (uint64_t i = 0; i < found; i++) append_item_dyn_array(out_ids, &ids[i]);
+
+    free(dists);
+    free(ids);
+    return found;
+}
+
+static inline uint64_t query_aabb_vec2_spatial_hash(const spatial_hash* const grid, const vector2* const min_corner, const vector2* const max_corner, dyn_array* const out_ids)
+{
+    vector3 low, high;
+    set_vec3(&low, min_corner->arr[0], min_corner->arr[1], 0);
+    set_vec3(&high, max_corner->arr[0], max_corner->arr[1], 0);
+    return query_aabb_spatial_hash(grid, &low, &high, out_ids);
+}
+
+static inline uint64_t query_radius_vec2_spatial_hash(const spatial_hash* const grid, const vector2* const center, const VECTOR_FLT radius, dyn_array* const out_ids)
+{
+    vector3 center_3d;
+    set_vec3(&center_3d, center->arr[0], center->arr[1], 0);
+    return query_radius_spatial_hash(grid, &center_3d, radius, out_ids);
+}
+
+static inline uint64_t query_k_nearest_vec2_spatial_hash(const spatial_hash* const grid, const vector2* const center, const uint64_t k, const VECTOR_FLT max_radius, dyn_array* const out_ids)
+{
+    vector3 center_3d;
+    set_vec3(&center_3d, center->arr[0], center->arr[1], 0);
+    return query_k_nearest_spatial_hash(grid, &center_3d, k, max_radius, out_ids);
+}
+
+/**
+ * @brief Removes every point but keeps the cell tables allocated, for grids that are rebuilt every frame.
+ */
+static inline void clear_spatial_hash(spatial_hash* const grid)
+{
+    for (int s = 0; s < grid->shard_count; s++)
+    {
+        spatial_hash_shard* const shard = &grid->shards[s];
+        for (uint64_t i = 0; i < shard->table_size; i++)
+        {
+            spatial_hash_cell* const cell = shard->cells[i];
+            if (cell == NULL) continue;
+
+            clean_dyn_array(&cell->points);
+            clean_dyn_array(&cell->ids);
+            free(cell);
+            shard->cells[i] = NULL;
+        }
+        shard->cell_count = 0;
+    }
+    grid->point_count = 0;
+}
+
+static inline void clean_spatial_hash(spatial_hash* const grid)
+{
+    if (grid->shards == NULL) return;
+
+    clear_spatial_hash(grid);
+    for (int s = 0; s < grid->shard_count; s++)
+    {
+        free(grid->shards[s].hashes);
+        free(grid->shards[s].cells);
+    }
+    free(grid->shards);
+    grid->shards = NULL;
+}
+
+static inline void free_spatial_hash(spatial_hash* const grid)
+{
+    clean_spatial_hash(grid);
+    free(grid);
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include "../Memory/allocator.h"
+
 #include <stdlib.h>
 
 #ifndef min
@@ -20,6 +22,7 @@ typedef struct queue_int {
     struct queue_int_body* last_queue;
 
     struct queue_int_body* freed_queue;
+    const allocator* allocator; // bodies and their data; NULL uses malloc / free (see set_allocator_queue_int)
 } queue_int;
 
 typedef struct queue_int_body {
@@ -29,29 +32,53 @@ typedef struct queue_int_body {
     int* data;
 } queue_int_body;
 
-static inline void set_queue_int_body(queue_int_body* const queue, queue_int_body* const next_queue, const unsigned int queue_size)
+// alloc: where the body's data lives (NULL uses malloc / free); release it with clean_queue_int_body_with_allocator and the same alloc
+static inline void set_queue_int_body_with_allocator(queue_int_body* const queue, queue_int_body* const next_queue, const unsigned int queue_size, const allocator* const alloc)
 {
     queue->next_queue = next_queue;
     queue->current_size = 0;
     queue->queue_size = min(queue_size, 1);
-    queue->data = (int*)calloc(queue->queue_size, sizeof(int));
+    queue->data = (int*)mem_calloc(alloc, queue->queue_size, sizeof(int));
 }
 
-static inline queue_int_body* new_queue_int_body(queue_int_body* const next_queue, const unsigned int queue_size)
+static inline void set_queue_int_body(queue_int_body* const queue, queue_int_body* const next_queue, const unsigned int queue_size)
+{
+    set_queue_int_body_with_allocator(queue, next_queue, queue_size, NULL);
+}
+
+static inline queue_int_body* new_queue_int_body_with_allocator(queue_int_body* const next_queue, const unsigned int queue_size, const allocator* const alloc)
 {
-    queue_int_body* queue = (queue_int_body*)calloc(1, sizeof(queue_int_body));
-    set_queue_int_body(queue, next_queue, queue_size);
+    queue_int_body* queue = (queue_int_body*)mem_calloc(alloc, 1, sizeof(queue_int_body));
+    set_queue_int_body_with_allocator(queue, next_queue, queue_size, alloc);
     return queue;
 }
 
+static inline queue_int_body* new_queue_int_body(queue_int_body* const next_queue, const unsigned int queue_size)
+{
+    return new_queue_int_body_with_allocator(next_queue, queue_size, NULL);
+}
+
+static inline void clean_queue_int_body_with_allocator(queue_int_body* const queue, const allocator* const alloc)
+{
+    if (queue->data != NULL) mem_free(alloc, queue->data, queue->queue_size * sizeof(int));
+}
+
 static inline void clean_queue_int_body(queue_int_body* const queue)
 {
-    if (queue->data != NULL) free(queue->data);
+    clean_queue_int_body_with_allocator(queue, NULL);
+}
+
+// Internal use only
+static inline void __free_queue_int_body__(queue_int_body* const queue, const allocator* const alloc)
+{
+    clean_queue_int_body_with_allocator(queue, alloc);
+    mem_free(alloc, queue, sizeof(queue_int_body));
 }
 
 static inline void set_queue_int(queue_int* const queue, const unsigned int initial_queue_size, const enum queue_expansion_type expansion_type)
 {
     queue->expansion_type = expansion_type;
+    queue->allocator = NULL;
     queue->first_queue = new_queue_int_body(NULL, initial_queue_size);
     queue->last_queue = queue->first_queue;
     queue->freed_queue = NULL;
@@ -64,16 +91,38 @@ static inline queue_int* new_queue_int(const unsigned int initial_queue_size, co
     return queue;
 }
 
+// Bodies and their data come from alloc from now on (NULL uses malloc / free). Only valid while the queue is empty; returns 0 on success
+static inline int set_allocator_queue_int(queue_int* const queue, const allocator* const alloc)
+{
+    if (queue->first_queue != queue->last_queue || queue->first_queue->current_size != 0) return 1;
+
+    queue_int_body* const body = new_queue_int_body_with_allocator(NULL, queue->first_queue->queue_size, alloc);
+    if (body == NULL) return 1;
+    if (body->data == NULL)
+    {
+        mem_free(alloc, body, sizeof(queue_int_body));
+        return 1;
+    }
+    __free_queue_int_body__(queue->first_queue, queue->allocator);
+    if (queue->freed_queue != NULL) __free_queue_int_body__(queue->freed_queue, queue->allocator);
+    queue->first_queue = body;
+    queue->last_queue = body;
+    queue->freed_queue = NULL;
+    queue->allocator = alloc;
+    return 0;
+}
+
 static inline void clean_queue_int(queue_int* const queue)
 {
     queue_int_body* current_queue = queue->first_queue;
     while (current_queue != NULL)
     {
         queue_int_body* next_queue = current_queue->next_queue;
-        clean_queue_int_body(current_queue);
-        free(current_queue);
+        __free_queue_int_body__(current_queue, queue->allocator);
         current_queue = next_queue;
     }
+    if (queue->freed_queue != NULL) __free_queue_int_body__(queue->freed_queue, queue->allocator);
+    queue->freed_queue = NULL;
 }
 
 // Returns 0 on success
@@ -93,7 +142,7 @@ static inline int push_queue_int(queue_int* const queue, const int value)
                     new_queue_size = current_queue->queue_size;
                     break;
             }
-            new_queue = new_queue_int_body(NULL, new_queue_size);
+            new_queue = new_queue_int_body_with_allocator(NULL, new_queue_size, queue->allocator);
         }
         else
         {
@@ -128,8 +177,7 @@ static inline int pop_queue_int(queue_int* const queue)
         }
         else
         {
-            clean_queue_int_body(current_queue);
-            free(current_queue);
+            __free_queue_int_body__(current_queue, queue->allocator);
         }
         current_queue = queue->last_queue;
     }
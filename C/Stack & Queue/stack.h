@@ -1,6 +1,8 @@
 #ifndef STACK_H
 #define STACK_H
 
+#include "../Memory/allocator.h"
+
 #include <stdlib.h>
 
 #ifndef min
@@ -19,6 +21,7 @@ typedef struct stack_int {
     enum stack_expansion_type expansion_type;
     struct stack_int_body* first_stack;
     struct stack_int_body* last_stack;
+    const allocator* allocator; // bodies and their data; NULL uses malloc / free (see set_allocator_stack_int)
 } stack_int;
 
 typedef struct stack_int_body {
@@ -28,29 +31,53 @@ typedef struct stack_int_body {
     int* data;
 } stack_int_body;
 
-static inline void set_stack_int_body(stack_int_body* const stack, stack_int_body* const prev_stack, const unsigned int stack_size)
+// alloc: where the body's data lives (NULL uses malloc / free); release it with clean_stack_int_body_with_allocator and the same alloc
+static inline void set_stack_int_body_with_allocator(stack_int_body* const stack, stack_int_body* const prev_stack, const unsigned int stack_size, const allocator* const alloc)
 {
     stack->prev_stack = prev_stack;
     stack->current_size = 0;
     stack->stack_size = min(stack_size, 1);
-    stack->data = (int*)calloc(stack->stack_size, sizeof(int));
+    stack->data = (int*)mem_calloc(alloc, stack->stack_size, sizeof(int));
 }
 
-static inline stack_int_body* new_stack_int_body(stack_int_body* const prev_stack, const unsigned int stack_size)
+static inline void set_stack_int_body(stack_int_body* const stack, stack_int_body* const prev_stack, const unsigned int stack_size)
+{
+    set_stack_int_body_with_allocator(stack, prev_stack, stack_size, NULL);
+}
+
+static inline stack_int_body* new_stack_int_body_with_allocator(stack_int_body* const prev_stack, const unsigned int stack_size, const allocator* const alloc)
 {
-    stack_int_body* stack = (stack_int_body*)calloc(1, sizeof(stack_int_body));
-    set_stack_int_body(stack, prev_stack, stack_size);
+    stack_int_body* stack = (stack_int_body*)mem_calloc(alloc, 1, sizeof(stack_int_body));
+    set_stack_int_body_with_allocator(stack, prev_stack, stack_size, alloc);
     return stack;
 }
 
+static inline stack_int_body* new_stack_int_body(stack_int_body* const prev_stack, const unsigned int stack_size)
+{
+    return new_stack_int_body_with_allocator(prev_stack, stack_size, NULL);
+}
+
+static inline void clean_stack_int_body_with_allocator(stack_int_body* const stack, const allocator* const alloc)
+{
+    if (stack->data != NULL) mem_free(alloc, stack->data, stack->stack_size * sizeof(int));
+}
+
 static inline void clean_stack_int_body(stack_int_body* const stack)
 {
-    if (stack->data != NULL) free(stack->data);
+    clean_stack_int_body_with_allocator(stack, NULL);
+}
+
+// Internal use only
+static inline void __free_stack_int_body__(stack_int_body* const stack, const allocator* const alloc)
+{
+    clean_stack_int_body_with_allocator(stack, alloc);
+    mem_free(alloc, stack, sizeof(stack_int_body));
 }
 
 static inline void set_stack_int(stack_int* const stack, const unsigned int initial_stack_size, const enum stack_expansion_type expansion_type)
 {
     stack->expansion_type = expansion_type;
+    stack->allocator = NULL;
     stack->first_stack = new_stack_int_body(NULL, initial_stack_size);
     stack->last_stack = stack->first_stack;
 }
@@ -62,14 +89,32 @@ static inline stack_int* new_stack_int(const unsigned int initial_stack_size, co
     return stack;
 }
 
+// Bodies and their data come from alloc from now on (NULL uses malloc / free). Only valid while the stack is empty; returns 0 on success
+static inline int set_allocator_stack_int(stack_int* const stack, const allocator* const alloc)
+{
+    if (stack->first_stack != stack->last_stack || stack->first_stack->current_size != 0) return 1;
+
+    stack_int_body* const body = new_stack_int_body_with_allocator(NULL, stack->first_stack->stack_size, alloc);
+    if (body == NULL) return 1;
+    if (body->data == NULL)
+    {
+        mem_free(alloc, body, sizeof(stack_int_body));
+        return 1;
+    }
+    __free_stack_int_body__(stack->first_stack, stack->allocator);
+    stack->first_stack = body;
+    stack->last_stack = body;
+    stack->allocator = alloc;
+    return 0;
+}
+
 static inline void clean_stack_int(stack_int* const stack)
 {
     stack_int_body* current_stack = stack->last_stack;
     while (current_stack != NULL)
     {
         stack_int_body* prev_stack = current_stack->prev_stack;
-        clean_stack_int_body(current_stack);
-        free(current_stack);
+        __free_stack_int_body__(current_stack, stack->allocator);
         current_stack = prev_stack;
     }
 }
@@ -91,7 +136,7 @@ static inline int push_stack_int(stack_int* const stack, const int value)
                 new_stack_size = current_stack->stack_size;
                 break;
         }
-        current_stack = new_stack_int_body(current_stack, new_stack_size);
+        current_stack = new_stack_int_body_with_allocator(current_stack, new_stack_size, stack->allocator);
         stack->last_stack = current_stack;
     }
 
@@ -109,8 +154,7 @@ static inline int pop_stack_int(stack_int* const stack)
         if (stack->first_stack == stack->last_stack) return 0; // stack is empty
 
         stack->last_stack = current_stack->prev_stack;
-        clean_stack_int_body(current_stack);
-        free(current_stack);
+        __free_stack_int_body__(current_stack, stack->allocator);
         current_stack = stack->last_stack;
     }
 
@@ -2,6 +2,9 @@
 #define STRING_H
 
 #include <stdlib.h>
+#include <string.h>
+
+#include "../Memory/allocator.h"
 
 #ifndef min
     #define min(a,b) (((a) < (b)) ? (a) : (b))
@@ -11,422 +14,318 @@
 #endif
 
 #define MIN_STRING_ARR_LEN 32
+#define STRING_INLINE_CAPACITY 23 // characters kept inside the struct (plus the terminator) before spilling to the heap
 
 #define UNICODE_DIGIT_BASE 48
 #define UNICODE_UPPER_ALPHA_BASE 65
 
 typedef struct __String String;
 
+/*
+    Short strings (up to STRING_INLINE_CAPACITY characters) live in inline_string, so they need no buffer allocation;
+    longer ones spill to a heap buffer of arr_length bytes. The inline buffer holds no pointer to itself, so Strings
+    can be moved bytewise (e.g. inside a dyn_array), and a zeroed String is a valid empty string.
+    Read the characters through getCharArr(), never through the union members directly.
+*/
 struct __String
 {
-    int str_length;
-    int arr_length;
-    char* string;
+    size_t str_length;
+    size_t arr_length; // heap buffer size; 0 while the characters are inline
+    union
+    {
+        char* string; // arr_length > 0
+        char inline_string[STRING_INLINE_CAPACITY + 1]; // arr_length == 0
+    };
+    const allocator* allocator; // the struct (from the newString* constructors) and its buffer come from here; NULL uses malloc / free
 };
 
 // Returns the lowest power of two greater than or equal to `x`
 // Internal use only
-static inline int __next_pow_2__(int x) {
-    // Can be optimised to fit int size with less instructions
-    int y = x;
-    while (x &= (x^(~x+1))) 
-        y = x << 1;
+static inline size_t __next_pow_2__(const size_t x) {
+    if (x <= 1) return x;
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)1 << (64 - __builtin_clzll((unsigned long long)(x - 1)));
+#else
+    size_t y = 1;
+    while (y < x) y <<= 1;
     return y;
+#endif
+}
+
+// The character buffer, inline or on the heap
+// Internal use only
+static inline char* __chars_string__(const struct __String* const str)
+{
+    return (str->arr_length == 0) ? (char*)str->inline_string : str->string;
+}
+
+// Bytes available for the characters and the terminator
+// Internal use only
+static inline size_t __capacity_string__(const struct __String* const str)
+{
+    return (str->arr_length == 0) ? (STRING_INLINE_CAPACITY + 1) : str->arr_length;
 }
 
+// Moves the characters to a heap buffer of `length` bytes, or inline when `length` is 0 (keeping what fits)
 // To be used rarely with extreme caution
 // Internal use only
-static inline void __set_arr_length__(struct __String* const str, const int length)
+static inline void __set_arr_length__(struct __String* const str, const size_t length)
 {
-    if (str->arr_length != length)
+    if (str->arr_length == length) return;
+
+    if (str->arr_length == 0) // inline -> heap
+    {
+        char* const buffer = (char*) mem_alloc(str->allocator, length * sizeof(char));
+        memcpy(buffer, str->inline_string, min(length, (size_t)(STRING_INLINE_CAPACITY + 1)));
+        str->string = buffer;
+    }
+    else if (length == 0) // heap -> inline; the pointer shares storage with inline_string, so keep it aside
     {
-        str->arr_length = length;
-        str->string = (char*) realloc(str->string, str->arr_length * sizeof(char));
+        char* const buffer = str->string;
+        memcpy(str->inline_string, buffer, min(str->arr_length, (size_t)(STRING_INLINE_CAPACITY + 1)));
+        mem_free(str->allocator, buffer, str->arr_length * sizeof(char));
     }
+    else
+    {
+        str->string = (char*) mem_realloc(str->allocator, str->string, str->arr_length * sizeof(char), length * sizeof(char));
+    }
+    str->arr_length = length;
 }
 
 // Internal use only
-static inline void __set_arr_to_min_str_length__(struct __String* const str, const int str_length)
+static inline void __set_arr_to_min_str_length__(struct __String* const str, const size_t str_length)
 {
-    const int new_length = max(MIN_STRING_ARR_LEN, __next_pow_2__(str_length+1));
+    const size_t new_length = (str_length <= STRING_INLINE_CAPACITY) ? 0 : max((size_t)MIN_STRING_ARR_LEN, __next_pow_2__(str_length+1));
     if (str->arr_length != new_length)
     {
-        str->arr_length = new_length;
-        str->string = (char*) realloc(str->string, str->arr_length * sizeof(char));
-        str->string[str->arr_length - 1] = '\0'; // FOR SAFETY, is performance neg.ve
+        __set_arr_length__(str, new_length);
+        __chars_string__(str)[__capacity_string__(str) - 1] = '\0'; // FOR SAFETY, is performance neg.ve
     }
 }
 
+// ASSUMES that str_length < arr_length/2
 // Internal use only
-static inline void __increase_arr_length__(struct __String* const str)
+static inline void __decrease_arr_length__(struct __String* const str)
 {
-    str->arr_length *= 2;
-    str->string = (char*) realloc(str->string, str->arr_length * sizeof(char));
+    const size_t new_length = str->arr_length / 2;
+    __set_arr_length__(str, (new_length <= STRING_INLINE_CAPACITY + 1) ? 0 : new_length);
+    __chars_string__(str)[__capacity_string__(str) - 1] = '\0'; // FOR SAFETY
 }
 
-// ASSUMES that str_length < arr_length/2
+// Replaces the contents with `length` chars; char_arr may point into str's own characters
 // Internal use only
-static inline void __decrease_arr_length__(struct __String* const str)
+static inline void __write_chars_string__(struct __String* const str, const char* const char_arr, const size_t length)
 {
-    str->arr_length = (str->arr_length > 1) ? (str->arr_length / 2) : 1;
-    str->string = (char*) realloc(str->string, str->arr_length * sizeof(char));
-    str->string[str->arr_length - 1] = '\0'; // FOR SAFETY
+    if (length < __capacity_string__(str)) // copy before any shrink so the source stays valid
+    {
+        memmove(__chars_string__(str), char_arr, length * sizeof(char));
+        __chars_string__(str)[length] = '\0';
+        str->str_length = length;
+        __set_arr_to_min_str_length__(str, length);
+        return;
+    }
+
+    __set_arr_to_min_str_length__(str, length);
+    memcpy(__chars_string__(str), char_arr, length * sizeof(char));
+    str->str_length = length;
+    __chars_string__(str)[length] = '\0';
+}
+
+// Opens a gap of `length` chars at `index` (resizing once) and returns it for the caller to fill
+// Internal use only
+static inline char* __open_gap_string__(struct __String* const str, const size_t index, const size_t length)
+{
+    __set_arr_to_min_str_length__(str, str->str_length + length);
+
+    char* const chars = __chars_string__(str);
+    memmove(chars + index + length, chars + index, (str->str_length - index) * sizeof(char));
+    str->str_length += length;
+    chars[str->str_length] = '\0';
+    return chars + index;
 }
 
 //#######################################################################################
 
-static inline struct __String* newEmptyString(void)
+// alloc: where the String and its buffer live (e.g. &arena->allocator; must outlive the String); NULL uses malloc / free
+static inline struct __String* newEmptyStringWithAllocator(const allocator* const alloc)
 {
-    struct __String* new_str = (struct __String*) malloc(sizeof(struct __String));
-    new_str->arr_length = 1;
+    struct __String* new_str = (struct __String*) mem_alloc(alloc, sizeof(struct __String));
+    new_str->allocator = alloc;
+    new_str->arr_length = 0; // inline
     new_str->str_length = 0;
-    new_str->string = (char*) malloc(sizeof(char));
-    new_str->string[0] = '\0';
+    new_str->inline_string[0] = '\0';
     return new_str;
 }
 
-// CAREFUL!!! this MUST be treated as atomic
-static inline struct __String* newString(const char* const char_arr)
+static inline struct __String* newEmptyString(void)
 {
-    struct __String* new_str = (struct __String*) malloc(sizeof(struct __String));
-    new_str->arr_length = 1;
-    new_str->str_length = 0;
-    new_str->string = (char*) malloc(sizeof(char)); // needed for realloc
+    return newEmptyStringWithAllocator(NULL);
+}
 
-    const char* c = char_arr;
-    while (*c)
-    {
-        if (++new_str->str_length == new_str->arr_length) __increase_arr_length__(new_str);
-        new_str->string[new_str->str_length - 1] = *c;
-        c += sizeof(char);
-    }
-    new_str->string[new_str->str_length] = '\0';
+// Don't include null terminating character in length '\0'
+static inline struct __String* newStringNWithAllocator(const char* const char_arr, const size_t length, const allocator* const alloc)
+{
+    struct __String* new_str = newEmptyStringWithAllocator(alloc);
+    new_str->str_length = length;
+    __set_arr_to_min_str_length__(new_str, length); // one allocation at most
+
+    memcpy(__chars_string__(new_str), char_arr, length * sizeof(char));
+    __chars_string__(new_str)[new_str->str_length] = '\0';
 
     return new_str;
 }
 
 // Don't include null terminating character in length '\0'
-static inline struct __String* newStringN(const char* const char_arr, const int length)
+static inline struct __String* newStringN(const char* const char_arr, const size_t length)
 {
-    struct __String* new_str = (struct __String*) malloc(sizeof(struct __String));
-    new_str->arr_length = 1; // in case of malloc default value collision used for `set __set_arr_to_min_str_length__()`
-    new_str->str_length = length;
-    new_str->string = (char*) malloc(sizeof(char)); // needed for realloc
-    __set_arr_to_min_str_length__(new_str, length); // could expand this to optimise perf.
-
-    for (int i = 0; i < new_str->str_length; i++) new_str->string[i] = char_arr[i];
+    return newStringNWithAllocator(char_arr, length, NULL);
+}
 
-    new_str->string[new_str->str_length] = '\0';
+static inline struct __String* newStringWithAllocator(const char* const char_arr, const allocator* const alloc)
+{
+    return newStringNWithAllocator(char_arr, strlen(char_arr), alloc);
+}
 
-    return new_str;
+static inline struct __String* newString(const char* const char_arr)
+{
+    return newStringWithAllocator(char_arr, NULL);
 }
 
-static inline int lenString(const struct __String* const str)
+static inline size_t lenString(const struct __String* const str)
 {
     return str->str_length;
 }
 
-static inline char getCharIndexed(const struct __String* const str, const int index)
+static inline char getCharIndexed(const struct __String* const str, const size_t index)
 {
-    return index < str->str_length ? str->string[index] : -1;
+    return index < str->str_length ? __chars_string__(str)[index] : -1;
 }
 
 // DO NOT MODIFY EXTERNALLY; can cause bugs/security issues
 static inline char* getCharArr(const struct __String* const str)
 {
-    return str->string;
+    return __chars_string__(str);
 }
 
 static inline void clearString(struct __String* const str)
 {
     str->str_length = 0;
     __set_arr_to_min_str_length__(str, str->str_length);
-    str->string[0] = '\0';
+    __chars_string__(str)[0] = '\0';
 }
 
+// Releases the buffer; the String is left empty (and still usable)
 static inline void cleanString(struct __String* const str)
 {
-    free(str->string);
+    if (str->arr_length != 0) mem_free(str->allocator, str->string, str->arr_length * sizeof(char));
+    str->arr_length = 0;
+    str->str_length = 0;
+    str->inline_string[0] = '\0';
 }
 
 static inline void freeString(struct __String* const str)
 {
     cleanString(str);
-    free(str);
+    mem_free(str->allocator, str, sizeof(struct __String));
 }
 
-// Could technically be optimised
+// Could technically be optimised; the copy uses the same allocator
 static inline struct __String* copyString(const struct __String* const str)
 {
-    return newStringN(getCharArr(str), lenString(str));
+    return newStringNWithAllocator(getCharArr(str), lenString(str), str->allocator);
 }
 
-static inline void writeChars(struct __String* const str, const char* const char_arr)
+static inline void writeCharsN(struct __String* const str, const char* const char_arr, const size_t length)
 {
-    str->str_length = 0;
-
-    const char* c = char_arr;
-    while (*c)
-    {
-        if (++str->str_length == str->arr_length) __increase_arr_length__(str);
-        str->string[str->str_length - 1] = *c;
-        c += sizeof(char);
-    }
-
-    str->string[str->str_length] = '\0';
-    __set_arr_to_min_str_length__(str, str->str_length); // in case the new str is smaller
+    __write_chars_string__(str, char_arr, length);
 }
 
-static inline void writeCharsN(struct __String* const str, const char* const char_arr, const int length)
+static inline void writeChars(struct __String* const str, const char* const char_arr)
 {
-    __set_arr_to_min_str_length__(str, length);
-    str->str_length = length;
-
-    for (int i = 0; i < length; i++) str->string[i] = char_arr[i];
-
-    str->string[str->str_length] = '\0';
+    __write_chars_string__(str, char_arr, strlen(char_arr));
 }
 
 static inline void writeString(struct __String* const str1, const struct __String* const str2)
 {
-    __set_arr_to_min_str_length__(str1, str2->str_length);
-    str1->str_length = str2->str_length;
-
-    for (int i = 0; i < str2->str_length; i++) str1->string[i] = str2->string[i];
-
-    str1->string[str1->str_length] = '\0';
+    __write_chars_string__(str1, __chars_string__(str2), str2->str_length);
 }
 
-static inline void writeStringN(struct __String* const str1, const struct __String* const str2, const int length)
+static inline void writeStringN(struct __String* const str1, const struct __String* const str2, const size_t length)
 {
-    __set_arr_to_min_str_length__(str1, length);
-    str1->str_length = length;
-
-    for (int i = 0; i < length; i++) str1->string[i] = str2->string[i];
-
-    str1->string[str1->str_length] = '\0';
+    __write_chars_string__(str1, __chars_string__(str2), length);
 }
 
-static inline void writeStringNOffset(struct __String* const str1, const struct __String* const str2, const int length, const int offset)
+static inline void writeStringNOffset(struct __String* const str1, const struct __String* const str2, const size_t length, const size_t offset)
 {
-    __set_arr_to_min_str_length__(str1, length);
-    str1->str_length = length;
-
-    for (int i = 0; i < length; i++) str1->string[i] = str2->string[i+offset];
-
-    str1->string[str1->str_length] = '\0';
+    __write_chars_string__(str1, __chars_string__(str2) + offset, length);
 }
 
 static inline void appendChar(struct __String* const str, const char c)
 {
-    __set_arr_to_min_str_length__(str, ++str->str_length);
+    *__open_gap_string__(str, str->str_length, 1) = c;
+}
 
-    str->string[str->str_length - 1] = c;
-    str->string[str->str_length] = '\0';
+static inline void appendCharsN(struct __String* const str, const char* const char_arr, const size_t length)
+{
+    memcpy(__open_gap_string__(str, str->str_length, length), char_arr, length * sizeof(char));
 }
 
 static inline void appendChars(struct __String* const str, const char* const char_arr)
 {
-    const char* c = char_arr;
-    while (*c)
-    {
-        if (++str->str_length == str->arr_length) __increase_arr_length__(str);
-        str->string[str->str_length - 1] = *c;
-        c += sizeof(char);
-    }
-
-    str->string[str->str_length] = '\0';
+    appendCharsN(str, char_arr, strlen(char_arr));
 }
 
-static inline void appendCharsN(struct __String* const str, const char* const char_arr, const int length)
+static inline void appendStringN(struct __String* const str1, const struct __String* const str2, const size_t length)
 {
-    __set_arr_to_min_str_length__(str, str->str_length+length);
-
-    for (int i = 0; i < length; i++) str->string[str->str_length++] = char_arr[i];
-
-    str->string[str->str_length] = '\0';
+    char* const gap = __open_gap_string__(str1, str1->str_length, length);
+    memcpy(gap, __chars_string__(str2), length * sizeof(char)); // read after the resize, so str2 may be str1
 }
 
 static inline void appendString(struct __String* const str1, const struct __String* const str2)
 {
-    __set_arr_to_min_str_length__(str1, str1->str_length+str2->str_length);
-
-    for (int i = 0; i < str2->str_length; i++) str1->string[str1->str_length++] = str2->string[i];
-
-    str1->string[str1->str_length] = '\0';
+    appendStringN(str1, str2, str2->str_length);
 }
 
-static inline void appendStringN(struct __String* const str1, const struct __String* const str2, const int length)
+static inline void insertChar(struct __String* const str, const size_t index, const char c)
 {
-    __set_arr_to_min_str_length__(str1, str1->str_length+length);
-
-    for (int i = 0; i < length; i++) str1->string[str1->str_length++] = str2->string[i];
-
-    str1->string[str1->str_length] = '\0';
+    *__open_gap_string__(str, index, 1) = c;
 }
 
-static inline void insertChar(struct __String* const str, const int index, const char c)
+static inline void insertCharsN(struct __String* const str, const size_t index, const char* const char_arr, const size_t length)
 {
-    __set_arr_to_min_str_length__(str, ++str->str_length);
-
-    char buf = str->string[index];
-    str->string[index] = c;
-
-    const int max_i = str->str_length;
-    for (int i = (index+1); i < max_i; i++)
-    {
-        const char tmp = str->string[i];
-        str->string[i] = buf;
-        buf = tmp;
-    }
-
-    str->string[str->str_length] = '\0';
+    memcpy(__open_gap_string__(str, index, length), char_arr, length * sizeof(char));
 }
 
-static inline void insertChars(struct __String* const str, const int index, const char* const char_arr)
+static inline void insertChars(struct __String* const str, const size_t index, const char* const char_arr)
 {
-    int buf_length = 2;
-    int buf_str_length = 0;
-    char* buf = (char*) malloc(sizeof(char) * buf_length);
-
-    int i = 0;
-    const char* c = char_arr;
-    while (*c)
-    {
-        if (++str->str_length == str->arr_length) __increase_arr_length__(str); // may not be needed immediately but at least needed later
-        if (++buf_str_length == buf_length) 
-        {
-            buf_length *= 2;
-            buf = (char*) realloc(buf, buf_length * sizeof(char));
-        }
-        const int x = index + i;
-        buf[i] = str->string[x];
-        str->string[x] = *c;
-
-        c += sizeof(char);
-        i++;
-    }
-
-    const int length = i; // AT THIS POINT
-    const int max_i = str->str_length - index; // str->str_length is updated as the insert occurs above
-    for (; i < max_i; i++)
-    {
-        const int x = i + index;
-        const int y = i % length;
-
-        const char tmp = str->string[x];
-        str->string[x] = buf[y];
-        buf[y] = tmp;
-    }
-
-    str->string[str->str_length] = '\0';
-    free(buf);
+    insertCharsN(str, index, char_arr, strlen(char_arr));
 }
 
-static inline void insertCharsN(struct __String* const str, const int index, const char* const char_arr, const int length)
-{
-    __set_arr_to_min_str_length__(str, str->str_length+length);
-    char* buf = (char*) malloc(sizeof(char) * length);
-
-    int i = 0;
-    for (; i < length; i++)
-    {
-        const int x = i + index;
-        buf[i] = str->string[x];
-        str->string[x] = char_arr[i];
-    }
-
-    str->str_length += length;
-    const int max_i = str->str_length - index;
-    for (; i < max_i; i++)
-    {
-        const int x = i + index;
-        const int y = i % length;
-
-        const char tmp = str->string[x];
-        str->string[x] = buf[y];
-        buf[y] = tmp;
-    }
-
-    str->string[str->str_length] = '\0';
-    free(buf);
-}
-
-static inline void insertString(struct __String* const str1, const int index, const struct __String* const str2)
+// Inserts `length` chars from `str2` into `str1` at position `index` inclusive
+static inline void insertStringN(struct __String* const str1, const size_t index, const struct __String* const str2, const size_t length)
 {
-    const int length = str2->str_length; // simplifies codes for coder (maybe performance neg.ve?)
-    __set_arr_to_min_str_length__(str1, str1->str_length+length);
-    char* buf = (char*) malloc(sizeof(char) * length);
-
-    int i = 0;
-    for (; i < length; i++)
-    {
-        const int x = i + index;
-        buf[i] = str1->string[x];
-        str1->string[x] = str2->string[i];
-    }
-
-    str1->str_length += length;
-    const int max_i = str1->str_length - index;
-    for (; i < max_i; i++)
-    {
-        const int x = i + index;
-        const int y = i % length;
-
-        const char tmp = str1->string[x];
-        str1->string[x] = buf[y];
-        buf[y] = tmp;
-    }
-
-    str1->string[str1->str_length] = '\0';
-    free(buf);
+    memcpy(__open_gap_string__(str1, index, length), __chars_string__(str2), length * sizeof(char));
 }
 
-// Inserts `length` chars from `str2` into `str1` at position `index` inclusive
-static inline void insertStringN(struct __String* const str1, const int index, const struct __String* const str2, const int length)
+static inline void insertString(struct __String* const str1, const size_t index, const struct __String* const str2)
 {
-    __set_arr_to_min_str_length__(str1, str1->str_length+length);
-    char* buf = (char*) malloc(sizeof(char) * length);
-
-    int i = 0;
-    for (; i < length; i++)
-    {
-        const int x = i + index;
-        buf[i] = str1->string[x];
-        str1->string[x] = str2->string[i];
-    }
-
-    str1->str_length += length;
-    const int max_i = str1->str_length - index;
-    for (; i < max_i; i++)
-    {
-        const int x = i + index;
-        const int y = i % length;
-
-        const char tmp = str1->string[x];
-        str1->string[x] = buf[y];
-        buf[y] = tmp;
-    }
-
-    str1->string[str1->str_length] = '\0';
-    free(buf);
+    insertStringN(str1, index, str2, str2->str_length);
 }
 
 static inline void deleteString(struct __String* str)
 {
-    free(str->string);
-    str->string = NULL; // Technically not needed but whatev ig?
-    free(str);
+    cleanString(str);
+    mem_free(str->allocator, str, sizeof(struct __String));
 }
 
 // returns 0 when the strings are equal
 static inline int compareChars(const struct __String* const str, const char* const char_arr)
 {
     const char* c = char_arr;
-    int i = 0;
+    size_t i = 0;
     while (*c && i < str->str_length)
     {
-        if (*c != str->string[i]) return ((int)(str->string[i]) - (int)(*c));
+        if (*c != __chars_string__(str)[i]) return ((int)(__chars_string__(str)[i]) - (int)(*c));
         c += sizeof(char);
         i++;
     }
@@ -437,27 +336,27 @@ static inline int compareChars(const struct __String* const str, const char* con
 }
 
 // returns 0 when the strings are equal
-static inline int compareCharsN(const struct __String* const str, const char* const char_arr, const int length)
+static inline int compareCharsN(const struct __String* const str, const char* const char_arr, const size_t length)
 {
-    const int max_len = min(length, str->str_length);
+    const size_t max_len = min(length, str->str_length);
     
-    for (int i = 0; i < max_len; i++)
-        if (char_arr[i] != str->string[i]) 
-            return ((int)(str->string[i]) - (int)(char_arr[i]));
+    for (size_t i = 0; i < max_len; i++)
+        if (char_arr[i] != __chars_string__(str)[i]) 
+            return ((int)(__chars_string__(str)[i]) - (int)(char_arr[i]));
     
-    return str->str_length - length;
+    return (str->str_length > length) - (str->str_length < length); // lengths are unsigned, so no subtraction
 }
 
 // returns 0 when the strings are equal
 static inline int compareString(const struct __String* const str1, const struct __String* const str2)
 {
-    const int max_len = min(str1->str_length, str2->str_length);
+    const size_t max_len = min(str1->str_length, str2->str_length);
 
-    for (int i = 0; i < max_len; i++)
-        if (str1->string[i] != str2->string[i]) 
-            return ((int)(str1->string[i]) - (int)(str2->string[i]));
+    for (size_t i = 0; i < max_len; i++)
+        if (__chars_string__(str1)[i] != __chars_string__(str2)[i]) 
+            return ((int)(__chars_string__(str1)[i]) - (int)(__chars_string__(str2)[i]));
     
-    return str1->str_length - str2->str_length;
+    return (str1->str_length > str2->str_length) - (str1->str_length < str2->str_length); // lengths are unsigned, so no subtraction
 }
 
 // TODO make an optimised digit only func
@@ -490,24 +389,24 @@ static inline void __append_int_base_func__(struct __String* const str, const in
     {
         const int dig = rem / pow;
         rem %= pow;
-        str->string[str->str_length++] = (char) (dig >= 10 
+        __chars_string__(str)[str->str_length++] = (char) (dig >= 10 
             ? (UNICODE_DIGIT_BASE + dig) 
             : ((UNICODE_UPPER_ALPHA_BASE - 10) + dig));
     }
 
-    str->string[str->str_length] = '\0';
+    __chars_string__(str)[str->str_length] = '\0';
 }
 
 // Presumes >= 0; TODO make an optimised digit only func
 // Internal use only
-static inline int __convert_string_to_int_base_func__(const struct __String* const str, const int str_offset, const int base)
+static inline int __convert_string_to_int_base_func__(const struct __String* const str, const size_t str_offset, const int base)
 {
     int result = 0;
 
-    int i = str_offset;
+    size_t i = str_offset;
     while (i < str->str_length)
     {
-        const int c_val = (int)str->string[i];
+        const int c_val = (int)__chars_string__(str)[i];
         if (c_val < UNICODE_DIGIT_BASE 
             || (c_val > (UNICODE_DIGIT_BASE + 9) 
                 && (c_val < UNICODE_UPPER_ALPHA_BASE))
@@ -546,25 +445,25 @@ static inline void appendIntB32(struct __String* const str, const int number)
 }
 
 // Presumes >= 0
-static inline int convertStringToIntOct(const struct __String* const str, const int str_offset)
+static inline int convertStringToIntOct(const struct __String* const str, const size_t str_offset)
 {
     return __convert_string_to_int_base_func__(str, str_offset, 8);
 }
 
 // Presumes >= 0
-static inline int convertStringToIntDec(const struct __String* const str, const int str_offset)
+static inline int convertStringToIntDec(const struct __String* const str, const size_t str_offset)
 {
     return __convert_string_to_int_base_func__(str, str_offset, 10);
 }
 
 // Presumes >= 0
-static inline int convertStringToIntHex(const struct __String* const str, const int str_offset)
+static inline int convertStringToIntHex(const struct __String* const str, const size_t str_offset)
 {
     return __convert_string_to_int_base_func__(str, str_offset, 16);
 }
 
 // Presumes >= 0
-static inline int convertStringToIntB32(const struct __String* const str, const int str_offset)
+static inline int convertStringToIntB32(const struct __String* const str, const size_t str_offset)
 {
     return __convert_string_to_int_base_func__(str, str_offset, 32);
 }
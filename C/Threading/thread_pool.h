@@ -0,0 +1,227 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "threading.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/*
+	Persistent worker threads for repeated parallel jobs, so each job costs a wake-up instead of thread creation.
+	A job is the same shape as run_threads(): one function over an array of argument structs. Workers (and the calling
+	thread) claim arguments one at a time, so a job may have many more arguments than threads and still balance.
+	Only one job runs at a time per pool; run_thread_pool() must not be called concurrently or from inside a job.
+*/
+
+typedef struct thread_pool
+{
+	unsigned int thread_count; // workers, excluding the calling thread
+	thread_task tasks[THREADING_MAX_THREADS];
+#ifdef _WIN64
+	SRWLOCK lock;
+	CONDITION_VARIABLE wake;
+	CONDITION_VARIABLE done;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+#endif
+	uint64_t generation; // bumped for every job (and for shutdown); guarded by lock
+	uint8_t stopping;
+	unsigned int active; // workers still inside the current job; guarded by lock
+
+	// Current job
+	thread_func func;
+	char* args;
+	size_t arg_size;
+	size_t arg_count;
+	atomic_size_t next_arg;
+} thread_pool;
+
+// Internal use only
+static inline void __lock_thread_pool__(thread_pool* const pool)
+{
+#ifdef _WIN64
+	AcquireSRWLockExclusive(&pool->lock);
+#else
+	pthread_mutex_lock(&pool->lock);
+#endif
+}
+
+// Internal use only
+static inline void __unlock_thread_pool__(thread_pool* const pool)
+{
+#ifdef _WIN64
+	ReleaseSRWLockExclusive(&pool->lock);
+#else
+	pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
+// Internal use only
+static inline void __wait_thread_pool__(thread_pool* const pool, const uint8_t for_done)
+{
+#ifdef _WIN64
+	SleepConditionVariableSRW(for_done ? &pool->done : &pool->wake, &pool->lock, INFINITE, 0);
+#else
+	pthread_cond_wait(for_done ? &pool->done : &pool->wake, &pool->lock);
+#endif
+}
+
+// Internal use only
+static inline void __broadcast_thread_pool__(thread_pool* const pool, const uint8_t for_done)
+{
+#ifdef _WIN64
+	WakeAllConditionVariable(for_done ? &pool->done : &pool->wake);
+#else
+	pthread_cond_broadcast(for_done ? &pool->done : &pool->wake);
+#endif
+}
+
+// Internal use only; claims and runs arguments of the current job until none are left
+static inline void __drain_thread_pool__(thread_pool* const pool)
+{
+	for (;;)
+	{
+		const size_t index = atomic_fetch_add_explicit(&pool->next_arg, 1, memory_order_relaxed);
+		if (index >= pool->arg_count) return;
+		pool->func(pool->args + index * pool->arg_size);
+	}
+}
+
+// Internal use only
+static inline void __worker_thread_pool__(void* const arg)
+{
+	thread_pool* const pool = (thread_pool*)arg;
+	uint64_t seen = 0;
+
+	__lock_thread_pool__(pool);
+	for (;;)
+	{
+		while (pool->generation == seen) __wait_thread_pool__(pool, 0);
+		seen = pool->generation;
+		if (pool->stopping) break;
+
+		__unlock_thread_pool__(pool);
+		__drain_thread_pool__(pool);
+		__lock_thread_pool__(pool);
+
+		if (--pool->active == 0) __broadcast_thread_pool__(pool, 1);
+	}
+	__unlock_thread_pool__(pool);
+}
+
+/**
+ * @brief Starts the worker threads of @p pool.
+ * @param thread_count Total threads working on each job, including the calling thread; 0 uses get_hardware_thread_count().
+ * @return 0 on success; 1 if a worker could not be started (the pool then runs with the workers that did start).
+ */
+static inline int set_thread_pool(thread_pool* const pool, unsigned int thread_count)
+{
+	if (thread_count == 0) thread_count = get_hardware_thread_count();
+	if (thread_count > THREADING_MAX_THREADS) thread_count = THREADING_MAX_THREADS;
+
+#ifdef _WIN64
+	InitializeSRWLock(&pool->lock);
+	InitializeConditionVariable(&pool->wake);
+	InitializeConditionVariable(&pool->done);
+#else
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+	pthread_cond_init(&pool->done, NULL);
+#endif
+	pool->generation = 0;
+	pool->stopping = 0;
+	pool->active = 0;
+	pool->func = NULL;
+	pool->args = NULL;
+	pool->arg_size = 0;
+	pool->arg_count = 0;
+	atomic_init(&pool->next_arg, 0);
+
+	pool->thread_count = 0;
+	for (unsigned int i = 0; i + 1 < thread_count; i++)
+	{
+		if (start_thread(&pool->tasks[pool->thread_count], __worker_thread_pool__, pool) != 0) return 1;
+		pool->thread_count++;
+	}
+	return 0;
+}
+
+static inline thread_pool* new_thread_pool(const unsigned int thread_count)
+{
+	thread_pool* const pool = (thread_pool*)calloc(1, sizeof(thread_pool));
+	if (pool == NULL) return NULL;
+	set_thread_pool(pool, thread_count);
+	return pool;
+}
+
+/**
+ * @brief Total threads working on each job, including the calling thread.
+ */
+static inline unsigned int get_thread_count_thread_pool(const thread_pool* const pool)
+{
+	return pool->thread_count + 1;
+}
+
+/**
+ * @brief Runs @p func once per argument in @p args on the pool's workers and the calling thread, and waits for all of them.
+ * @param args Pointer to the first of @p arg_count argument structs.
+ * @param arg_size Byte size of each argument struct (the stride between arguments).
+ */
+static inline void run_thread_pool(thread_pool* const pool, const thread_func func, void* const args, const size_t arg_size, const size_t arg_count)
+{
+	if (arg_count == 0) return;
+	if (arg_count == 1 || pool->thread_count == 0)
+	{
+		for (size_t i = 0; i < arg_count; i++) func((char*)args + i * arg_size);
+		return;
+	}
+
+	__lock_thread_pool__(pool);
+	pool->func = func;
+	pool->args = (char*)args;
+	pool->arg_size = arg_size;
+	pool->arg_count = arg_count;
+	atomic_store_explicit(&pool->next_arg, 0, memory_order_relaxed);
+	pool->active = pool->thread_count;
+	pool->generation++;
+	__broadcast_thread_pool__(pool, 0);
+	__unlock_thread_pool__(pool);
+
+	__drain_thread_pool__(pool);
+
+	__lock_thread_pool__(pool);
+	while (pool->active != 0) __wait_thread_pool__(pool, 1);
+	__unlock_thread_pool__(pool);
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ */
+static inline void clean_thread_pool(thread_pool* const pool)
+{
+	__lock_thread_pool__(pool);
+	pool->stopping = 1;
+	pool->generation++;
+	__broadcast_thread_pool__(pool, 0);
+	__unlock_thread_pool__(pool);
+
+	for (unsigned int i = 0; i < pool->thread_count; i++) join_thread(&pool->tasks[i]);
+	pool->thread_count = 0;
+
+#ifndef _WIN64
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->wake);
+	pthread_cond_destroy(&pool->done);
+#endif
+}
+
+static inline void free_thread_pool(thread_pool* const pool)
+{
+	clean_thread_pool(pool);
+	free(pool);
+}
+
+#endif
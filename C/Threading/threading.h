@@ -0,0 +1,262 @@
+#ifndef THREADING_H
+#define THREADING_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifdef _WIN64  // windows platform
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h>
+#endif
+
+#define THREADING_MAX_THREADS 256
+
+typedef void(*thread_func)(void*);
+
+typedef struct thread_task
+{
+	thread_func func;
+	void* arg;
+#ifdef _WIN64
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+} thread_task;
+
+// Internal use only
+#ifdef _WIN64
+static DWORD WINAPI __thread_task_trampoline__(LPVOID task_ptr)
+{
+	thread_task* const task = (thread_task*)task_ptr;
+	task->func(task->arg);
+	return 0;
+}
+#else
+static inline void* __thread_task_trampoline__(void* task_ptr)
+{
+	thread_task* const task = (thread_task*)task_ptr;
+	task->func(task->arg);
+	return NULL;
+}
+#endif
+
+/**
+ * @brief Starts running @p func with @p arg on a new thread.
+ * @param task Caller owned task; must stay alive until join_thread() is called on it.
+ * @param func The function to run.
+ * @param arg The argument passed to @p func.
+ * @return 0 on success; 1 if the thread could not be created.
+ */
+static inline int start_thread(thread_task* const task, const thread_func func, void* const arg)
+{
+	task->func = func;
+	task->arg = arg;
+#ifdef _WIN64
+	task->handle = CreateThread(NULL, 0, __thread_task_trampoline__, task, 0, NULL);
+	return (task->handle == NULL) ? 1 : 0;
+#else
+	return (pthread_create(&task->handle, NULL, __thread_task_trampoline__, task) == 0) ? 0 : 1;
+#endif
+}
+
+/**
+ * @brief Blocks until the thread of @p task has finished.
+ * @return 0 on success; 1 on system error.
+ */
+static inline int join_thread(thread_task* const task)
+{
+#ifdef _WIN64
+	if (WaitForSingleObject(task->handle, INFINITE) != WAIT_OBJECT_0) return 1;
+	CloseHandle(task->handle);
+	return 0;
+#else
+	return (pthread_join(task->handle, NULL) == 0) ? 0 : 1;
+#endif
+}
+
+/**
+ * @brief Returns the number of hardware threads available to the process (at least 1).
+ */
+static inline unsigned int get_hardware_thread_count(void)
+{
+#ifdef _WIN64
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	const long count = (long)info.dwNumberOfProcessors;
+#else
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (count < 1) return 1;
+	if (count > THREADING_MAX_THREADS) return THREADING_MAX_THREADS;
+	return (unsigned int)count;
+}
+
+/**
+ * @brief Runs @p func once per argument in @p args across @p thread_count threads and waits for all of them.
+ * The calling thread runs the first argument itself, so only (thread_count - 1) threads are created.
+ * @param thread_count Number of arguments (and threads) to run; 0 uses get_hardware_thread_count().
+ * @param func The function to run.
+ * @param args Pointer to the first of @p thread_count argument structs.
+ * @param arg_size Byte size of each argument struct (the stride between arguments).
+ * @warning If a thread fails to start, its argument is run on the calling thread instead.
+ */
+static inline void run_threads(unsigned int thread_count, const thread_func func, void* const args, const size_t arg_size)
+{
+	if (thread_count == 0) thread_count = get_hardware_thread_count();
+	if (thread_count > THREADING_MAX_THREADS) thread_count = THREADING_MAX_THREADS;
+
+	thread_task tasks[THREADING_MAX_THREADS];
+	uint8_t started[THREADING_MAX_THREADS] = {0};
+
+	for (unsigned int i = 1; i < thread_count; i++)
+	{
+		started[i] = (start_thread(&tasks[i], func, (char*)args + i * arg_size) == 0);
+	}
+
+	func(args);
+
+	for (unsigned int i = 1; i < thread_count; i++)
+	{
+		if (started[i]) join_thread(&tasks[i]);
+		else func((char*)args + i * arg_size);
+	}
+}
+
+typedef uint32_t(*shard_route_func)(void* context, uint64_t index); // returns the shard of item `index`
+typedef void(*shard_build_func)(void* context, uint32_t shard, const uint64_t* items, uint64_t item_count); // items: indices into the input, in input order
+
+// Internal use only
+struct __sharded_partition_args__
+{
+	void* context;
+	shard_route_func route;
+	shard_build_func build;
+	uint64_t start;
+	uint64_t end;
+	uint32_t shard_count;
+	uint32_t* shard_indices; // per item
+	uint64_t* shard_offsets; // [shard_count] counts, then write cursors into `order`
+	uint64_t* shard_starts;  // [shard_count + 1] start of every shard's run in `order` (shared between all threads)
+	uint64_t* order;         // item indices grouped by shard
+	uint32_t first_shard;
+	uint32_t shard_stride;
+};
+
+// Internal use only
+static inline void __route_sharded_partition__(void* const args_ptr)
+{
+	struct __sharded_partition_args__* const args = (struct __sharded_partition_args__*)args_ptr;
+
+	for (uint64_t i = args->start; i < args->end; i++)
+	{
+		const uint32_t shard = args->route(args->context, i);
+		args->shard_indices[i] = shard;
+		args->shard_offsets[shard]++;
+	}
+}
+
+// Internal use only
+static inline void __scatter_sharded_partition__(void* const args_ptr)
+{
+	struct __sharded_partition_args__* const args = (struct __sharded_partition_args__*)args_ptr;
+
+	for (uint64_t i = args->start; i < args->end; i++)
+	{
+		args->order[args->shard_offsets[args->shard_indices[i]]++] = i;
+	}
+}
+
+// Internal use only
+static inline void __build_sharded_partition__(void* const args_ptr)
+{
+	struct __sharded_partition_args__* const args = (struct __sharded_partition_args__*)args_ptr;
+
+	for (uint32_t shard = args->first_shard; shard < args->shard_count; shard += args->shard_stride)
+	{
+		const uint64_t run_start = args->shard_starts[shard];
+		const uint64_t run_end = args->shard_starts[shard + 1];
+		if (run_end > run_start) args->build(args->context, shard, args->order + run_start, run_end - run_start);
+	}
+}
+
+/**
+ * @brief Groups @p count items by shard across threads, then builds every shard in parallel without locking.
+ * Pass 1 routes each item and counts items per (thread chunk, shard); an exclusive prefix sum in shard-major order then
+ * gives every shard one run of item indices, which pass 2 fills (keeping input order within each shard). Finally each
+ * thread calls @p build for its own disjoint set of shards, so shards need no locks.
+ * @param thread_count Number of threads to use (at least 1); callers cap it to suit their work.
+ * @param count Number of items.
+ * @param shard_count Number of shards; @p route must return values below it.
+ * @param route Called once per item, from any thread; it may also record per-item data in @p context.
+ * @param build Called at most once per non-empty shard, from the thread that owns the shard.
+ * @param context Passed to @p route and @p build.
+ * @return 0 on success; 1 on allocation failure (nothing is built).
+ */
+static inline uint8_t run_sharded_partition(unsigned int thread_count, const uint64_t count, const uint32_t shard_count, const shard_route_func route, const shard_build_func build, void* const context)
+{
+	if (count == 0) return 0;
+	if (thread_count < 1) thread_count = 1;
+	if (thread_count > THREADING_MAX_THREADS) thread_count = THREADING_MAX_THREADS;
+
+	uint32_t* const shard_indices = (uint32_t*)malloc(count * sizeof(uint32_t));
+	uint64_t* const order = (uint64_t*)malloc(count * sizeof(uint64_t));
+	uint64_t* const shard_offsets = (uint64_t*)calloc((uint64_t)(thread_count + 1) * shard_count + 1, sizeof(uint64_t));
+	struct __sharded_partition_args__* const args = (struct __sharded_partition_args__*)calloc(thread_count, sizeof(struct __sharded_partition_args__));
+	if (shard_indices == NULL || order == NULL || shard_offsets == NULL || args == NULL)
+	{
+		free(shard_indices); free(order); free(shard_offsets); free(args);
+		return 1;
+	}
+
+	uint64_t* const shard_starts = shard_offsets + (uint64_t)thread_count * shard_count;
+	const uint64_t chunk = (count + thread_count - 1) / thread_count;
+	for (unsigned int t = 0; t < thread_count; t++)
+	{
+		args[t].context = context;
+		args[t].route = route;
+		args[t].build = build;
+		args[t].start = ((uint64_t)t * chunk < count) ? (uint64_t)t * chunk : count;
+		args[t].end = (args[t].start + chunk < count) ? args[t].start + chunk : count;
+		args[t].shard_count = shard_count;
+		args[t].shard_indices = shard_indices;
+		args[t].shard_offsets = shard_offsets + (uint64_t)t * shard_count;
+		args[t].shard_starts = shard_starts;
+		args[t].order = order;
+		args[t].first_shard = t;
+		args[t].shard_stride = thread_count;
+	}
+
+	// Pass 1: route every item and count items per (thread chunk, shard)
+	run_threads(thread_count, __route_sharded_partition__, args, sizeof(*args));
+
+	// Exclusive prefix sum in shard-major order, so each shard's items form one run in `order`
+	uint64_t running = 0;
+	for (uint32_t shard = 0; shard < shard_count; shard++)
+	{
+		shard_starts[shard] = running;
+		for (unsigned int t = 0; t < thread_count; t++)
+		{
+			const uint64_t shard_count_in_chunk = args[t].shard_offsets[shard];
+			args[t].shard_offsets[shard] = running;
+			running += shard_count_in_chunk;
+		}
+	}
+	shard_starts[shard_count] = running;
+
+	// Pass 2: scatter item indices into their shard runs
+	run_threads(thread_count, __scatter_sharded_partition__, args, sizeof(*args));
+
+	// Pass 3: every thread builds a disjoint set of shards
+	run_threads(thread_count, __build_sharded_partition__, args, sizeof(*args));
+
+	free(shard_indices);
+	free(order);
+	free(shard_offsets);
+	free(args);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,418 @@
+#ifndef VECTOR_SOA_H
+#define VECTOR_SOA_H
+
+#include "vector_standards.h"
+#include "../Dynamic Array/dyn_array.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// On x86 with GCC or Clang the AVX kernels are compiled for AVX regardless of the compiler flags and picked at runtime
+// from the CPU's features; otherwise AVX is used only when the compiler targets it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define VECTOR_SOA_AVX
+	#if defined(__AVX__)
+		#define __VECTOR_SOA_AVX_TARGET__
+	#else
+		#define VECTOR_SOA_RUNTIME_DISPATCH
+		#define __VECTOR_SOA_AVX_TARGET__ __attribute__((target("avx")))
+	#endif
+#elif defined(__AVX__)
+	#include <immintrin.h>
+	#define VECTOR_SOA_AVX
+	#define __VECTOR_SOA_AVX_TARGET__
+#endif
+
+#if defined(VECTOR_SOA_AVX)
+	_Static_assert(sizeof(VECTOR_FLT) == sizeof(float), "vector_soa AVX kernels assume VECTOR_FLT is float");
+#endif
+
+#define VECTOR_SOA_MAX_COMPONENTS 4
+
+/*
+	Structure-of-arrays collection of vector2/vector3/vector4.
+	Each component (x, y, z, w) is its own contiguous, 32-byte aligned stream, so the bulk kernels below
+	load 8 consecutive x (then y, z, w) values per AVX instruction instead of shuffling interleaved structs.
+	Interleaved inputs and outputs (VECTOR_FLT* values) are laid out as vector2/3/4 are: `components` floats per vector.
+*/
+
+typedef struct vector_soa
+{
+	uint8_t components; // 2, 3 or 4
+	size_t current_size; // vectors
+	dyn_array streams[VECTOR_SOA_MAX_COMPONENTS]; // only the first `components` are used
+} vector_soa;
+
+#define vector_soa_stream(VECTOR_SOA_PTR, COMPONENT) ((VECTOR_FLT*)(VECTOR_SOA_PTR)->streams[COMPONENT].data)
+
+/*
+	components must be 2, 3 or 4
+*/
+static inline void set_vector_soa(vector_soa* const soa, const uint8_t components)
+{
+	soa->components = components;
+	soa->current_size = 0;
+	for (uint8_t c = 0; c < VECTOR_SOA_MAX_COMPONENTS; c++)
+	{
+		set_dyn_array(&soa->streams[c], DYN_ARRAY_NO_TYPE, DYN_ARRAY_EXPANSION_DOUBLE);
+		override_item_size_dyn_array(&soa->streams[c], sizeof(VECTOR_FLT));
+		set_alignment_dyn_array(&soa->streams[c], DYN_ARRAY_ALIGN_SIMD);
+	}
+}
+
+static inline vector_soa* new_vector_soa(const uint8_t components)
+{
+	vector_soa* const soa = (vector_soa*)calloc(1, sizeof(vector_soa));
+	set_vector_soa(soa, components);
+	return soa;
+}
+
+/*
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int reserve_vector_soa(vector_soa* const soa, const size_t capacity)
+{
+	for (uint8_t c = 0; c < soa->components; c++)
+	{
+		if (reserve_dyn_array(&soa->streams[c], capacity) != 0) return 1;
+	}
+	return 0;
+}
+
+// Internal use only
+static inline int __grow_to_vector_soa__(vector_soa* const soa, const size_t min_size)
+{
+	if (min_size <= soa->streams[0].max_size) return 0;
+	return reserve_vector_soa(soa, __next_capacity_dyn_array__(DYN_ARRAY_EXPANSION_DOUBLE, soa->streams[0].max_size, sizeof(VECTOR_FLT), min_size));
+}
+
+// Internal use only
+static inline void __set_size_vector_soa__(vector_soa* const soa, const size_t size)
+{
+	soa->current_size = size;
+	for (uint8_t c = 0; c < soa->components; c++) soa->streams[c].current_size = size;
+}
+
+/*
+	Appends count interleaved vectors (e.g. a vector3 array viewed as VECTOR_FLT*).
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int append_range_vector_soa(vector_soa* const soa, const VECTOR_FLT* const values, const size_t count)
+{
+	if (__grow_to_vector_soa__(soa, soa->current_size + count) != 0) return 1;
+
+	const uint8_t components = soa->components;
+	for (uint8_t c = 0; c < components; c++)
+	{
+		VECTOR_FLT* const stream = vector_soa_stream(soa, c) + soa->current_size;
+		for (size_t i = 0; i < count; i++) stream[i] = values[i * components + c];
+	}
+	__set_size_vector_soa__(soa, soa->current_size + count);
+	return 0;
+}
+
+/*
+	values holds `components` floats, e.g. vector3.arr.
+	Returns 0 on success, else 1 (allocation error)
+*/
+static inline int append_vector_soa(vector_soa* const soa, const VECTOR_FLT* const values)
+{
+	return append_range_vector_soa(soa, values, 1);
+}
+
+/*
+	Writes the vector at index into out (`components` floats)
+*/
+static inline void get_vector_soa(const vector_soa* const soa, const size_t index, VECTOR_FLT* const out)
+{
+	for (uint8_t c = 0; c < soa->components; c++) out[c] = vector_soa_stream(soa, c)[index];
+}
+
+/*
+	Copies the vectors at indices[0..count) into out, interleaved.
+	Returns 0 on success, else 1 (an index is out of range; out is left untouched)
+*/
+static inline int gather_vector_soa(const vector_soa* const soa, const size_t* const indices, const size_t count, VECTOR_FLT* const out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (indices[i] >= soa->current_size) return 1;
+	}
+
+	const uint8_t components = soa->components;
+	for (uint8_t c = 0; c < components; c++)
+	{
+		const VECTOR_FLT* const stream = vector_soa_stream(soa, c);
+		for (size_t i = 0; i < count; i++) out[i * components + c] = stream[indices[i]];
+	}
+	return 0;
+}
+
+/*
+	Overwrites the vectors at indices[0..count) with the interleaved values (later duplicates win).
+	Returns 0 on success, else 1 (an index is out of range; nothing is written)
+*/
+static inline int scatter_vector_soa(vector_soa* const soa, const size_t* const indices, const size_t count, const VECTOR_FLT* const values)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (indices[i] >= soa->current_size) return 1;
+	}
+
+	const uint8_t components = soa->components;
+	for (uint8_t c = 0; c < components; c++)
+	{
+		VECTOR_FLT* const stream = vector_soa_stream(soa, c);
+		for (size_t i = 0; i < count; i++) stream[indices[i]] = values[i * components + c];
+	}
+	return 0;
+}
+
+// Internal use only
+static inline uint8_t __has_avx_vector_soa__(void)
+{
+#if defined(VECTOR_SOA_RUNTIME_DISPATCH)
+	return __builtin_cpu_supports("avx") ? 1 : 0;
+#elif defined(VECTOR_SOA_AVX)
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+#if defined(VECTOR_SOA_AVX)
+
+/*
+	----- AVX kernels: each handles whole blocks of 8 vectors and returns the index the scalar tail resumes from -----
+*/
+
+// Internal use only; b[i] += a[i]
+__VECTOR_SOA_AVX_TARGET__ static inline size_t __add_avx_vector_soa__(const VECTOR_FLT* const a, VECTOR_FLT* const b, const size_t n)
+{
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		_mm256_store_ps(b + i, _mm256_add_ps(_mm256_load_ps(a + i), _mm256_load_ps(b + i)));
+	}
+	return i;
+}
+
+// Internal use only; stream[i] *= delta
+__VECTOR_SOA_AVX_TARGET__ static inline size_t __scale_avx_vector_soa__(VECTOR_FLT* const stream, const size_t n, const VECTOR_FLT delta)
+{
+	const __m256 factor = _mm256_set1_ps(delta);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		_mm256_store_ps(stream + i, _mm256_mul_ps(_mm256_load_ps(stream + i), factor));
+	}
+	return i;
+}
+
+// Internal use only
+__VECTOR_SOA_AVX_TARGET__ static inline size_t __dot_avx_vector_soa__(const vector_soa* const first, const vector_soa* const second, VECTOR_FLT* const out)
+{
+	const size_t n = first->current_size;
+	const uint8_t components = first->components;
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256 sum = _mm256_mul_ps(_mm256_load_ps(vector_soa_stream(first, 0) + i), _mm256_load_ps(vector_soa_stream(second, 0) + i));
+		for (uint8_t c = 1; c < components; c++)
+		{
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_load_ps(vector_soa_stream(first, c) + i), _mm256_load_ps(vector_soa_stream(second, c) + i)));
+		}
+		_mm256_storeu_ps(out + i, sum);
+	}
+	return i;
+}
+
+// Internal use only
+__VECTOR_SOA_AVX_TARGET__ static inline size_t __normalize_avx_vector_soa__(vector_soa* const soa)
+{
+	const size_t n = soa->current_size;
+	const uint8_t components = soa->components;
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256 mag = zero;
+		for (uint8_t c = 0; c < components; c++)
+		{
+			const __m256 v = _mm256_load_ps(vector_soa_stream(soa, c) + i);
+			mag = _mm256_add_ps(mag, _mm256_mul_ps(v, v));
+		}
+		mag = _mm256_sqrt_ps(mag);
+		// 1 / mag, or 1 where mag is zero so those vectors pass through unchanged
+		const __m256 is_zero = _mm256_cmp_ps(mag, zero, _CMP_EQ_OQ);
+		const __m256 inv = _mm256_blendv_ps(_mm256_div_ps(one, mag), one, is_zero);
+		for (uint8_t c = 0; c < components; c++)
+		{
+			VECTOR_FLT* const stream = vector_soa_stream(soa, c) + i;
+			_mm256_store_ps(stream, _mm256_mul_ps(_mm256_load_ps(stream), inv));
+		}
+	}
+	return i;
+}
+
+#endif
+
+/*
+	Result stored in second; both must hold the same number of vectors with the same components.
+	Returns 0 on success, else 1 (shape mismatch)
+*/
+static inline int add_vector_soa(const vector_soa* const first, vector_soa* const second)
+{
+	if (first->components != second->components || first->current_size != second->current_size) return 1;
+
+	const size_t n = second->current_size;
+	for (uint8_t c = 0; c < second->components; c++)
+	{
+		const VECTOR_FLT* const a = vector_soa_stream(first, c);
+		VECTOR_FLT* const b = vector_soa_stream(second, c);
+		size_t i = 0;
+#if defined(VECTOR_SOA_AVX)
+		if (__has_avx_vector_soa__()) i = __add_avx_vector_soa__(a, b, n);
+#endif
+		for (; i < n; i++) b[i] += a[i];
+	}
+	return 0;
+}
+
+/*
+	Multiplies every component of every vector by delta
+*/
+static inline void scale_vector_soa(vector_soa* const soa, const VECTOR_FLT delta)
+{
+	const size_t n = soa->current_size;
+	for (uint8_t c = 0; c < soa->components; c++)
+	{
+		VECTOR_FLT* const stream = vector_soa_stream(soa, c);
+		size_t i = 0;
+#if defined(VECTOR_SOA_AVX)
+		if (__has_avx_vector_soa__()) i = __scale_avx_vector_soa__(stream, n, delta);
+#endif
+		for (; i < n; i++) stream[i] *= delta;
+	}
+}
+
+/*
+	out[i] = dot(first[i], second[i]); out must hold current_size values.
+	Returns 0 on success, else 1 (shape mismatch)
+*/
+static inline int dot_vector_soa(const vector_soa* const first, const vector_soa* const second, VECTOR_FLT* const out)
+{
+	if (first->components != second->components || first->current_size != second->current_size) return 1;
+
+	const size_t n = first->current_size;
+	const uint8_t components = first->components;
+	size_t i = 0;
+#if defined(VECTOR_SOA_AVX)
+	if (__has_avx_vector_soa__()) i = __dot_avx_vector_soa__(first, second, out);
+#endif
+	for (; i < n; i++)
+	{
+		VECTOR_FLT sum = 0;
+		for (uint8_t c = 0; c < components; c++) sum += vector_soa_stream(first, c)[i] * vector_soa_stream(second, c)[i];
+		out[i] = sum;
+	}
+	return 0;
+}
+
+/*
+	Scales every vector to unit length; zero vectors are left unchanged (as normalize_vec3)
+*/
+static inline void normalize_vector_soa(vector_soa* const soa)
+{
+	const size_t n = soa->current_size;
+	const uint8_t components = soa->components;
+	size_t i = 0;
+#if defined(VECTOR_SOA_AVX)
+	if (__has_avx_vector_soa__()) i = __normalize_avx_vector_soa__(soa);
+#endif
+	for (; i < n; i++)
+	{
+		VECTOR_FLT mag = 0;
+		for (uint8_t c = 0; c < components; c++) mag += vector_soa_stream(soa, c)[i] * vector_soa_stream(soa, c)[i];
+		mag = sqrt(mag);
+		if (mag != 0)
+		{
+			mag = 1 / mag;
+			for (uint8_t c = 0; c < components; c++) vector_soa_stream(soa, c)[i] *= mag;
+		}
+	}
+}
+
+static inline void clean_vector_soa(vector_soa* const soa)
+{
+	for (uint8_t c = 0; c < VECTOR_SOA_MAX_COMPONENTS; c++) clean_dyn_array(&soa->streams[c]);
+	soa->current_size = 0;
+}
+
+static inline void free_vector_soa(vector_soa* const soa)
+{
+	clean_vector_soa(soa);
+	free(soa);
+}
+
+/*
+	Builds a new vector_soa from a dyn_array of DYN_ARRAY_VECTOR_2_TYPE, DYN_ARRAY_VECTOR_3_TYPE or DYN_ARRAY_VECTOR_4_TYPE.
+	Returns NULL for other types or on allocation error
+*/
+static inline vector_soa* dyn_array_to_vector_soa(const dyn_array* const vectors)
+{
+	uint8_t components;
+	switch (vectors->type)
+	{
+		case DYN_ARRAY_VECTOR_2_TYPE:
+			components = 2;
+			break;
+		case DYN_ARRAY_VECTOR_3_TYPE:
+			components = 3;
+			break;
+		case DYN_ARRAY_VECTOR_4_TYPE:
+			components = 4;
+			break;
+		default:
+			return NULL;
+	}
+
+	vector_soa* const soa = new_vector_soa(components);
+	if (soa == NULL) return NULL;
+	if (append_range_vector_soa(soa, (const VECTOR_FLT*)vectors->data, vectors->current_size) != 0)
+	{
+		free_vector_soa(soa);
+		return NULL;
+	}
+	return soa;
+}
+
+/*
+	Returns a new dyn_array of vector2/vector3/vector4 (matching components) holding the interleaved vectors, or NULL on allocation error
+*/
+static inline dyn_array* vector_soa_to_dyn_array(const vector_soa* const soa)
+{
+	const enum dyn_array_type type = (soa->components == 2) ? DYN_ARRAY_VECTOR_2_TYPE : (soa->components == 3) ? DYN_ARRAY_VECTOR_3_TYPE : DYN_ARRAY_VECTOR_4_TYPE;
+	dyn_array* const vectors = new_dyn_array(type, DYN_ARRAY_EXPANSION_DOUBLE);
+	if (vectors == NULL) return NULL;
+	if (reserve_dyn_array(vectors, soa->current_size) != 0)
+	{
+		free_dyn_array(vectors);
+		return NULL;
+	}
+
+	const uint8_t components = soa->components;
+	VECTOR_FLT* const out = (VECTOR_FLT*)vectors->data;
+	for (uint8_t c = 0; c < components; c++)
+	{
+		const VECTOR_FLT* const stream = vector_soa_stream(soa, c);
+		for (size_t i = 0; i < soa->current_size; i++) out[i * components + c] = stream[i];
+	}
+	vectors->current_size = soa->current_size;
+	return vectors;
+}
+
+#endif